@@ -0,0 +1,156 @@
+# Gera a página embarcada a partir de public/index.html (executado com cmake -P):
+#
+#   cmake -DINPUT=public/index.html -DOUTPUT_DIR=<dir> [-DFSDATA=ON] -P cmake/embed_html.cmake
+#
+# Minifica o HTML (comentários, indentação e linhas vazias; o CSS perde também espaços e quebras de
+# linha) e grava <dir>/html_data.h com a página em um vetor const, que fica na flash. Com CMake 3.19
+# ou mais recente, acrescenta a versão comprimida com gzip (html_data_gz). Com FSDATA, grava também
+# <dir>/fsdata_custom.c no formato do fs.c do lwIP, com a página em /index.html.
+# Usa apenas o próprio CMake: nenhuma ferramenta extra no ambiente de build.
+
+if(NOT INPUT OR NOT OUTPUT_DIR)
+    message(FATAL_ERROR "embed_html.cmake: defina INPUT e OUTPUT_DIR")
+endif()
+
+file(READ "${INPUT}" html)
+
+# Remove o trecho entre open e close (inclusive), em todas as ocorrências. As expressões regulares
+# do CMake não têm quantificador não guloso, por isso a busca manual.
+function(strip_blocks var open close)
+    set(text "${${var}}")
+    string(LENGTH "${close}" close_len)
+    string(FIND "${text}" "${open}" start)
+    while(start GREATER -1)
+        string(SUBSTRING "${text}" ${start} -1 tail)
+        string(FIND "${tail}" "${close}" end)
+        if(end EQUAL -1)
+            message(FATAL_ERROR "embed_html.cmake: ${open} sem ${close} em ${INPUT}")
+        endif()
+        math(EXPR end "${start} + ${end} + ${close_len}")
+        string(SUBSTRING "${text}" 0 ${start} head)
+        string(SUBSTRING "${text}" ${end} -1 tail)
+        set(text "${head}${tail}")
+        string(FIND "${text}" "${open}" start)
+    endwhile()
+    set(${var} "${text}" PARENT_SCOPE)
+endfunction()
+
+strip_blocks(html "<!--" "-->")
+strip_blocks(html "/*" "*/")
+
+# Indentação, espaços no fim das linhas, linhas vazias e comentários de linha inteira do JavaScript.
+# As quebras de linha do HTML e do JavaScript ficam (inserção automática de ponto e vírgula).
+string(REGEX REPLACE "\n[ \t]+" "\n" html "${html}")
+string(REGEX REPLACE "[ \t]+\n" "\n" html "${html}")
+string(REGEX REPLACE "\n//[^\n]*" "" html "${html}")
+string(REGEX REPLACE "\n\n+" "\n" html "${html}")
+string(STRIP "${html}" html)
+
+# CSS: sem quebras de linha nem espaços em volta de { } : ; , e sem o último ;
+string(FIND "${html}" "<style>" style_start)
+string(FIND "${html}" "</style>" style_end)
+if(style_start GREATER -1 AND style_end GREATER style_start)
+    math(EXPR css_start "${style_start} + 7")
+    math(EXPR css_len "${style_end} - ${css_start}")
+    string(SUBSTRING "${html}" 0 ${css_start} head)
+    string(SUBSTRING "${html}" ${css_start} ${css_len} css)
+    string(SUBSTRING "${html}" ${style_end} -1 tail)
+    string(REPLACE "\n" " " css "${css}")
+    string(REGEX REPLACE " *([{}:;,]) *" "\\1" css "${css}")
+    string(REPLACE ";}" "}" css "${css}")
+    string(STRIP "${css}" css)
+    set(html "${head}${css}${tail}")
+endif()
+
+set(min_file "${OUTPUT_DIR}/index.min.html")
+file(MAKE_DIRECTORY "${OUTPUT_DIR}")
+file(WRITE "${min_file}" "${html}")
+
+# Conteúdo de um arquivo como lista de bytes em C, 16 por linha. O cabeçalho gzip tem a data do
+# arquivo nos bytes 4 a 7; zerá-la mantém a saída idêntica entre builds.
+function(c_bytes file out_var len_var)
+    file(READ "${file}" hex HEX)
+    string(LENGTH "${hex}" hex_len)
+    math(EXPR len "${hex_len} / 2")
+    if(ARGN STREQUAL "GZIP")
+        string(SUBSTRING "${hex}" 0 8 head)
+        string(SUBSTRING "${hex}" 16 -1 tail)
+        set(hex "${head}00000000${tail}")
+    endif()
+    set(line "")
+    foreach(i RANGE 1 32)
+        string(APPEND line ".")
+    endforeach()
+    string(REGEX REPLACE "(${line})" "\\1\n" hex "${hex}")
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," bytes "${hex}")
+    string(REGEX REPLACE "\n$" "" bytes "${bytes}")
+    string(REPLACE "\n" "\n    " bytes "${bytes}")
+    set(${out_var} "    ${bytes}" PARENT_SCOPE)
+    set(${len_var} ${len} PARENT_SCOPE)
+endfunction()
+
+c_bytes("${min_file}" html_bytes html_len)
+
+set(gzip OFF)
+if(CMAKE_VERSION VERSION_GREATER_EQUAL 3.19)
+    set(gz_file "${min_file}.gz")
+    file(ARCHIVE_CREATE OUTPUT "${gz_file}" PATHS "${min_file}" FORMAT raw COMPRESSION GZip COMPRESSION_LEVEL 9)
+    c_bytes("${gz_file}" gz_bytes gz_len GZIP)
+    set(gzip ON)
+endif()
+
+set(out "// Gerado por cmake/embed_html.cmake a partir de public/index.html. Não edite.\n")
+string(APPEND out "#ifndef HTML_DATA_H\n#define HTML_DATA_H\n\n")
+string(APPEND out "// Página minificada, terminada em '\\0' (HTML_DATA_LEN não conta o terminador)\n")
+string(APPEND out "#define HTML_DATA_LEN ${html_len}\n")
+string(APPEND out "static const char html_data[HTML_DATA_LEN + 1] = {\n${html_bytes}\n    0x00};\n")
+if(gzip)
+    string(APPEND out "\n// A mesma página comprimida com gzip, para clientes com Accept-Encoding: gzip\n")
+    string(APPEND out "#define HTML_DATA_GZ_LEN ${gz_len}\n")
+    string(APPEND out "static const unsigned char html_data_gz[HTML_DATA_GZ_LEN] = {\n${gz_bytes}\n};\n")
+endif()
+string(APPEND out "\n#endif // HTML_DATA_H\n")
+file(WRITE "${OUTPUT_DIR}/html_data.h" "${out}")
+
+if(NOT FSDATA)
+    return()
+endif()
+
+# fsdata do lwIP: nome do arquivo com '\0', cabeçalho HTTP e conteúdo em um único vetor (formato do
+# makefsdata, com FS_FILE_FLAGS_HEADER_INCLUDED). Usa a versão gzip quando disponível.
+if(gzip)
+    set(body_file "${gz_file}")
+    set(body_len ${gz_len})
+    set(encoding "Content-Encoding: gzip\r\n")
+else()
+    set(body_file "${min_file}")
+    set(body_len ${html_len})
+    set(encoding "")
+endif()
+file(WRITE "${OUTPUT_DIR}/index.name" "/index.html")
+file(WRITE "${OUTPUT_DIR}/index.header"
+     "HTTP/1.0 200 OK\r\nServer: lwIP\r\nContent-Type: text/html\r\n${encoding}Content-Length: ${body_len}\r\n\r\n")
+c_bytes("${OUTPUT_DIR}/index.name" name_bytes name_len)
+c_bytes("${OUTPUT_DIR}/index.header" header_bytes header_len)
+if(gzip)
+    c_bytes("${body_file}" body_bytes body_len GZIP)
+else()
+    c_bytes("${body_file}" body_bytes body_len)
+endif()
+math(EXPR name_size "${name_len} + 1")
+
+set(out "// Gerado por cmake/embed_html.cmake a partir de public/index.html. Não edite.\n")
+string(APPEND out "#include \"lwip/apps/fs.h\"\n#include \"lwip/def.h\"\n\n")
+string(APPEND out "#define file_NULL (struct fsdata_file *) NULL\n\n")
+string(APPEND out "#ifndef FSDATA_ALIGN_PRE\n#define FSDATA_ALIGN_PRE\n#endif\n")
+string(APPEND out "#ifndef FSDATA_ALIGN_POST\n#define FSDATA_ALIGN_POST\n#endif\n\n")
+string(APPEND out "static const unsigned char FSDATA_ALIGN_PRE data__index_html[] FSDATA_ALIGN_POST = {\n")
+string(APPEND out "    /* /index.html (${name_size} chars) */\n${name_bytes}\n    0x00,\n")
+string(APPEND out "    /* HTTP header */\n${header_bytes}\n")
+string(APPEND out "    /* raw file data (${body_len} bytes) */\n${body_bytes}\n};\n\n")
+string(APPEND out "const struct fsdata_file file__index_html[] = {{\n")
+string(APPEND out "    file_NULL,\n    data__index_html,\n    data__index_html + ${name_size},\n")
+string(APPEND out "    sizeof(data__index_html) - ${name_size},\n")
+string(APPEND out "    FS_FILE_FLAGS_HEADER_INCLUDED | FS_FILE_FLAGS_HEADER_PERSISTENT,\n}};\n\n")
+string(APPEND out "#define FS_ROOT file__index_html\n#define FS_NUMFILES 1\n")
+file(WRITE "${OUTPUT_DIR}/fsdata_custom.c" "${out}")
@@ -7,4 +7,25 @@
 // This example uses a common include to avoid repetition
 #include "lwipopts_examples_common.h"
 
+// PCBs TCP: as conexões aceitas pelo servidor HTTP (ADMISSION_MAX_CONNECTIONS), o PCB de escuta e
+// folga para as conexões recusadas com 503 enquanto terminam o fechamento
+#define MEMP_NUM_TCP_PCB            12
+
+// SNTP: a hora recebida disciplina o relógio de parede do firmware (station_sntp_* em main.c).
+// SNTP_COMP_ROUNDTRIP desconta o atraso de ida e volta; SNTP_CHECK_RESPONSE 2 confere se a resposta
+// corresponde à última consulta. O intervalo entre consultas não pode ser menor que 15 s (RFC 4330).
+#include <stdint.h>
+void station_sntp_set_time(uint32_t sec, uint32_t us);
+void station_sntp_get_time(uint32_t *sec, uint32_t *us);
+
+#define SNTP_SERVER_DNS             1
+#define SNTP_COMP_ROUNDTRIP         1
+#define SNTP_CHECK_RESPONSE         2
+#ifndef SNTP_UPDATE_DELAY
+#define SNTP_UPDATE_DELAY           300000 // 5 min
+#endif
+#define SNTP_SET_SYSTEM_TIME_US(sec, us) station_sntp_set_time((sec), (us))
+#define SNTP_GET_SYSTEM_TIME(sec, us)    station_sntp_get_time(&(sec), &(us))
+#define MEMP_NUM_SYS_TIMEOUT        (LWIP_NUM_SYS_TIMEOUT_INTERNAL + 1) // Temporizador do SNTP
+
 #endif
@@ -5,4 +5,7 @@
 #define WIFI_SSID "Your SSID Here"
 #define WIFI_PASSWORD "Your Password Here"
 
+// Servidor SNTP (nome ou IP). Para testes, aponte para um servidor local (ex.: tools/ntpsim)
+#define NTP_SERVER "pool.ntp.org"
+
 #endif // WIFI_CONFIG_H
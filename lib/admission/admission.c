@@ -0,0 +1,91 @@
+#include <string.h>
+#include "admission.h"
+
+#define BURST_MILLI (ADMISSION_BURST * 1000u)
+
+void admission_init(admission_t *adm)
+{
+    memset(adm, 0, sizeof(*adm));
+}
+
+bool admission_connect(admission_t *adm)
+{
+    if (adm->connections >= ADMISSION_MAX_CONNECTIONS)
+    {
+        adm->refused++;
+        return false;
+    }
+    adm->connections++;
+    return true;
+}
+
+void admission_disconnect(admission_t *adm)
+{
+    if (adm->connections)
+        adm->connections--;
+}
+
+// Fichas do cliente ip, recarregadas até now_ms. Um IP novo ocupa uma posição livre ou a do
+// cliente visto há mais tempo, e começa com o balde cheio.
+static admission_client_t *client_for(admission_t *adm, uint32_t ip, uint32_t now_ms)
+{
+    admission_client_t *oldest = &adm->clients[0];
+    for (uint16_t i = 0; i < adm->clients_used; i++)
+    {
+        admission_client_t *client = &adm->clients[i];
+        if (client->ip == ip)
+        {
+            uint32_t elapsed = now_ms - client->last_ms;
+            uint32_t refill = elapsed >= BURST_MILLI / ADMISSION_REFILL_PER_S ? BURST_MILLI
+                                                                              : elapsed * ADMISSION_REFILL_PER_S;
+            client->tokens_milli = client->tokens_milli + refill > BURST_MILLI ? BURST_MILLI
+                                                                               : client->tokens_milli + refill;
+            client->last_ms = now_ms;
+            return client;
+        }
+        if ((int32_t)(client->last_ms - oldest->last_ms) < 0)
+            oldest = client;
+    }
+
+    admission_client_t *client = adm->clients_used < ADMISSION_CLIENTS ? &adm->clients[adm->clients_used++] : oldest;
+    client->ip = ip;
+    client->tokens_milli = BURST_MILLI;
+    client->last_ms = now_ms;
+    return client;
+}
+
+admission_result_t admission_request(admission_t *adm, uint32_t ip, admission_class_t cls, uint32_t now_ms,
+                                     uint32_t *retry_after_s)
+{
+    uint32_t cost = (cls == ADMISSION_CLASS_PAGE ? ADMISSION_PAGE_COST : ADMISSION_API_COST) * 1000u;
+    admission_client_t *client = client_for(adm, ip, now_ms);
+
+    if (client->tokens_milli < cost)
+    {
+        // Tempo até recuperar as fichas que faltam, arredondado para cima
+        uint32_t missing = cost - client->tokens_milli;
+        uint32_t per_s = ADMISSION_REFILL_PER_S * 1000u;
+        *retry_after_s = (missing + per_s - 1) / per_s;
+        adm->rejected_rate++;
+        return ADMISSION_REJECT_RATE;
+    }
+
+    uint16_t limit = cls == ADMISSION_CLASS_PAGE ? ADMISSION_MAX_ACTIVE - ADMISSION_API_RESERVED : ADMISSION_MAX_ACTIVE;
+    if (adm->active >= limit)
+    {
+        *retry_after_s = 1;
+        adm->rejected_busy++;
+        return ADMISSION_REJECT_BUSY;
+    }
+
+    client->tokens_milli -= cost;
+    adm->active++;
+    adm->accepted++;
+    return ADMISSION_ACCEPT;
+}
+
+void admission_release(admission_t *adm)
+{
+    if (adm->active)
+        adm->active--;
+}
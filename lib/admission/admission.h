@@ -0,0 +1,70 @@
+#ifndef ADMISSION_H
+#define ADMISSION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Controle de admissão do servidor HTTP. Três limites, verificados sem alocar memória:
+// - conexões abertas (cada uma ocupa um PCB do lwIP, mesmo antes de enviar a requisição);
+// - respostas simultâneas (cada uma aloca um http_state de ~20 KB); ADMISSION_API_RESERVED vagas
+//   ficam para as rotas /api/, que são leves, de modo que recarregar a página não bloqueia a API;
+// - fichas por IP (token bucket): um cliente gasta ADMISSION_API_COST ou ADMISSION_PAGE_COST por
+//   requisição e recupera ADMISSION_REFILL_PER_S fichas por segundo, até ADMISSION_BURST.
+// Uma requisição recusada não gasta fichas e recebe 503 com Retry-After.
+
+#define ADMISSION_MAX_CONNECTIONS 8  // Conexões abertas (abaixo de MEMP_NUM_TCP_PCB)
+#define ADMISSION_MAX_ACTIVE 4       // Respostas simultâneas
+#define ADMISSION_API_RESERVED 1     // Vagas de resposta que a página não pode ocupar
+#define ADMISSION_CLIENTS 16         // IPs acompanhados (o menos recente é substituído)
+#define ADMISSION_BURST 12           // Fichas máximas por cliente
+#define ADMISSION_REFILL_PER_S 3     // Fichas recuperadas por segundo
+#define ADMISSION_API_COST 1
+#define ADMISSION_PAGE_COST 4
+
+typedef enum {
+    ADMISSION_CLASS_API,  // Rotas /api/ (respostas pequenas)
+    ADMISSION_CLASS_PAGE, // Página principal
+} admission_class_t;
+
+typedef enum {
+    ADMISSION_ACCEPT,
+    ADMISSION_REJECT_BUSY,  // Sem vaga de resposta para a classe
+    ADMISSION_REJECT_RATE,  // Cliente sem fichas
+} admission_result_t;
+
+typedef struct {
+    uint32_t ip;
+    uint32_t tokens_milli;  // Fichas em milésimos
+    uint32_t last_ms;       // Última recarga
+} admission_client_t;
+
+typedef struct {
+    uint16_t connections;   // Conexões abertas
+    uint16_t active;        // Respostas em andamento
+    uint16_t clients_used;
+    admission_client_t clients[ADMISSION_CLIENTS];
+
+    // Contadores
+    uint32_t accepted;
+    uint32_t rejected_busy;
+    uint32_t rejected_rate;
+    uint32_t refused;       // Conexões recusadas no limite de conexões
+} admission_t;
+
+void admission_init(admission_t *adm);
+
+// Nova conexão. Retorna false se o limite de conexões foi atingido (a conexão deve ser recusada).
+bool admission_connect(admission_t *adm);
+
+// Fim de uma conexão aceita por admission_connect
+void admission_disconnect(admission_t *adm);
+
+// Decide uma requisição de ip. Se aceita, ocupa uma vaga de resposta (liberada por
+// admission_release); se recusada, retry_after_s recebe a espera sugerida em segundos.
+admission_result_t admission_request(admission_t *adm, uint32_t ip, admission_class_t cls, uint32_t now_ms,
+                                     uint32_t *retry_after_s);
+
+// Fim de uma resposta aceita por admission_request
+void admission_release(admission_t *adm);
+
+#endif // ADMISSION_H
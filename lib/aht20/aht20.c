@@ -1,25 +1,65 @@
 #include <stdio.h>
 #include "pico/stdlib.h"
-#include "hardware/i2c.h"
 #include "aht20.h"
 
-#define AHT20_I2C_ADDR      0x38
-#define AHT20_CMD_INIT      0xBE
-#define AHT20_CMD_TRIGGER   0xAC
-#define AHT20_CMD_RESET     0xBA
 #define AHT20_STATUS_BUSY   0x80  // Bit de status ocupado
 #define AHT20_STATUS_CALIBRATED 0x08  // Bit de calibração
 
-bool aht20_init(i2c_inst_t *i2c) {
-    uint8_t init_cmd[3] = {AHT20_CMD_INIT, 0x08, 0x00};
-    i2c_write_blocking(i2c, AHT20_I2C_ADDR, init_cmd, 3, false);
-    sleep_ms(50);  // Aguarda o sensor inicializar
+static const uint8_t trigger_cmd[3] = {AHT20_CMD_TRIGGER, 0x33, 0x00};
 
-    // Verifica status até que o sensor esteja pronto
+// CRC-8 com polinômio x^8 + x^5 + x^4 + 1 (0x31), um byte por consulta
+static const uint8_t crc8_table[256] = {
+    0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97, 0xB9, 0x88, 0xDB, 0xEA, 0x7D, 0x4C, 0x1F, 0x2E,
+    0x43, 0x72, 0x21, 0x10, 0x87, 0xB6, 0xE5, 0xD4, 0xFA, 0xCB, 0x98, 0xA9, 0x3E, 0x0F, 0x5C, 0x6D,
+    0x86, 0xB7, 0xE4, 0xD5, 0x42, 0x73, 0x20, 0x11, 0x3F, 0x0E, 0x5D, 0x6C, 0xFB, 0xCA, 0x99, 0xA8,
+    0xC5, 0xF4, 0xA7, 0x96, 0x01, 0x30, 0x63, 0x52, 0x7C, 0x4D, 0x1E, 0x2F, 0xB8, 0x89, 0xDA, 0xEB,
+    0x3D, 0x0C, 0x5F, 0x6E, 0xF9, 0xC8, 0x9B, 0xAA, 0x84, 0xB5, 0xE6, 0xD7, 0x40, 0x71, 0x22, 0x13,
+    0x7E, 0x4F, 0x1C, 0x2D, 0xBA, 0x8B, 0xD8, 0xE9, 0xC7, 0xF6, 0xA5, 0x94, 0x03, 0x32, 0x61, 0x50,
+    0xBB, 0x8A, 0xD9, 0xE8, 0x7F, 0x4E, 0x1D, 0x2C, 0x02, 0x33, 0x60, 0x51, 0xC6, 0xF7, 0xA4, 0x95,
+    0xF8, 0xC9, 0x9A, 0xAB, 0x3C, 0x0D, 0x5E, 0x6F, 0x41, 0x70, 0x23, 0x12, 0x85, 0xB4, 0xE7, 0xD6,
+    0x7A, 0x4B, 0x18, 0x29, 0xBE, 0x8F, 0xDC, 0xED, 0xC3, 0xF2, 0xA1, 0x90, 0x07, 0x36, 0x65, 0x54,
+    0x39, 0x08, 0x5B, 0x6A, 0xFD, 0xCC, 0x9F, 0xAE, 0x80, 0xB1, 0xE2, 0xD3, 0x44, 0x75, 0x26, 0x17,
+    0xFC, 0xCD, 0x9E, 0xAF, 0x38, 0x09, 0x5A, 0x6B, 0x45, 0x74, 0x27, 0x16, 0x81, 0xB0, 0xE3, 0xD2,
+    0xBF, 0x8E, 0xDD, 0xEC, 0x7B, 0x4A, 0x19, 0x28, 0x06, 0x37, 0x64, 0x55, 0xC2, 0xF3, 0xA0, 0x91,
+    0x47, 0x76, 0x25, 0x14, 0x83, 0xB2, 0xE1, 0xD0, 0xFE, 0xCF, 0x9C, 0xAD, 0x3A, 0x0B, 0x58, 0x69,
+    0x04, 0x35, 0x66, 0x57, 0xC0, 0xF1, 0xA2, 0x93, 0xBD, 0x8C, 0xDF, 0xEE, 0x79, 0x48, 0x1B, 0x2A,
+    0xC1, 0xF0, 0xA3, 0x92, 0x05, 0x34, 0x67, 0x56, 0x78, 0x49, 0x1A, 0x2B, 0xBC, 0x8D, 0xDE, 0xEF,
+    0x82, 0xB3, 0xE0, 0xD1, 0x46, 0x77, 0x24, 0x15, 0x3B, 0x0A, 0x59, 0x68, 0xFF, 0xCE, 0x9D, 0xAC,
+};
+
+// Reinicialização após recuperação do barramento (contexto do laço principal)
+static void on_bus_reprobe(void *context) {
+    aht20_calibrate((aht20_t *)context);
+}
+
+bool aht20_init(aht20_t *aht, i2c_bus_t *bus, uint8_t addr) {
+    i2c_device_init(&aht->device, bus, addr);
+    i2c_bus_add_reprobe_hook(bus, on_bus_reprobe, aht);
+    return aht20_calibrate(aht);
+}
+
+bool aht20_calibrate(aht20_t *aht) {
+    static const uint8_t init_cmd[3] = {AHT20_CMD_INIT, 0x08, 0x00};
     uint8_t status;
+
+    // O sensor só responde AHT20_POWER_ON_MS após ser alimentado (sem espera se o boot já passou disso)
+    sleep_until(from_us_since_boot(AHT20_POWER_ON_MS * 1000));
+
+    // Já calibrado (o normal após ligar): dispensa o comando de inicialização e sua espera
+    if (i2c_bus_read(&aht->device, &status, 1) == I2C_BUS_OK &&
+        (status & AHT20_STATUS_CALIBRATED) == AHT20_STATUS_CALIBRATED) {
+        return true;
+    }
+
+    if (i2c_bus_write(&aht->device, init_cmd, 3) != I2C_BUS_OK) {
+        return false;
+    }
+    sleep_ms(10);  // Aguarda o sensor inicializar
+
+    // Verifica status até que o sensor esteja pronto
     for (int i = 0; i < 10; i++) {
-        i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false);
-        if ((status & AHT20_STATUS_CALIBRATED) == AHT20_STATUS_CALIBRATED) {
+        if (i2c_bus_read(&aht->device, &status, 1) == I2C_BUS_OK &&
+            (status & AHT20_STATUS_CALIBRATED) == AHT20_STATUS_CALIBRATED) {
             return true;  // Sensor calibrado e pronto
         }
         sleep_ms(10);
@@ -28,18 +68,16 @@ bool aht20_init(i2c_inst_t *i2c) {
     return false;  // Falhou na calibração
 }
 
-bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data) {
-    uint8_t trigger_cmd[3] = {AHT20_CMD_TRIGGER, 0x33, 0x00};
-    uint8_t buffer[6];
-
+aht20_result_t aht20_read(aht20_t *aht, AHT20_Data *data) {
     // Envia comando de medição
-    i2c_write_blocking(i2c, AHT20_I2C_ADDR, trigger_cmd, 3, false);
-    
+    if (i2c_bus_write(&aht->device, trigger_cmd, 3) != I2C_BUS_OK) {
+        return AHT20_BUS_ERROR;
+    }
+
     // Aguarda até o sensor estar pronto
-    uint8_t status;
+    uint8_t status = AHT20_STATUS_BUSY;
     for (int i = 0; i < 10; i++) {
-        i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false);
-        if (!(status & AHT20_STATUS_BUSY)) {
+        if (i2c_bus_read(&aht->device, &status, 1) == I2C_BUS_OK && !(status & AHT20_STATUS_BUSY)) {
             break;
         }
         sleep_ms(10);
@@ -47,33 +85,80 @@ bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data) {
     
     // Se ainda estiver ocupado, falha na leitura
     if (status & AHT20_STATUS_BUSY) {
-        return false;
+        return AHT20_BUSY;
     }
 
-    // Lê os 6 bytes de dados
-    if (i2c_read_blocking(i2c, AHT20_I2C_ADDR, buffer, 6, false) != 6) {
-        return false;
+    // Lê o status, os 5 bytes de dados e o CRC
+    if (!aht20_fetch(aht)) {
+        return AHT20_BUS_ERROR;
     }
 
-    // Processa os dados de umidade (20 bits)
+    return aht20_parse(aht, data);
+}
+
+bool aht20_trigger_async(aht20_t *aht, i2c_bus_callback_t callback, void *user_data) {
+    return i2c_bus_submit(&aht->device, trigger_cmd, 3, NULL, 0, callback, user_data) == I2C_BUS_OK;
+}
+
+bool aht20_fetch_async(aht20_t *aht, i2c_bus_callback_t callback, void *user_data) {
+    return i2c_bus_submit(&aht->device, NULL, 0, aht->buffer, AHT20_RESULT_SIZE, callback, user_data) == I2C_BUS_OK;
+}
+
+bool aht20_fetch(aht20_t *aht) {
+    return i2c_bus_read(&aht->device, aht->buffer, AHT20_RESULT_SIZE) == I2C_BUS_OK;
+}
+
+aht20_result_t aht20_parse(const aht20_t *aht, AHT20_Data *data) {
+    return aht20_decode(aht->buffer, data);
+}
+
+uint8_t aht20_crc8(const uint8_t *data, size_t len) {
+    uint8_t crc = 0xFF;
+    while (len--) {
+        crc = crc8_table[crc ^ *data++];
+    }
+    return crc;
+}
+
+aht20_result_t aht20_decode(const uint8_t buffer[AHT20_RESULT_SIZE], AHT20_Data *data) {
+    if (aht20_crc8(buffer, AHT20_RESULT_SIZE - 1) != buffer[AHT20_RESULT_SIZE - 1]) {
+        return AHT20_CRC_ERROR;
+    }
+    if (buffer[0] & AHT20_STATUS_BUSY) {
+        return AHT20_BUSY;
+    }
+
+    // Valores de 20 bits: umidade = raw * 100 / 2^20 % e temperatura = raw * 200 / 2^20 - 50 °C.
+    // Em centésimos, 10000 / 2^20 = 625 / 2^16 e 20000 / 2^20 = 1250 / 2^16: os produtos cabem em 32 bits.
     uint32_t raw_humidity = ((uint32_t)buffer[1] << 12) | ((uint32_t)buffer[2] << 4) | (buffer[3] >> 4);
-    data->humidity = (float)raw_humidity * 100.0 / 1048576.0;
+    data->humidity = (int32_t)((raw_humidity * 625u + 0x8000u) >> 16);
 
-    // Processa os dados de temperatura (20 bits)
     uint32_t raw_temp = ((uint32_t)(buffer[3] & 0x0F) << 16) | ((uint32_t)buffer[4] << 8) | buffer[5];
-    data->temperature = ((float)raw_temp * 200.0 / 1048576.0) - 50.0;
+    data->temperature = (int32_t)((raw_temp * 1250u + 0x8000u) >> 16) - 5000;
 
-    return true;
+    return AHT20_OK;
 }
 
-void aht20_reset(i2c_inst_t *i2c) {
+const char *aht20_result_str(aht20_result_t result) {
+    switch (result) {
+    case AHT20_OK:
+        return "ok";
+    case AHT20_BUSY:
+        return "busy";
+    case AHT20_CRC_ERROR:
+        return "crc-error";
+    default:
+        return "bus-error";
+    }
+}
+
+void aht20_reset(aht20_t *aht) {
     uint8_t reset_cmd = AHT20_CMD_RESET;
-    i2c_write_blocking(i2c, AHT20_I2C_ADDR, &reset_cmd, 1, false);
+    i2c_bus_write(&aht->device, &reset_cmd, 1);
     sleep_ms(20);
-    aht20_init(i2c);
+    aht20_calibrate(aht);
 }
 
-bool aht20_check(i2c_inst_t *i2c) {
-    uint8_t status;
-    return i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false) == 1;
+bool aht20_check(aht20_t *aht) {
+    return i2c_bus_probe(&aht->device);
 }
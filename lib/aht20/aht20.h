@@ -1,6 +1,7 @@
 #ifndef AHT20_H
 #define AHT20_H
 
+#include "i2c_bus/i2c_bus.h"
 
 // Endereço I2C do AHT20
 #define AHT20_I2C_ADDR  0x38
@@ -10,21 +11,66 @@
 #define AHT20_CMD_TRIGGER   0xAC
 #define AHT20_CMD_RESET     0xBA
 
+// Tempo de uma medição segundo o datasheet
+#define AHT20_MEASUREMENT_MS 80
+#define AHT20_POWER_ON_MS    40 // Tempo mínimo após a alimentação antes do primeiro comando
+#define AHT20_BUSY_RETRY_MS  10 // Espera antes de ler de novo um resultado ainda ocupado
+
+#define AHT20_RESULT_SIZE 7 // Status, 5 bytes de medição e CRC-8
+
 // Estrutura para armazenar os valores de temperatura e umidade
 typedef struct {
-    float temperature;
-    float humidity;
+    int32_t temperature; // Centésimos de °C
+    int32_t humidity;    // Centésimos de %
 } AHT20_Data;
 
-// Inicializa o sensor AHT20
-bool aht20_init(i2c_inst_t *i2c);
+// Resultado de uma leitura. Ocupado e CRC inválido não alteram os dados: o chamador pode ler de
+// novo (o sensor mantém a medição até o próximo disparo) ou manter o último valor bom.
+typedef enum {
+    AHT20_OK,
+    AHT20_BUSY,      // Medição ainda em andamento
+    AHT20_CRC_ERROR, // Bytes corrompidos na transferência
+    AHT20_BUS_ERROR, // Falha no barramento (só aht20_read)
+} aht20_result_t;
+
+// Estado de um AHT20 no barramento
+typedef struct {
+    i2c_device_t device;
+    uint8_t buffer[AHT20_RESULT_SIZE];
+} aht20_t;
+
+// Associa o sensor ao barramento e o inicializa. Registra a reinicialização
+// automática após recuperações do barramento.
+bool aht20_init(aht20_t *aht, i2c_bus_t *bus, uint8_t addr);
+
+// Verifica o bit de calibração e, se necessário, envia o comando de inicialização
+bool aht20_calibrate(aht20_t *aht);
 
-// Faz a leitura de temperatura e umidade do AHT20
-bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data);
+// Faz a leitura de temperatura e umidade do AHT20 (bloqueante: dispara e espera a medição)
+aht20_result_t aht20_read(aht20_t *aht, AHT20_Data *data);
 
 // Reseta o sensor AHT20
-void aht20_reset(i2c_inst_t *i2c);
+void aht20_reset(aht20_t *aht);
+
+bool aht20_check(aht20_t *aht);
+
+// Leitura assíncrona em duas etapas: aht20_trigger_async dispara a medição e, após
+// AHT20_MEASUREMENT_MS, aht20_fetch_async lê o resultado, convertido com aht20_parse.
+bool aht20_trigger_async(aht20_t *aht, i2c_bus_callback_t callback, void *user_data);
+bool aht20_fetch_async(aht20_t *aht, i2c_bus_callback_t callback, void *user_data);
+
+// Lê de novo o resultado da última medição (bloqueante), para repetir um resultado ocupado ou com CRC inválido
+bool aht20_fetch(aht20_t *aht);
+
+// Converte o último resultado lido
+aht20_result_t aht20_parse(const aht20_t *aht, AHT20_Data *data);
+
+// Converte um resultado (status, medição e CRC), lido agora ou gravado em um trace. Só inteiros.
+aht20_result_t aht20_decode(const uint8_t buffer[AHT20_RESULT_SIZE], AHT20_Data *data);
+
+// CRC-8 do AHT20 (polinômio 0x31, valor inicial 0xFF), por tabela
+uint8_t aht20_crc8(const uint8_t *data, size_t len);
 
-bool aht20_check(i2c_inst_t *i2c);
+const char *aht20_result_str(aht20_result_t result);
 
 #endif // AHT20_H
@@ -0,0 +1,254 @@
+#include <string.h>
+#include "alerts.h"
+
+static const char *const metric_names[ALERT_METRIC_COUNT] = {
+    [ALERT_METRIC_TEMPERATURE] = "temperature",
+    [ALERT_METRIC_HUMIDITY] = "humidity",
+    [ALERT_METRIC_PRESSURE] = "pressure",
+    [ALERT_METRIC_DEW_POINT] = "dewPoint",
+    [ALERT_METRIC_HEAT_INDEX] = "heatIndex",
+};
+
+static const char *const condition_names[ALERT_CONDITION_COUNT] = {
+    [ALERT_CONDITION_ABOVE] = "above",
+    [ALERT_CONDITION_BELOW] = "below",
+    [ALERT_CONDITION_RISE] = "rise",
+    [ALERT_CONDITION_DROP] = "drop",
+};
+
+static const char *const action_names[ALERT_ACTION_COUNT] = {
+    [ALERT_ACTION_NONE] = "none",
+    [ALERT_ACTION_BUZZER_A] = "buzzer-a",
+    [ALERT_ACTION_BUZZER_B] = "buzzer-b",
+};
+
+static bool is_rate(uint8_t condition)
+{
+    return condition == ALERT_CONDITION_RISE || condition == ALERT_CONDITION_DROP;
+}
+
+// Registra o valor no anel de taxa e calcula a variação em relação ao balde de ~uma janela atrás.
+// Cada balde cobre window_s / (ALERT_RATE_SLOTS - 1) e guarda o primeiro valor visto nele; baldes
+// sem amostra (ex.: intervalo de amostragem maior que o balde) ficam inválidos.
+static bool rate_delta(const alert_rule_t *rule, alert_state_t *state, int32_t value, uint32_t now_ms,
+                       int32_t *delta)
+{
+    uint32_t bucket_ms = rule->window_s * 1000u / (ALERT_RATE_SLOTS - 1);
+    uint32_t bucket = now_ms / bucket_ms;
+
+    if (state->valid == 0 || bucket - state->bucket >= ALERT_RATE_SLOTS)
+    {
+        state->valid = 0;
+    }
+    else
+    {
+        for (uint32_t b = state->bucket + 1; b != bucket + 1; b++)
+            state->valid &= (uint16_t)~(1u << (b % ALERT_RATE_SLOTS));
+    }
+
+    uint32_t slot = bucket % ALERT_RATE_SLOTS;
+    if (!(state->valid & (1u << slot)))
+    {
+        state->ring[slot] = value;
+        state->valid |= (uint16_t)(1u << slot);
+    }
+    state->bucket = bucket;
+
+    // O balde seguinte no anel é o mais antigo: começou entre uma janela e uma janela + um balde atrás
+    uint32_t oldest = (bucket + 1) % ALERT_RATE_SLOTS;
+    if (!(state->valid & (1u << oldest)))
+        return false;
+    *delta = value - state->ring[oldest];
+    return true;
+}
+
+void alert_engine_init(alert_engine_t *engine)
+{
+    memset(engine, 0, sizeof(*engine));
+}
+
+bool alert_rule_valid(const alert_rule_t *rule)
+{
+    if (rule->metric >= ALERT_METRIC_COUNT ||
+        rule->condition >= ALERT_CONDITION_COUNT ||
+        rule->action >= ALERT_ACTION_COUNT ||
+        rule->hysteresis < 0 ||
+        rule->duration_s > ALERT_MAX_WINDOW_S ||
+        rule->cooldown_s > ALERT_MAX_WINDOW_S)
+        return false;
+
+    return !is_rate(rule->condition) ||
+           (rule->threshold > 0 && rule->window_s >= ALERT_RATE_SLOTS - 1 && rule->window_s <= ALERT_MAX_WINDOW_S);
+}
+
+bool alert_engine_set_rule(alert_engine_t *engine, int index, const alert_rule_t *rule)
+{
+    if (index < 0 || index >= ALERT_MAX_RULES || !alert_rule_valid(rule))
+        return false;
+
+    engine->rules[index] = *rule;
+    engine->rules[index].enabled = rule->enabled ? 1 : 0;
+    memset(&engine->state[index], 0, sizeof(engine->state[index]));
+    return true;
+}
+
+void alert_engine_set_threshold(alert_engine_t *engine, int index, int32_t threshold)
+{
+    if (index >= 0 && index < ALERT_MAX_RULES)
+        engine->rules[index].threshold = threshold;
+}
+
+uint32_t alert_engine_update(alert_engine_t *engine, const int32_t values[ALERT_METRIC_COUNT], uint32_t now_ms)
+{
+    uint32_t notified = 0;
+
+    for (int i = 0; i < ALERT_MAX_RULES; i++)
+    {
+        const alert_rule_t *rule = &engine->rules[i];
+        alert_state_t *state = &engine->state[i];
+        if (!rule->enabled)
+            continue;
+
+        // Nível comparado com o limiar: o próprio valor, ou a variação na janela
+        int32_t value = values[rule->metric];
+        int32_t level = value;
+        if (is_rate(rule->condition))
+        {
+            int32_t delta;
+            state->has_value = rate_delta(rule, state, value, now_ms, &delta);
+            level = rule->condition == ALERT_CONDITION_DROP ? -delta : delta;
+        }
+        else
+        {
+            state->has_value = true;
+        }
+        state->value = rule->condition == ALERT_CONDITION_DROP ? -level : level;
+
+        // Com a regra ativa, o limiar recua pela histerese para evitar disparos repetidos na borda
+        bool condition = false;
+        if (state->has_value)
+        {
+            int32_t margin = state->status == ALERT_STATUS_ACTIVE ? rule->hysteresis : 0;
+            if (rule->condition == ALERT_CONDITION_BELOW)
+                condition = level < rule->threshold + margin;
+            else
+                condition = level > rule->threshold - margin;
+        }
+
+        if (!condition)
+        {
+            state->status = ALERT_STATUS_IDLE;
+            continue;
+        }
+
+        if (state->status == ALERT_STATUS_IDLE)
+        {
+            state->status = ALERT_STATUS_PENDING;
+            state->since_ms = now_ms;
+        }
+
+        if (state->status == ALERT_STATUS_PENDING && now_ms - state->since_ms >= rule->duration_s * 1000u)
+        {
+            state->status = ALERT_STATUS_ACTIVE;
+            if (state->has_fired && now_ms - state->fired_ms < rule->cooldown_s * 1000u)
+            {
+                state->suppressed++;
+            }
+            else
+            {
+                state->has_fired = true;
+                state->fired_ms = now_ms;
+                state->fired++;
+                notified |= 1u << i;
+            }
+        }
+    }
+
+    return notified;
+}
+
+void alert_default_user_rules(alert_rule_t rules[ALERT_USER_RULES])
+{
+    memset(rules, 0, sizeof(alert_rule_t) * ALERT_USER_RULES);
+
+    // Tendência de tempestade: queda de mais de 3 hPa em 3 horas
+    rules[0] = (alert_rule_t){
+        .metric = ALERT_METRIC_PRESSURE,
+        .condition = ALERT_CONDITION_DROP,
+        .action = ALERT_ACTION_NONE,
+        .enabled = 1,
+        .threshold = 300,
+        .hysteresis = 50,
+        .window_s = 3 * 3600,
+        .cooldown_s = 3 * 3600,
+    };
+}
+
+const char *alert_metric_name(alert_metric_t metric)
+{
+    return metric < ALERT_METRIC_COUNT ? metric_names[metric] : "unknown";
+}
+
+const char *alert_condition_name(alert_condition_t condition)
+{
+    return condition < ALERT_CONDITION_COUNT ? condition_names[condition] : "unknown";
+}
+
+const char *alert_action_name(alert_action_t action)
+{
+    return action < ALERT_ACTION_COUNT ? action_names[action] : "unknown";
+}
+
+const char *alert_status_str(alert_status_t status)
+{
+    switch (status)
+    {
+    case ALERT_STATUS_IDLE:
+        return "idle";
+    case ALERT_STATUS_PENDING:
+        return "pending";
+    case ALERT_STATUS_ACTIVE:
+        return "active";
+    }
+    return "unknown";
+}
+
+static bool lookup(const char *const names[], int count, const char *name, int *index)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (strcmp(name, names[i]) == 0)
+        {
+            *index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool alert_metric_from_name(const char *name, alert_metric_t *metric)
+{
+    int index;
+    if (!lookup(metric_names, ALERT_METRIC_COUNT, name, &index))
+        return false;
+    *metric = (alert_metric_t)index;
+    return true;
+}
+
+bool alert_condition_from_name(const char *name, alert_condition_t *condition)
+{
+    int index;
+    if (!lookup(condition_names, ALERT_CONDITION_COUNT, name, &index))
+        return false;
+    *condition = (alert_condition_t)index;
+    return true;
+}
+
+bool alert_action_from_name(const char *name, alert_action_t *action)
+{
+    int index;
+    if (!lookup(action_names, ALERT_ACTION_COUNT, name, &index))
+        return false;
+    *action = (alert_action_t)index;
+    return true;
+}
@@ -0,0 +1,110 @@
+#ifndef ALERTS_H
+#define ALERTS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Motor de regras de alerta, avaliado uma vez por amostra com estado de tamanho fixo por regra.
+// Cada regra compara uma grandeza (ou sua variação dentro de uma janela) com um limiar:
+// - histerese: uma regra ativa só é liberada quando o valor volta além de limiar ± histerese;
+// - duração mínima: a condição precisa persistir por duration_s antes de disparar;
+// - taxa de variação: a variação é medida contra o valor de ~window_s atrás, guardado em um anel
+//   de ALERT_RATE_SLOTS baldes (o primeiro valor de cada balde), sem percorrer o histórico;
+// - intervalo mínimo: um novo disparo dentro de cooldown_s após o anterior não é notificado.
+// Valores em centésimos da unidade exibida: °C, % e hPa (ou seja, a pressão em Pa).
+
+#define ALERT_MAX_RULES         8   // Regras no motor
+#define ALERT_USER_RULE_FIRST   2   // As regras 0 e 1 são os limites de temperatura de /api/limits
+#define ALERT_USER_RULES        (ALERT_MAX_RULES - ALERT_USER_RULE_FIRST)
+#define ALERT_RATE_SLOTS        13  // Baldes do anel de taxa (janela dividida em 12)
+#define ALERT_MAX_WINDOW_S      (7 * 24 * 3600) // Janela, duração e intervalo mínimo máximos
+
+typedef enum {
+    ALERT_METRIC_TEMPERATURE, // Temperatura com offset aplicado
+    ALERT_METRIC_HUMIDITY,
+    ALERT_METRIC_PRESSURE,
+    ALERT_METRIC_DEW_POINT,
+    ALERT_METRIC_HEAT_INDEX,
+    ALERT_METRIC_COUNT
+} alert_metric_t;
+
+typedef enum {
+    ALERT_CONDITION_ABOVE, // Valor acima do limiar
+    ALERT_CONDITION_BELOW, // Valor abaixo do limiar
+    ALERT_CONDITION_RISE,  // Subida maior que o limiar dentro da janela
+    ALERT_CONDITION_DROP,  // Queda maior que o limiar dentro da janela
+    ALERT_CONDITION_COUNT
+} alert_condition_t;
+
+typedef enum {
+    ALERT_ACTION_NONE,     // Apenas registra (API e terminal)
+    ALERT_ACTION_BUZZER_A, // Tom agudo no buzzer A
+    ALERT_ACTION_BUZZER_B, // Tom grave no buzzer B
+    ALERT_ACTION_COUNT
+} alert_action_t;
+
+typedef enum {
+    ALERT_STATUS_IDLE,    // Condição falsa
+    ALERT_STATUS_PENDING, // Condição verdadeira, aguardando a duração mínima
+    ALERT_STATUS_ACTIVE,  // Disparada; aguarda o valor sair da histerese
+} alert_status_t;
+
+// Regra (também o formato gravado na configuração persistente)
+typedef struct {
+    uint8_t metric;      // alert_metric_t
+    uint8_t condition;   // alert_condition_t
+    uint8_t action;      // alert_action_t
+    uint8_t enabled;
+    int32_t threshold;   // Limiar (nível) ou variação dentro da janela, em centésimos
+    int32_t hysteresis;  // Margem para liberar a regra, em centésimos
+    uint32_t window_s;   // Janela da taxa de variação (RISE e DROP)
+    uint32_t duration_s; // Tempo mínimo com a condição verdadeira
+    uint32_t cooldown_s; // Intervalo mínimo entre notificações
+} alert_rule_t;
+
+typedef struct {
+    alert_status_t status;
+    bool has_value;       // value é válido (taxa: já há histórico de uma janela)
+    bool has_fired;
+    int32_t value;        // Último nível (ou variação) avaliado
+    uint32_t since_ms;    // Início da condição verdadeira
+    uint32_t fired_ms;    // Última notificação
+    uint32_t fired;       // Notificações
+    uint32_t suppressed;  // Disparos dentro do intervalo mínimo
+    uint32_t bucket;      // Balde atual do anel de taxa
+    uint16_t valid;       // Baldes preenchidos
+    int32_t ring[ALERT_RATE_SLOTS];
+} alert_state_t;
+
+typedef struct {
+    alert_rule_t rules[ALERT_MAX_RULES];
+    alert_state_t state[ALERT_MAX_RULES];
+} alert_engine_t;
+
+// Inicia o motor com todas as regras desabilitadas
+void alert_engine_init(alert_engine_t *engine);
+
+// Verifica se a regra é válida (taxa de variação exige limiar positivo e janela de 12 s a 7 dias)
+bool alert_rule_valid(const alert_rule_t *rule);
+
+// Substitui uma regra e reinicia seu estado. Retorna false (sem alterar nada) se for inválida.
+bool alert_engine_set_rule(alert_engine_t *engine, int index, const alert_rule_t *rule);
+
+// Altera apenas o limiar, mantendo o estado (a histerese vale a partir da próxima amostra)
+void alert_engine_set_threshold(alert_engine_t *engine, int index, int32_t threshold);
+
+// Avalia as regras com os valores da amostra. Retorna a máscara das regras notificadas agora.
+uint32_t alert_engine_update(alert_engine_t *engine, const int32_t values[ALERT_METRIC_COUNT], uint32_t now_ms);
+
+// Preenche as regras de usuário padrão (queda de pressão de 3 hPa em 3 h)
+void alert_default_user_rules(alert_rule_t rules[ALERT_USER_RULES]);
+
+const char *alert_metric_name(alert_metric_t metric);
+const char *alert_condition_name(alert_condition_t condition);
+const char *alert_action_name(alert_action_t action);
+const char *alert_status_str(alert_status_t status);
+bool alert_metric_from_name(const char *name, alert_metric_t *metric);
+bool alert_condition_from_name(const char *name, alert_condition_t *condition);
+bool alert_action_from_name(const char *name, alert_action_t *action);
+
+#endif // ALERTS_H
@@ -0,0 +1,147 @@
+#include "altitude.h"
+
+// Tabela de (p / 101325)^0.1903 em Q24, com p de ALT_TABLE_P_MIN a ALT_TABLE_P_MAX
+// em passos de 512 Pa (181 entradas, 724 bytes em flash). Gerada com:
+//   [round(((24576 + i * 512) / 101325.0) ** 0.1903 * 2**24) for i in range(181)]
+#define ALT_TABLE_P_MIN 24576
+#define ALT_TABLE_P_MAX 116736
+#define ALT_TABLE_SHIFT 9
+#define ALT_TABLE_SIZE (((ALT_TABLE_P_MAX - ALT_TABLE_P_MIN) >> ALT_TABLE_SHIFT) + 1)
+
+// Constante da fórmula barométrica (44330 m) em centímetros
+#define ALT_SCALE_CM 4433000LL
+
+static const uint32_t pow_table[ALT_TABLE_SIZE] = {
+    12812867, 12863241, 12912790, 12961543, 13009528, 13056771, 13103298, 13149133,
+    13194298, 13238814, 13282702, 13325982, 13368672, 13410790, 13452352, 13493375,
+    13533875, 13573865, 13613359, 13652373, 13690917, 13729006, 13766649, 13803861,
+    13840650, 13877027, 13913004, 13948588, 13983791, 14018621, 14053086, 14087195,
+    14120957, 14154378, 14187467, 14220231, 14252677, 14284812, 14316642, 14348173,
+    14379413, 14410366, 14441039, 14471438, 14501567, 14531432, 14561038, 14590390,
+    14619493, 14648352, 14676970, 14705354, 14733506, 14761431, 14789133, 14816616,
+    14843884, 14870940, 14897788, 14924433, 14950876, 14977122, 15003173, 15029034,
+    15054706, 15080194, 15105500, 15130626, 15155576, 15180353, 15204959, 15229396,
+    15253668, 15277777, 15301724, 15325514, 15349147, 15372626, 15395954, 15419133,
+    15442164, 15465050, 15487792, 15510394, 15532856, 15555181, 15577370, 15599426,
+    15621350, 15643143, 15664808, 15686347, 15707760, 15729050, 15750218, 15771266,
+    15792194, 15813006, 15833701, 15854282, 15874750, 15895107, 15915353, 15935490,
+    15955519, 15975442, 15995260, 16014973, 16034584, 16054094, 16073503, 16092813,
+    16112025, 16131140, 16150159, 16169083, 16187914, 16206651, 16225297, 16243853,
+    16262318, 16280695, 16298984, 16317186, 16335302, 16353333, 16371279, 16389143,
+    16406924, 16424623, 16442242, 16459780, 16477240, 16494621, 16511924, 16529151,
+    16546301, 16563377, 16580377, 16597304, 16614158, 16630939, 16647649, 16664287,
+    16680856, 16697354, 16713783, 16730144, 16746437, 16762663, 16778823, 16794916,
+    16810944, 16826908, 16842807, 16858642, 16874415, 16890125, 16905773, 16921360,
+    16936885, 16952351, 16967757, 16983103, 16998391, 17013620, 17028792, 17043906,
+    17058964, 17073965, 17088910, 17103800, 17118635, 17133416, 17148142, 17162815,
+    17177434, 17192001, 17206516, 17220978, 17235389,
+};
+
+static int32_t qnh_pa = ALTITUDE_DEFAULT_QNH_PA; // Pressão de referência atual
+static uint32_t qnh_pow = 0;                      // (QNH / 101325)^0.1903 em Q24
+static uint32_t qnh_scale = 0;                    // 4433000 / qnh_pow em Q32
+
+// Retorna (p / 101325)^0.1903 em Q24 por interpolação linear na tabela
+static uint32_t pressure_pow(int32_t pressure_pa)
+{
+    if (pressure_pa < ALT_TABLE_P_MIN)
+        pressure_pa = ALT_TABLE_P_MIN;
+    if (pressure_pa >= ALT_TABLE_P_MAX)
+        return pow_table[ALT_TABLE_SIZE - 1];
+
+    uint32_t offset = (uint32_t)(pressure_pa - ALT_TABLE_P_MIN);
+    uint32_t index = offset >> ALT_TABLE_SHIFT;
+    uint32_t frac = offset & ((1u << ALT_TABLE_SHIFT) - 1);
+
+    // A diferença entre entradas é menor que 2^16, então o produto cabe em 32 bits
+    uint32_t delta = pow_table[index + 1] - pow_table[index];
+    return pow_table[index] + ((delta * frac) >> ALT_TABLE_SHIFT);
+}
+
+// Recalcula os termos que dependem apenas do QNH
+static void update_qnh_terms(void)
+{
+    qnh_pow = pressure_pow(qnh_pa);
+    qnh_scale = (uint32_t)((ALT_SCALE_CM << 32) / qnh_pow);
+}
+
+int32_t altitude_from_pressure(int32_t pressure_pa)
+{
+    if (qnh_pow == 0)
+        update_qnh_terms();
+
+    // h = 44330 * (1 - f(p) / f(QNH)) = (f(QNH) - f(p)) * (4433000 / f(QNH)) [cm]
+    int32_t diff = (int32_t)qnh_pow - (int32_t)pressure_pow(pressure_pa);
+    return (int32_t)(((int64_t)diff * qnh_scale) >> 32);
+}
+
+bool altitude_set_qnh(int32_t new_qnh_pa)
+{
+    if (new_qnh_pa < ALTITUDE_QNH_MIN_PA || new_qnh_pa > ALTITUDE_QNH_MAX_PA)
+        return false;
+
+    qnh_pa = new_qnh_pa;
+    update_qnh_terms();
+    return true;
+}
+
+int32_t altitude_get_qnh(void)
+{
+    return qnh_pa;
+}
+
+#ifdef ALTITUDE_BENCHMARK
+#include <stdio.h>
+#include <math.h>
+#include "pico/stdlib.h"
+
+#define BENCH_P_MIN 30000  // 300 hPa
+#define BENCH_P_MAX 110000 // 1100 hPa
+#define BENCH_P_STEP 7     // Passo ímpar para não coincidir com os nós da tabela
+
+// Implementação original, mantida apenas como referência para o benchmark
+static double altitude_pow(double pressure, double qnh)
+{
+    return 44330.0 * (1.0 - pow(pressure / qnh, 0.1903));
+}
+
+void altitude_benchmark(void)
+{
+    volatile int32_t sink_fixed = 0; // Evita que o compilador elimine os laços
+    volatile double sink_pow = 0;
+    uint32_t samples = 0;
+
+    uint64_t start = time_us_64();
+    for (int32_t p = BENCH_P_MIN; p <= BENCH_P_MAX; p += BENCH_P_STEP)
+    {
+        sink_fixed = altitude_from_pressure(p);
+        samples++;
+    }
+    uint64_t fixed_us = time_us_64() - start;
+
+    start = time_us_64();
+    for (int32_t p = BENCH_P_MIN; p <= BENCH_P_MAX; p += BENCH_P_STEP)
+        sink_pow = altitude_pow(p, qnh_pa);
+    uint64_t pow_us = time_us_64() - start;
+
+    // Erro máximo em relação à fórmula original
+    double max_error_cm = 0;
+    int32_t worst_p = 0;
+    for (int32_t p = BENCH_P_MIN; p <= BENCH_P_MAX; p += BENCH_P_STEP)
+    {
+        double error = fabs(altitude_from_pressure(p) - altitude_pow(p, qnh_pa) * 100.0);
+        if (error > max_error_cm)
+        {
+            max_error_cm = error;
+            worst_p = p;
+        }
+    }
+
+    (void)sink_fixed;
+    (void)sink_pow;
+    printf("Benchmark de altitude (%lu amostras, QNH=%ld Pa)\n", (unsigned long)samples, (long)qnh_pa);
+    printf("  pow() double: %.3f us/chamada\n", (double)pow_us / samples);
+    printf("  ponto fixo:   %.3f us/chamada\n", (double)fixed_us / samples);
+    printf("  erro maximo:  %.2f cm em %ld Pa\n", max_error_cm, (long)worst_p);
+}
+#endif
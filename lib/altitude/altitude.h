@@ -0,0 +1,35 @@
+#ifndef ALTITUDE_H
+#define ALTITUDE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Pressão padrão ao nível do mar (ISA), em Pa
+#define ALTITUDE_DEFAULT_QNH_PA 101325
+
+// Faixa aceita para o QNH (extremos já registrados ao nível do mar), em Pa
+#define ALTITUDE_QNH_MIN_PA 87000
+#define ALTITUDE_QNH_MAX_PA 108500
+
+// Calcula a altitude barométrica em centímetros a partir da pressão em Pa.
+// Implementação em ponto fixo (tabela + interpolação linear), sem pow() nem float.
+// Erro máximo em relação a 44330 * (1 - (p / QNH)^0.1903):
+//   - 300 a 1100 hPa: 0,20 m
+//   - 700 a 1100 hPa: 0,05 m
+// (medido para QNH entre 950 e 1050 hPa)
+int32_t altitude_from_pressure(int32_t pressure_pa);
+
+// Define a pressão de referência ao nível do mar (QNH) em Pa.
+// Retorna false se o valor estiver fora da faixa aceita.
+bool altitude_set_qnh(int32_t qnh_pa);
+
+// Retorna a pressão de referência ao nível do mar (QNH) atual em Pa
+int32_t altitude_get_qnh(void);
+
+#ifdef ALTITUDE_BENCHMARK
+// Compara a implementação em ponto fixo com a versão em pow() (double)
+// e imprime o tempo médio por chamada e o erro máximo na faixa de 300 a 1100 hPa
+void altitude_benchmark(void);
+#endif
+
+#endif // ALTITUDE_H
@@ -1,38 +1,213 @@
+#include <string.h>
 #include "bmp280.h"
-#include "hardware/i2c.h"
 
-#define ADDR _u(0x76)
+// Intervalo entre leituras do status enquanto o fim de uma conversão é aguardado
+#define POLL_STEP_US 200
 
-void bmp280_init(i2c_inst_t *i2c) {
-    uint8_t buf[2];
-    const uint8_t reg_config_val = ((0x04 << 5) | (0x05 << 2)) & 0xFC;
-    buf[0] = REG_CONFIG;
-    buf[1] = reg_config_val;
-   
-    i2c_write_blocking(i2c, ADDR, buf, 2, false);
+static const struct bmp280_profile_config profiles[BMP280_PROFILE_COUNT] = {
+    [BMP280_PROFILE_ULTRA_LOW_POWER] = {"ultra-low-power", 1, 1, 0, 0, MODE_FORCED},
+    [BMP280_PROFILE_STANDARD] = {"standard", 1, 3, 4, 4, MODE_NORMAL},
+    [BMP280_PROFILE_HIGH_RESOLUTION] = {"high-resolution", 2, 5, 4, 4, MODE_NORMAL},
+    [BMP280_PROFILE_HIGH_RATE] = {"high-rate", 1, 2, 2, 0, MODE_NORMAL},
+};
 
-    const uint8_t reg_ctrl_meas_val = (0x01 << 5) | (0x03 << 2) | (0x03);
-    buf[0] = REG_CTRL_MEAS;
-    buf[1] = reg_ctrl_meas_val;
-    i2c_write_blocking(i2c, ADDR, buf, 2, false);
- //   printf("Ctrl_meas register value: %x\n", reg_ctrl_meas_val);
+// Tempo de standby do modo normal para cada código t_sb, em us
+static const uint32_t standby_time_us[8] = {500, 62500, 125000, 250000, 500000, 1000000, 2000000, 4000000};
+
+// Converte o código de oversampling (1..5) no número de amostras (1..16)
+static uint32_t oversampling_count(uint8_t osrs) {
+    return osrs == 0 ? 0 : 1u << (osrs - 1);
 }
 
-void bmp280_read_raw(i2c_inst_t *i2c, int32_t* temp, int32_t* pressure) {
-    uint8_t buf[6];
-    uint8_t reg = REG_PRESSURE_MSB;
-    i2c_write_blocking(i2c, ADDR, &reg, 1, true);
-    i2c_read_blocking(i2c, ADDR, buf, 6, false);
+// Retorna o instante us microssegundos antes de t (ou o boot, se t for anterior)
+static absolute_time_t time_before_us(absolute_time_t t, uint32_t us) {
+    uint64_t t_us = to_us_since_boot(t);
+    return from_us_since_boot(t_us > us ? t_us - us : 0);
+}
 
-    *pressure = (buf[0] << 12) | (buf[1] << 4) | (buf[2] >> 4);
-    *temp = (buf[3] << 12) | (buf[4] << 4) | (buf[5] >> 4);
+// Espera do driver: a do usuário (ex.: contabilizada pelo controle de energia) ou a do SDK
+static void bmp_sleep_until(bmp280_t *bmp, absolute_time_t until) {
+    if (bmp->sleep) {
+        bmp->sleep(until);
+    } else {
+        sleep_until(until);
+    }
+}
+
+static bool read_status(bmp280_t *bmp, uint8_t *status) {
+    return i2c_bus_read_regs(&bmp->device, REG_STATUS, status, 1) == I2C_BUS_OK;
+}
+
+// Consulta o bit "measuring" a cada POLL_STEP_US até a conversão terminar ou o prazo expirar.
+// Uma leitura que falha não conta como fim.
+static bool wait_measuring_done(bmp280_t *bmp, absolute_time_t until) {
+    for (;;) {
+        uint8_t status;
+        if (read_status(bmp, &status) && (status & STATUS_MEASURING) == 0) {
+            return true;
+        }
+        if (time_reached(until)) {
+            return false;
+        }
+        absolute_time_t next = delayed_by_us(get_absolute_time(), POLL_STEP_US);
+        bmp_sleep_until(bmp, absolute_time_diff_us(next, until) > 0 ? next : until);
+    }
+}
+
+static bool write_ctrl_meas(bmp280_t *bmp, const struct bmp280_profile_config *config, uint8_t mode) {
+    uint8_t value = (uint8_t)((config->osrs_t << 5) | (config->osrs_p << 2) | mode);
+    return i2c_bus_write_reg(&bmp->device, REG_CTRL_MEAS, value) == I2C_BUS_OK;
+}
+
+// Reidentificação após recuperação do barramento (contexto do laço principal)
+static void on_bus_reprobe(void *context) {
+    bmp280_reprobe((bmp280_t *)context);
+}
+
+bool bmp280_init(bmp280_t *bmp, i2c_bus_t *bus, uint8_t addr) {
+    i2c_device_init(&bmp->device, bus, addr);
+    bmp->profile = BMP280_PROFILE_STANDARD;
+    bmp->ready = false;
+    bmp->sleep = NULL;
+    i2c_bus_add_reprobe_hook(bus, on_bus_reprobe, bmp);
+
+    return bmp280_reprobe(bmp);
+}
+
+bool bmp280_reprobe(bmp280_t *bmp) {
+    uint8_t chip_id = 0;
+    bmp->ready = i2c_bus_read_regs(&bmp->device, REG_ID, &chip_id, 1) == I2C_BUS_OK &&
+                 chip_id == BMP280_CHIP_ID &&
+                 bmp280_get_calib_params(bmp, &bmp->calib) &&
+                 bmp280_set_profile(bmp, bmp->profile);
+    return bmp->ready;
+}
+
+bool bmp280_set_profile(bmp280_t *bmp, bmp280_profile_t profile) {
+    if (profile >= BMP280_PROFILE_COUNT) {
+        return false;
+    }
+    const struct bmp280_profile_config *config = &profiles[profile];
+
+    // Escritas em REG_CONFIG podem ser ignoradas no modo normal, então o sensor passa por sleep
+    bool ok = write_ctrl_meas(bmp, config, MODE_SLEEP) &&
+              i2c_bus_write_reg(&bmp->device, REG_CONFIG,
+                                (uint8_t)(((config->t_sb << 5) | (config->filter << 2)) & 0xFC)) == I2C_BUS_OK;
+
+    // No modo forçado o sensor permanece em sleep até bmp280_wait_conversion disparar a medição
+    if (ok && config->mode == MODE_NORMAL) {
+        ok = write_ctrl_meas(bmp, config, MODE_NORMAL);
+    }
+
+    bmp->profile = profile;
+    return ok;
+}
+
+void bmp280_set_sleep(bmp280_t *bmp, bmp280_sleep_t sleep) {
+    bmp->sleep = sleep;
+}
+
+bmp280_profile_t bmp280_get_profile(const bmp280_t *bmp) {
+    return bmp->profile;
+}
 
+const struct bmp280_profile_config *bmp280_get_profile_config(bmp280_profile_t profile) {
+    return profile < BMP280_PROFILE_COUNT ? &profiles[profile] : NULL;
+}
+
+bool bmp280_profile_from_name(const char *name, bmp280_profile_t *profile) {
+    for (int i = 0; i < BMP280_PROFILE_COUNT; i++) {
+        if (strcmp(name, profiles[i].name) == 0) {
+            *profile = (bmp280_profile_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t bmp280_measurement_time_typ_us(bmp280_profile_t profile) {
+    const struct bmp280_profile_config *config = &profiles[profile];
+    // t_measure,typ = 1 + 2 * T + (2 * P + 0,5) ms
+    return 1000 + 2000 * oversampling_count(config->osrs_t) +
+           (config->osrs_p ? 2000 * oversampling_count(config->osrs_p) + 500 : 0);
+}
+
+uint32_t bmp280_measurement_time_max_us(bmp280_profile_t profile) {
+    const struct bmp280_profile_config *config = &profiles[profile];
+    // t_measure,max = 1,25 + 2,3 * T + (2,3 * P + 0,575) ms
+    return 1250 + 2300 * oversampling_count(config->osrs_t) +
+           (config->osrs_p ? 2300 * oversampling_count(config->osrs_p) + 575 : 0);
+}
+
+uint32_t bmp280_conversion_period_us(bmp280_profile_t profile) {
+    const struct bmp280_profile_config *config = &profiles[profile];
+    uint32_t period = bmp280_measurement_time_typ_us(profile);
+    if (config->mode == MODE_NORMAL) {
+        period += standby_time_us[config->t_sb];
+    }
+    return period;
+}
+
+absolute_time_t bmp280_wait_conversion(bmp280_t *bmp, absolute_time_t deadline) {
+    bmp280_profile_t current_profile = bmp->profile;
+    const struct bmp280_profile_config *config = &profiles[current_profile];
+    uint32_t typ_us = bmp280_measurement_time_typ_us(current_profile);
+    uint32_t max_us = bmp280_measurement_time_max_us(current_profile);
+
+    // Dispara a medição para que ela termine até deadline mesmo no tempo máximo, com um passo de
+    // consulta de folga para a última leitura do status. No modo normal o ciclo do sensor é reiniciado
+    // (sleep e normal, em que a primeira conversão começa na hora): a conversão lida fica presa à
+    // grade das amostras, e não até um standby inteiro mais velha.
+    bmp_sleep_until(bmp, time_before_us(deadline, max_us + POLL_STEP_US));
+    absolute_time_t start = get_absolute_time();
+    if (config->mode == MODE_NORMAL) {
+        write_ctrl_meas(bmp, config, MODE_SLEEP);
+    }
+    write_ctrl_meas(bmp, config, config->mode);
+
+    bmp_sleep_until(bmp, delayed_by_us(start, typ_us));
+    wait_measuring_done(bmp, delayed_by_us(start, max_us));
+    return get_absolute_time();
+}
 
+bool bmp280_read_raw(bmp280_t *bmp, int32_t* temp, int32_t* pressure) {
+    static const uint8_t reg = REG_PRESSURE_MSB;
+    if (i2c_bus_write_read(&bmp->device, &reg, 1, bmp->raw, sizeof(bmp->raw)) != I2C_BUS_OK) {
+        return false;
+    }
+    if (!bmp280_check_raw(bmp)) {
+        return false;
+    }
+    bmp280_parse_raw(bmp, temp, pressure);
+    return true;
+}
+
+bool bmp280_read_raw_async(bmp280_t *bmp, i2c_bus_callback_t callback, void *user_data) {
+    static const uint8_t reg = REG_PRESSURE_MSB;
+    return i2c_bus_submit(&bmp->device, &reg, 1, bmp->raw, sizeof(bmp->raw), callback, user_data) == I2C_BUS_OK;
+}
+
+bool bmp280_check_raw(bmp280_t *bmp) {
+    // Valor dos registradores de dados após o reset, antes da primeira conversão (0x80000 nos dois)
+    static const uint8_t reset_raw[6] = {0x80, 0x00, 0x00, 0x80, 0x00, 0x00};
+    if (memcmp(bmp->raw, reset_raw, sizeof(reset_raw)) != 0) {
+        return true;
+    }
+    bmp280_reprobe(bmp);
+    return false;
+}
+
+void bmp280_parse_raw(const bmp280_t *bmp, int32_t* temp, int32_t* pressure) {
+    bmp280_decode_raw(bmp->raw, temp, pressure);
+}
+
+void bmp280_decode_raw(const uint8_t buf[6], int32_t* temp, int32_t* pressure) {
+    *pressure = (buf[0] << 12) | (buf[1] << 4) | (buf[2] >> 4);
+    *temp = (buf[3] << 12) | (buf[4] << 4) | (buf[5] >> 4);
 }
 
-void bmp280_reset(i2c_inst_t *i2c) {
-    uint8_t buf[2] = { REG_RESET, 0xB6 };
-    i2c_write_blocking(i2c, ADDR, buf, 2, false);
+void bmp280_reset(bmp280_t *bmp) {
+    i2c_bus_write_reg(&bmp->device, REG_RESET, 0xB6);
 }
 
 // função intermediária que calcula a temperatura de resolução fina
@@ -80,12 +255,14 @@ int32_t bmp280_convert_pressure(int32_t pressure, int32_t temp, struct bmp280_ca
     return converted;
 }
 
-void bmp280_get_calib_params(i2c_inst_t *i2c, struct bmp280_calib_param* params) {
-    uint8_t buf[NUM_CALIB_PARAMS] = { 0 };
-    uint8_t reg = REG_DIG_T1_LSB;
-    i2c_write_blocking(i2c, ADDR, &reg, 1, true);
-    i2c_read_blocking(i2c, ADDR, buf, NUM_CALIB_PARAMS, false);
+bool bmp280_get_calib_params(bmp280_t *bmp, struct bmp280_calib_param* params) {
+    if (i2c_bus_read_regs(&bmp->device, REG_DIG_T1_LSB, bmp->calib_raw, NUM_CALIB_PARAMS) != I2C_BUS_OK) {
+        return false;
+    }
+    return bmp280_parse_calib(bmp->calib_raw, params);
+}
 
+bool bmp280_parse_calib(const uint8_t buf[NUM_CALIB_PARAMS], struct bmp280_calib_param* params) {
     params->dig_t1 = (uint16_t)(buf[1] << 8) | buf[0];
     params->dig_t2 = (int16_t)(buf[3] << 8) | buf[2];
     params->dig_t3 = (int16_t)(buf[5] << 8) | buf[4];
@@ -100,5 +277,6 @@ void bmp280_get_calib_params(i2c_inst_t *i2c, struct bmp280_calib_param* params)
     params->dig_p8 = (int16_t)(buf[21] << 8) | buf[20];
     params->dig_p9 = (int16_t)(buf[23] << 8) | buf[22];
 
-
+    // Coeficiente dig_p1 nulo indica leitura corrompida (causaria divisão por zero na compensação)
+    return params->dig_p1 != 0;
 }
@@ -1,14 +1,29 @@
 #ifndef BMP280_H
 #define BMP280_H
 
-#include "hardware/i2c.h"
+#include "pico/stdlib.h"
+#include "i2c_bus/i2c_bus.h"
 
-// Defina os endereços e registros conforme o código original
-#define ADDR _u(0x76)
+// Endereços possíveis (pino SDO em GND ou em VDDIO)
+#define BMP280_ADDR_PRIMARY _u(0x76)
+#define BMP280_ADDR_SECONDARY _u(0x77)
+
+#define BMP280_CHIP_ID 0x58
+#define REG_ID _u(0xD0)
 
 #define REG_CONFIG _u(0xF5)
 #define REG_CTRL_MEAS _u(0xF4)
 #define REG_RESET _u(0xE0)
+#define REG_STATUS _u(0xF3)
+
+// Bits do registrador de status
+#define STATUS_MEASURING 0x08 // Conversão em andamento
+#define STATUS_IM_UPDATE 0x01 // Cópia da NVM em andamento
+
+// Modos de operação (bits 1..0 de REG_CTRL_MEAS)
+#define MODE_SLEEP 0x00
+#define MODE_FORCED 0x01
+#define MODE_NORMAL 0x03
 
 #define REG_TEMP_XLSB _u(0xFC)
 #define REG_TEMP_LSB _u(0xFB)
@@ -61,12 +76,92 @@ struct bmp280_calib_param {
     int16_t dig_p9;
 };
 
-//void bmp280_init(void);
-void bmp280_init(i2c_inst_t *i2c);
-void bmp280_read_raw(i2c_inst_t *i2c, int32_t* temp, int32_t* pressure);
-void bmp280_reset(i2c_inst_t *i2c);
+// Perfis de consumo/oversampling (recomendações da seção 3.4 do datasheet)
+typedef enum {
+    BMP280_PROFILE_ULTRA_LOW_POWER, // Modo forçado, T x1, P x1, sem filtro
+    BMP280_PROFILE_STANDARD,        // Modo normal, T x1, P x4, filtro x16, standby 500 ms
+    BMP280_PROFILE_HIGH_RESOLUTION, // Modo normal, T x2, P x16, filtro x16, standby 500 ms
+    BMP280_PROFILE_HIGH_RATE,       // Modo normal, T x1, P x2, filtro x4, standby 0,5 ms
+    BMP280_PROFILE_COUNT
+} bmp280_profile_t;
+
+// Configuração dos registradores de um perfil (códigos do datasheet)
+struct bmp280_profile_config {
+    const char *name;
+    uint8_t osrs_t; // Oversampling da temperatura (1 = x1 ... 5 = x16)
+    uint8_t osrs_p; // Oversampling da pressão (1 = x1 ... 5 = x16)
+    uint8_t filter; // Coeficiente do filtro IIR (0 = desligado ... 4 = x16)
+    uint8_t t_sb;   // Tempo de standby no modo normal (0 = 0,5 ms ... 7 = 4000 ms)
+    uint8_t mode;   // MODE_FORCED ou MODE_NORMAL
+};
+
+// Espera até o instante informado, usada pelo driver enquanto aguarda uma conversão
+typedef void (*bmp280_sleep_t)(absolute_time_t until);
+
+// Estado de um BMP280 (podem existir dois por barramento, em 0x76 e 0x77)
+typedef struct {
+    i2c_device_t device;
+    struct bmp280_calib_param calib;
+    bmp280_profile_t profile;
+    uint8_t raw[6];                      // Registradores de pressão e temperatura lidos
+    uint8_t calib_raw[NUM_CALIB_PARAMS]; // Registradores de calibração lidos (0x88 a 0x9F)
+    bool ready;                          // Sensor identificado e configurado
+    bmp280_sleep_t sleep;                // Espera entre as consultas (NULL = sleep_until do SDK)
+} bmp280_t;
+
+// Verifica o chip ID, lê a calibração e aplica BMP280_PROFILE_STANDARD.
+// Registra a reidentificação automática após recuperações do barramento.
+// Retorna false se o sensor não responder no endereço.
+bool bmp280_init(bmp280_t *bmp, i2c_bus_t *bus, uint8_t addr);
+
+// Verifica o chip ID, relê a calibração e reaplica o perfil atual
+bool bmp280_reprobe(bmp280_t *bmp);
+
+bool bmp280_read_raw(bmp280_t *bmp, int32_t* temp, int32_t* pressure);
+void bmp280_reset(bmp280_t *bmp);
 int32_t bmp280_convert_temp(int32_t temp, struct bmp280_calib_param* params);
 int32_t bmp280_convert_pressure(int32_t pressure, int32_t temp, struct bmp280_calib_param* params);
-void bmp280_get_calib_params(i2c_inst_t *i2c, struct bmp280_calib_param* params);
+bool bmp280_get_calib_params(bmp280_t *bmp, struct bmp280_calib_param* params);
+
+// Converte os registradores de calibração (como em calib_raw). Retorna false se estiverem corrompidos.
+bool bmp280_parse_calib(const uint8_t buf[NUM_CALIB_PARAMS], struct bmp280_calib_param* params);
+
+// Leitura assíncrona: enfileira a leitura dos registradores de dados no barramento e chama
+// callback ao final (no contexto da interrupção). Os valores são obtidos com bmp280_parse_raw.
+bool bmp280_read_raw_async(bmp280_t *bmp, i2c_bus_callback_t callback, void *user_data);
+void bmp280_parse_raw(const bmp280_t *bmp, int32_t* temp, int32_t* pressure);
+
+// Confere os dados lidos: o padrão de reset (0x80000 em temperatura e pressão) indica que o sensor
+// reiniciou sem NAK no barramento. Nesse caso reidentifica o sensor, reaplicando o perfil, e retorna
+// false. Chamar no laço principal após bmp280_read_raw_async (bmp280_read_raw já confere).
+bool bmp280_check_raw(bmp280_t *bmp);
+
+// Extrai as leituras de 6 registradores de dados (0xF7 a 0xFC), lidos agora ou gravados em um trace
+void bmp280_decode_raw(const uint8_t buf[6], int32_t* temp, int32_t* pressure);
+
+// Aplica um perfil de consumo/oversampling (bmp280_init aplica BMP280_PROFILE_STANDARD)
+bool bmp280_set_profile(bmp280_t *bmp, bmp280_profile_t profile);
+bmp280_profile_t bmp280_get_profile(const bmp280_t *bmp);
+
+// Troca a espera usada em bmp280_wait_conversion (NULL volta ao sleep_until do SDK)
+void bmp280_set_sleep(bmp280_t *bmp, bmp280_sleep_t sleep);
+const struct bmp280_profile_config *bmp280_get_profile_config(bmp280_profile_t profile);
+
+// Busca um perfil pelo nome ("ultra-low-power", "standard", "high-resolution", "high-rate").
+// Retorna false se o nome não for reconhecido.
+bool bmp280_profile_from_name(const char *name, bmp280_profile_t *profile);
+
+// Tempos de uma conversão do perfil, em us (fórmulas da seção 3.8.1 do datasheet)
+uint32_t bmp280_measurement_time_typ_us(bmp280_profile_t profile);
+uint32_t bmp280_measurement_time_max_us(bmp280_profile_t profile);
+
+// Período entre conversões no modo normal (t_measure + t_standby), em us.
+// No modo forçado retorna o tempo típico de uma conversão.
+uint32_t bmp280_conversion_period_us(bmp280_profile_t profile);
+
+// Dispara uma conversão que termina até deadline (no tempo máximo do datasheet) e aguarda o fim dela.
+// No modo normal o ciclo do sensor é reiniciado a cada chamada, para que a fase acompanhe quem chama.
+// Retorna o instante em que a conversão terminou.
+absolute_time_t bmp280_wait_conversion(bmp280_t *bmp, absolute_time_t deadline);
 
 #endif
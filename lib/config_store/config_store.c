@@ -0,0 +1,215 @@
+#include <stddef.h>
+#include <string.h>
+#include "hardware/flash.h"
+#include "pico/flash.h"
+#include "altitude/altitude.h"
+#include "bmp280/bmp280.h"
+#include "power/power.h"
+#include "sampler/sampler.h"
+#include "config_store.h"
+
+#define CONFIG_MAGIC 0x47464357u // "WCFG"
+
+// Os dois setores finais da flash, um por versão
+#define CONFIG_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - 2 * FLASH_SECTOR_SIZE)
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t length;     // Bytes do registro após o cabeçalho
+    uint32_t generation;
+    uint32_t crc;        // CRC-32 do cabeçalho (sem este campo) e do registro
+} config_header_t;
+
+_Static_assert(sizeof(config_header_t) + sizeof(station_config_t) <= FLASH_PAGE_SIZE,
+               "a configuração deve caber em uma página da flash");
+
+typedef struct {
+    uint32_t offset;
+    const uint8_t *page;
+} flash_write_t;
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len)
+{
+    crc = ~crc;
+    while (len--)
+    {
+        crc ^= *data++;
+        for (int i = 0; i < 8; i++)
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+    }
+    return ~crc;
+}
+
+static uint32_t record_crc(const config_header_t *header, const void *payload)
+{
+    uint32_t crc = crc32_update(0, (const uint8_t *)header, offsetof(config_header_t, crc));
+    return crc32_update(crc, payload, header->length);
+}
+
+static const config_header_t *slot_header(int slot)
+{
+    return (const config_header_t *)(uintptr_t)(XIP_BASE + CONFIG_FLASH_OFFSET + slot * FLASH_SECTOR_SIZE);
+}
+
+static bool slot_valid(const config_header_t *header)
+{
+    return header->magic == CONFIG_MAGIC &&
+           header->length <= FLASH_PAGE_SIZE - sizeof(config_header_t) &&
+           header->crc == record_crc(header, header + 1);
+}
+
+// Transformações entre versões do registro (a versão 2 apenas acrescentou as regras de alerta)
+static void migrate(station_config_t *config, uint16_t from_version)
+{
+    (void)config;
+    switch (from_version)
+    {
+    default:
+        break;
+    }
+}
+
+void config_store_defaults(station_config_t *config)
+{
+    sampler_config_t sampler;
+    sampler_default_config(&sampler);
+
+    memset(config, 0, sizeof(*config));
+    config->min_temperature = 10;
+    config->max_temperature = 70;
+    config->temp_offset = 0;
+    config->qnh_pa = ALTITUDE_DEFAULT_QNH_PA;
+    config->alerts_enabled = 1;
+    config->bmp_profile = BMP280_PROFILE_STANDARD;
+    config->power_mode = POWER_MODE_PERFORMANCE;
+    config->sample_min_interval_ms = sampler.min_interval_ms;
+    config->sample_max_interval_ms = sampler.max_interval_ms;
+    config->sample_temp_deadband = sampler.temp_deadband;
+    config->sample_humidity_deadband = sampler.humidity_deadband;
+    config->sample_pressure_deadband = sampler.pressure_deadband;
+    alert_default_user_rules(config->alert_rules);
+}
+
+bool config_store_init(config_store_t *store, const station_config_t *defaults, station_config_t *config)
+{
+    memset(store, 0, sizeof(*store));
+    store->active_slot = -1;
+
+    // Escolhe o setor válido com a maior geração (comparação com sinal tolera a volta do contador)
+    for (int slot = 0; slot < 2; slot++)
+    {
+        const config_header_t *header = slot_header(slot);
+        if (slot_valid(header) &&
+            (store->active_slot < 0 || (int32_t)(header->generation - store->generation) > 0))
+        {
+            store->active_slot = (int8_t)slot;
+            store->generation = header->generation;
+        }
+    }
+
+    *config = *defaults;
+    if (store->active_slot >= 0)
+    {
+        const config_header_t *header = slot_header(store->active_slot);
+        size_t length = header->length < sizeof(*config) ? header->length : sizeof(*config);
+        memcpy(config, header + 1, length);
+        store->loaded_version = header->version;
+        if (header->version < CONFIG_VERSION)
+            migrate(config, header->version);
+    }
+
+    store->committed = *config;
+    store->pending = *config;
+    return store->active_slot >= 0;
+}
+
+void config_store_update(config_store_t *store, const station_config_t *config)
+{
+    if (memcmp(config, &store->pending, sizeof(*config)) == 0)
+        return;
+
+    store->pending = *config;
+
+    // Voltou ao valor gravado (ex.: controle arrastado de volta): nada a gravar
+    if (memcmp(config, &store->committed, sizeof(*config)) == 0)
+    {
+        store->dirty = false;
+        return;
+    }
+
+    if (store->dirty)
+    {
+        store->coalesced++;
+    }
+    else
+    {
+        store->dirty = true;
+        store->commit_limit = make_timeout_time_ms(CONFIG_COMMIT_MAX_DELAY_MS);
+    }
+
+    // Cada alteração adia a gravação, até o limite contado da primeira alteração pendente
+    store->commit_at = make_timeout_time_ms(CONFIG_COMMIT_DELAY_MS);
+    if (absolute_time_diff_us(store->commit_limit, store->commit_at) > 0)
+        store->commit_at = store->commit_limit;
+}
+
+// Executada por flash_safe_execute, com interrupções desabilitadas
+static void flash_write(void *param)
+{
+    const flash_write_t *write = param;
+    flash_range_erase(write->offset, FLASH_SECTOR_SIZE);
+    flash_range_program(write->offset, write->page, FLASH_PAGE_SIZE);
+}
+
+bool config_store_commit(config_store_t *store)
+{
+    if (!store->dirty)
+        return true;
+
+    int slot = store->active_slot == 0 ? 1 : 0;
+    uint8_t page[FLASH_PAGE_SIZE];
+    memset(page, 0xFF, sizeof(page));
+
+    config_header_t header = {
+        .magic = CONFIG_MAGIC,
+        .version = CONFIG_VERSION,
+        .length = sizeof(station_config_t),
+        .generation = store->generation + 1,
+    };
+    header.crc = record_crc(&header, &store->pending);
+    memcpy(page, &header, sizeof(header));
+    memcpy(page + sizeof(header), &store->pending, sizeof(store->pending));
+
+    flash_write_t write = {
+        .offset = CONFIG_FLASH_OFFSET + slot * FLASH_SECTOR_SIZE,
+        .page = page,
+    };
+    if (flash_safe_execute(flash_write, &write, UINT32_MAX) != PICO_OK ||
+        memcmp(slot_header(slot), page, sizeof(header) + sizeof(store->pending)) != 0)
+    {
+        // A versão anterior continua válida no outro setor; nova tentativa após o atraso
+        store->failures++;
+        store->commit_at = make_timeout_time_ms(CONFIG_COMMIT_DELAY_MS);
+        store->commit_limit = store->commit_at;
+        return false;
+    }
+
+    store->active_slot = (int8_t)slot;
+    store->generation = header.generation;
+    store->committed = store->pending;
+    store->dirty = false;
+    store->commits++;
+    return true;
+}
+
+void config_store_service(config_store_t *store)
+{
+    if (store->dirty && time_reached(store->commit_at))
+        config_store_commit(store);
+}
+
+absolute_time_t config_store_next_event(const config_store_t *store)
+{
+    return store->dirty ? store->commit_at : at_the_end_of_time;
+}
@@ -0,0 +1,72 @@
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include "pico/stdlib.h"
+#include "alerts/alerts.h"
+
+// Configuração persistente da estação em dois setores alternados no fim da flash.
+// Cada gravação vai para o setor que não contém a versão mais recente, com número de
+// geração incrementado e CRC-32: se a energia cair no meio da gravação, o CRC falha e a
+// versão anterior continua válida. Na inicialização, basta validar os dois cabeçalhos.
+// Alterações seguidas (ex.: arrastar um controle no painel) são agrupadas em uma única
+// gravação após CONFIG_COMMIT_DELAY_MS sem mudanças.
+
+#define CONFIG_VERSION 2               // Versão do registro station_config_t
+#define CONFIG_COMMIT_DELAY_MS 3000    // Silêncio exigido antes de gravar
+#define CONFIG_COMMIT_MAX_DELAY_MS 15000 // Atraso máximo desde a primeira alteração pendente
+
+// Registro de configuração. Evolução do esquema: campos novos são sempre acrescentados
+// ao final; registros antigos (mais curtos) recebem os valores padrão nos campos novos,
+// e transformações de campos existentes são feitas em migrate() por versão.
+typedef struct {
+    int16_t min_temperature;          // Limite inferior de alerta, em °C
+    int16_t max_temperature;          // Limite superior de alerta, em °C
+    int32_t temp_offset;              // Offset de temperatura, em centésimos de °C
+    int32_t qnh_pa;                   // Pressão ao nível do mar para a altitude
+    uint8_t alerts_enabled;
+    uint8_t bmp_profile;              // bmp280_profile_t
+    uint8_t power_mode;               // power_mode_t
+    uint8_t reserved;
+    uint32_t sample_min_interval_ms;
+    uint32_t sample_max_interval_ms;
+    int32_t sample_temp_deadband;     // Centésimos de °C
+    int32_t sample_humidity_deadband; // Centésimos de %
+    int32_t sample_pressure_deadband; // Pa
+    alert_rule_t alert_rules[ALERT_USER_RULES]; // Regras de alerta do usuário (versão 2)
+} station_config_t;
+
+typedef struct {
+    station_config_t committed;  // Última versão gravada (ou carregada)
+    station_config_t pending;    // Versão a gravar
+    bool dirty;
+    absolute_time_t commit_at;   // Instante da gravação agrupada
+    absolute_time_t commit_limit; // Limite para adiar a gravação
+    int8_t active_slot;          // Setor com a versão mais recente (-1 se nenhum)
+    uint32_t generation;
+    uint16_t loaded_version;     // Versão do registro encontrado na flash (0 se nenhum)
+    uint32_t commits;            // Gravações na flash
+    uint32_t coalesced;          // Alterações absorvidas por uma gravação pendente
+    uint32_t failures;           // Gravações que falharam na verificação
+} config_store_t;
+
+// Preenche os valores padrão das bibliotecas
+void config_store_defaults(station_config_t *config);
+
+// Carrega a versão mais recente da flash em config. Campos ausentes em registros antigos
+// (ou todos, se a flash não tiver registro válido) recebem os valores de defaults.
+// Retorna true se um registro válido foi encontrado.
+bool config_store_init(config_store_t *store, const station_config_t *defaults, station_config_t *config);
+
+// Informa a configuração atual; se diferente da gravada, agenda uma gravação agrupada
+void config_store_update(config_store_t *store, const station_config_t *config);
+
+// Grava a configuração pendente quando o prazo de agrupamento vencer (laço principal)
+void config_store_service(config_store_t *store);
+
+// Grava imediatamente a configuração pendente. Retorna false se a gravação falhar.
+bool config_store_commit(config_store_t *store);
+
+// Instante em que config_store_service precisa ser chamada
+absolute_time_t config_store_next_event(const config_store_t *store);
+
+#endif // CONFIG_STORE_H
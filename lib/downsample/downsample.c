@@ -0,0 +1,62 @@
+#include "downsample.h"
+
+void downsample_init(downsample_t *ds, uint32_t start_ms, uint32_t end_ms, uint32_t points,
+                     downsample_emit_t emit, void *user_data)
+{
+    uint64_t span = (uint64_t)end_ms - start_ms + 1;
+
+    ds->start_ms = start_ms;
+    ds->end_ms = end_ms;
+    ds->width_ms = (uint32_t)((span + points - 1) / points); // Arredondado para cima: no máximo points baldes
+    ds->index = 0;
+    ds->bucket.count = 0;
+    ds->emit = emit;
+    ds->user_data = user_data;
+}
+
+void downsample_add(downsample_t *ds, uint32_t time_ms, const int32_t values[DOWNSAMPLE_CHANNELS])
+{
+    if (time_ms < ds->start_ms || time_ms > ds->end_ms)
+        return;
+
+    uint32_t index = (time_ms - ds->start_ms) / ds->width_ms;
+    downsample_bucket_t *bucket = &ds->bucket;
+    if (bucket->count && index != ds->index)
+        downsample_finish(ds);
+
+    if (bucket->count == 0)
+    {
+        ds->index = index;
+        bucket->time_ms = time_ms;
+        for (int c = 0; c < DOWNSAMPLE_CHANNELS; c++)
+        {
+            bucket->min[c] = values[c];
+            bucket->max[c] = values[c];
+        }
+    }
+    else
+    {
+        for (int c = 0; c < DOWNSAMPLE_CHANNELS; c++)
+        {
+            if (values[c] < bucket->min[c])
+                bucket->min[c] = values[c];
+            if (values[c] > bucket->max[c])
+                bucket->max[c] = values[c];
+        }
+    }
+    bucket->count++;
+}
+
+void downsample_finish(downsample_t *ds)
+{
+    if (ds->bucket.count)
+    {
+        ds->emit(&ds->bucket, ds->user_data);
+        ds->bucket.count = 0;
+    }
+}
+
+uint32_t downsample_width_ms(const downsample_t *ds)
+{
+    return ds->width_ms;
+}
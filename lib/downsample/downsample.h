@@ -0,0 +1,48 @@
+#ifndef DOWNSAMPLE_H
+#define DOWNSAMPLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Redução de séries para gráficos por baldes de mínimo e máximo, em uma única passada e com
+// memória constante. O intervalo [start_ms, end_ms] é dividido em até `points` baldes de mesma
+// largura; cada balde com amostras produz uma linha com o mínimo e o máximo de cada canal, de
+// modo que picos curtos continuam visíveis mesmo com milhares de amostras por balde. Baldes sem
+// amostras (lacunas) não produzem linha. As amostras devem chegar em ordem de tempo.
+
+#define DOWNSAMPLE_CHANNELS 3 // Temperatura, umidade e pressão
+
+typedef struct {
+    uint32_t time_ms;   // Instante da primeira amostra do balde
+    uint32_t count;     // Amostras no balde
+    int32_t min[DOWNSAMPLE_CHANNELS];
+    int32_t max[DOWNSAMPLE_CHANNELS];
+} downsample_bucket_t;
+
+// Chamada para cada balde concluído, em ordem de tempo
+typedef void (*downsample_emit_t)(const downsample_bucket_t *bucket, void *user_data);
+
+typedef struct {
+    uint32_t start_ms;
+    uint32_t end_ms;
+    uint32_t width_ms;  // Largura de cada balde
+    uint32_t index;     // Número do balde em acumulação
+    downsample_bucket_t bucket;
+    downsample_emit_t emit;
+    void *user_data;
+} downsample_t;
+
+// Prepara a redução de [start_ms, end_ms] em até points baldes (points > 0)
+void downsample_init(downsample_t *ds, uint32_t start_ms, uint32_t end_ms, uint32_t points,
+                     downsample_emit_t emit, void *user_data);
+
+// Acrescenta uma amostra; amostras fora de [start_ms, end_ms] são ignoradas
+void downsample_add(downsample_t *ds, uint32_t time_ms, const int32_t values[DOWNSAMPLE_CHANNELS]);
+
+// Emite o balde em acumulação, se houver
+void downsample_finish(downsample_t *ds);
+
+// Largura dos baldes, em ms
+uint32_t downsample_width_ms(const downsample_t *ds);
+
+#endif // DOWNSAMPLE_H
@@ -0,0 +1,86 @@
+#include "fusion.h"
+
+// Variância do ruído de cada sensor, em (centésimos de °C)^2.
+// BMP280: ruído RMS de ~0,05 °C com oversampling x1; AHT20: ~0,03 °C.
+#define BMP_NOISE_VAR 25
+#define AHT_NOISE_VAR 9
+
+// Variância do passeio aleatório da temperatura real por amostra (0,03 °C por amostra)
+#define PROCESS_NOISE_VAR 9
+
+// Variância inicial da estimativa (1 °C)
+#define INITIAL_VAR 10000
+
+// Constante de tempo da estimativa de viés: 2^8 = 256 amostras
+#define BIAS_SHIFT 8
+
+void temp_fusion_init(temp_fusion_t *fusion)
+{
+    fusion->estimate = 0;
+    fusion->variance = INITIAL_VAR;
+    fusion->bias_diff = 0;
+    fusion->initialized = false;
+}
+
+int32_t temp_fusion_bias_aht(const temp_fusion_t *fusion)
+{
+    // Metade da diferença vai para cada sensor (arredondado)
+    return (fusion->bias_diff + (1 << BIAS_SHIFT)) >> (BIAS_SHIFT + 1);
+}
+
+int32_t temp_fusion_bias_bmp(const temp_fusion_t *fusion)
+{
+    return -temp_fusion_bias_aht(fusion);
+}
+
+// Etapa de correção do filtro de Kalman com uma medida já sem viés
+static void kalman_correct(temp_fusion_t *fusion, int32_t measurement, int32_t noise_var)
+{
+    // Ganho em Q16: K = P / (P + R)
+    int32_t gain = (int32_t)(((int64_t)fusion->variance << 16) / (fusion->variance + noise_var));
+    fusion->estimate += (int32_t)(((int64_t)(measurement - fusion->estimate) * gain) >> 16);
+    fusion->variance = (int32_t)(((int64_t)fusion->variance * ((1 << 16) - gain)) >> 16);
+    if (fusion->variance < 1)
+        fusion->variance = 1;
+}
+
+int32_t temp_fusion_update(temp_fusion_t *fusion,
+                           int32_t bmp_temp, bool bmp_valid,
+                           int32_t aht_temp, bool aht_valid)
+{
+    if (!bmp_valid && !aht_valid)
+        return fusion->estimate;
+
+    if (!fusion->initialized)
+    {
+        // Primeira amostra: parte da média das leituras disponíveis
+        if (bmp_valid && aht_valid)
+        {
+            fusion->estimate = (bmp_temp + aht_temp) / 2;
+            fusion->bias_diff = (aht_temp - bmp_temp) * (1 << BIAS_SHIFT);
+        }
+        else
+        {
+            fusion->estimate = bmp_valid ? bmp_temp : aht_temp;
+        }
+        fusion->variance = INITIAL_VAR;
+        fusion->initialized = true;
+    }
+    else if (bmp_valid && aht_valid)
+    {
+        // Média móvel exponencial da diferença entre os sensores
+        int32_t diff = (aht_temp - bmp_temp) * (1 << BIAS_SHIFT);
+        fusion->bias_diff += (diff - fusion->bias_diff) >> BIAS_SHIFT;
+    }
+
+    // Predição: a temperatura real segue um passeio aleatório
+    fusion->variance += PROCESS_NOISE_VAR;
+
+    // Correção sequencial com cada sensor, descontando o viés estimado
+    if (bmp_valid)
+        kalman_correct(fusion, bmp_temp - temp_fusion_bias_bmp(fusion), BMP_NOISE_VAR);
+    if (aht_valid)
+        kalman_correct(fusion, aht_temp - temp_fusion_bias_aht(fusion), AHT_NOISE_VAR);
+
+    return fusion->estimate;
+}
@@ -0,0 +1,31 @@
+#ifndef FUSION_H
+#define FUSION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Fusão das temperaturas do BMP280 e do AHT20 com um filtro de Kalman escalar.
+// Cada sensor é modelado como z = T + viés + ruído. A diferença média entre os sensores
+// é estimada por uma média móvel exponencial lenta e dividida entre os dois vieses
+// (soma zero), de modo que a estimativa fundida fica entre as duas referências.
+// Todas as temperaturas estão em centésimos de °C.
+typedef struct {
+    int32_t estimate;  // Temperatura fundida
+    int32_t variance;  // Variância da estimativa, em (centésimos de °C)^2
+    int32_t bias_diff; // Diferença média AHT20 - BMP280, em Q8
+    bool initialized;
+} temp_fusion_t;
+
+void temp_fusion_init(temp_fusion_t *fusion);
+
+// Atualiza a estimativa com as leituras disponíveis (o sensor com valid = false é ignorado).
+// Retorna a temperatura fundida.
+int32_t temp_fusion_update(temp_fusion_t *fusion,
+                           int32_t bmp_temp, bool bmp_valid,
+                           int32_t aht_temp, bool aht_valid);
+
+// Viés estimado de cada sensor em relação à temperatura fundida
+int32_t temp_fusion_bias_bmp(const temp_fusion_t *fusion);
+int32_t temp_fusion_bias_aht(const temp_fusion_t *fusion);
+
+#endif // FUSION_H
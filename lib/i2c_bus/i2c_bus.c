@@ -0,0 +1,459 @@
+#include <string.h>
+#include "i2c_bus.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+// Barramento associado a cada periférico I2C, usado pelas rotinas de interrupção
+static i2c_bus_t *buses[2] = {NULL, NULL};
+
+// Estado de uma transação bloqueante
+struct blocking_wait {
+    volatile bool done;
+    volatile i2c_bus_result_t result;
+};
+
+static void finish_transfer(i2c_bus_t *bus);
+
+static uint8_t next_index(uint8_t index)
+{
+    return (uint8_t)((index + 1) % I2C_BUS_QUEUE_SIZE);
+}
+
+// Configura o periférico e os pinos (usada na inicialização e após uma recuperação)
+static void configure_peripheral(i2c_bus_t *bus)
+{
+    i2c_init(bus->i2c, bus->baudrate);
+    gpio_set_function(bus->sda_pin, GPIO_FUNC_I2C);
+    gpio_set_function(bus->scl_pin, GPIO_FUNC_I2C);
+    gpio_pull_up(bus->sda_pin);
+    gpio_pull_up(bus->scl_pin);
+
+    // Sinais de DREQ para o DMA e interrupções de fim de transação
+    i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+    hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS | I2C_IC_DMA_CR_RDMAE_BITS;
+    hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+}
+
+// Libera um barramento travado (procedimento "bus clear" da especificação I2C):
+// até 9 pulsos em SCL para o escravo concluir o byte em andamento e soltar SDA,
+// seguidos de uma condição de STOP gerada manualmente e da reinicialização do periférico.
+static void recover_bus(i2c_bus_t *bus)
+{
+    uint half_period_us = 500000 / bus->baudrate + 1;
+    i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+
+    dma_channel_abort(bus->tx_dma);
+    dma_channel_abort(bus->rx_dma);
+    hw->intr_mask = 0;
+    hw->enable = 0;
+
+    // Pinos como GPIO em dreno aberto: nível baixo = saída em 0, nível alto = entrada com pull-up
+    gpio_set_function(bus->sda_pin, GPIO_FUNC_SIO);
+    gpio_set_function(bus->scl_pin, GPIO_FUNC_SIO);
+    gpio_put(bus->sda_pin, 0);
+    gpio_put(bus->scl_pin, 0);
+    gpio_set_dir(bus->sda_pin, GPIO_IN);
+    gpio_set_dir(bus->scl_pin, GPIO_IN);
+    busy_wait_us_32(half_period_us);
+
+    for (int i = 0; i < 9 && !gpio_get(bus->sda_pin); i++)
+    {
+        gpio_set_dir(bus->scl_pin, GPIO_OUT);
+        busy_wait_us_32(half_period_us);
+        gpio_set_dir(bus->scl_pin, GPIO_IN);
+        busy_wait_us_32(half_period_us);
+    }
+
+    // STOP: SDA sobe enquanto SCL está em nível alto
+    gpio_set_dir(bus->sda_pin, GPIO_OUT);
+    busy_wait_us_32(half_period_us);
+    gpio_set_dir(bus->scl_pin, GPIO_IN);
+    busy_wait_us_32(half_period_us);
+    gpio_set_dir(bus->sda_pin, GPIO_IN);
+    busy_wait_us_32(half_period_us);
+
+    configure_peripheral(bus);
+
+    bus->stats.recoveries++;
+    bus->stats.last_recovery_ms = to_ms_since_boot(get_absolute_time());
+    bus->reprobe_pending = true;
+}
+
+// Prazo da transação expirado: recupera o barramento e conclui a transação com erro
+static int64_t on_transfer_timeout(alarm_id_t id, void *user_data)
+{
+    i2c_bus_t *bus = (i2c_bus_t *)user_data;
+
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (bus->active && bus->timeout_alarm == id)
+    {
+        bus->timeout_alarm = 0;
+        bus->result = I2C_BUS_ERR_TIMEOUT;
+        finish_transfer(bus);
+    }
+    restore_interrupts(irq_state);
+    return 0; // Não repete o alarme
+}
+
+// Inicia a transação da cabeça da fila. Chamada com as interrupções desabilitadas
+// ou a partir da interrupção do barramento.
+static void start_transfer(i2c_bus_t *bus)
+{
+    i2c_bus_transfer_t *transfer = &bus->queue[bus->head];
+    i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+    size_t count = 0;
+
+    bus->active = true;
+    bus->result = I2C_BUS_OK;
+    bus->start_us = time_us_32();
+
+    // Prazo: duas vezes o tempo de transmissão (9 bits por byte, mais endereço e repeated start) mais folga
+    size_t bytes = transfer->write_len + transfer->read_len + 2;
+    uint32_t timeout_us = (uint32_t)(bytes * 9 * 2 * 1000000ull / bus->baudrate) + I2C_BUS_TIMEOUT_MARGIN_US;
+    bus->timeout_alarm = add_alarm_in_us(timeout_us, on_transfer_timeout, bus, true);
+
+    // O endereço do alvo só pode ser alterado com o periférico desabilitado
+    hw->enable = 0;
+    hw->tar = transfer->addr;
+    hw->enable = 1;
+
+    // Monta os comandos de IC_DATA_CMD: bytes a escrever seguidos de comandos de leitura.
+    // A primeira leitura após uma escrita gera um repeated start e o último comando gera STOP.
+    for (size_t i = 0; i < transfer->write_len; i++)
+    {
+        bus->cmd_buffer[count++] = transfer->write_data[i];
+    }
+    for (size_t i = 0; i < transfer->read_len; i++)
+    {
+        uint32_t cmd = I2C_IC_DATA_CMD_CMD_BITS;
+        if (i == 0 && transfer->write_len > 0)
+        {
+            cmd |= I2C_IC_DATA_CMD_RESTART_BITS;
+        }
+        bus->cmd_buffer[count++] = cmd;
+    }
+    bus->cmd_buffer[count - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+    if (transfer->read_len > 0)
+    {
+        dma_channel_config rx_config = dma_channel_get_default_config(bus->rx_dma);
+        channel_config_set_transfer_data_size(&rx_config, DMA_SIZE_8);
+        channel_config_set_read_increment(&rx_config, false);
+        channel_config_set_write_increment(&rx_config, true);
+        channel_config_set_dreq(&rx_config, i2c_get_dreq(bus->i2c, false));
+        dma_channel_configure(bus->rx_dma, &rx_config, transfer->read_data, &hw->data_cmd,
+                              transfer->read_len, true);
+    }
+
+    dma_channel_config tx_config = dma_channel_get_default_config(bus->tx_dma);
+    channel_config_set_transfer_data_size(&tx_config, DMA_SIZE_32);
+    channel_config_set_read_increment(&tx_config, true);
+    channel_config_set_write_increment(&tx_config, false);
+    channel_config_set_dreq(&tx_config, i2c_get_dreq(bus->i2c, true));
+    dma_channel_configure(bus->tx_dma, &tx_config, &hw->data_cmd, bus->cmd_buffer, count, true);
+}
+
+// Conclui a transação da cabeça da fila, chama o callback e inicia a próxima
+static void finish_transfer(i2c_bus_t *bus)
+{
+    i2c_bus_transfer_t transfer = bus->queue[bus->head];
+    i2c_bus_result_t result = bus->result;
+
+    if (bus->timeout_alarm > 0)
+    {
+        cancel_alarm(bus->timeout_alarm);
+        bus->timeout_alarm = 0;
+    }
+
+    // Contadores de diagnóstico
+    uint32_t latency = time_us_32() - bus->start_us;
+    bus->stats.transfers++;
+    bus->stats.last_latency_us = latency;
+    if (latency > bus->stats.max_latency_us)
+    {
+        bus->stats.max_latency_us = latency;
+    }
+
+    switch (result)
+    {
+    case I2C_BUS_OK:
+        bus->consecutive_naks = 0;
+        break;
+    case I2C_BUS_ERR_NAK:
+        bus->stats.naks++;
+        if (++bus->consecutive_naks >= I2C_BUS_NAK_REPROBE_THRESHOLD)
+        {
+            // Dispositivo possivelmente reiniciado: reidentifica sem mexer no barramento
+            bus->consecutive_naks = 0;
+            bus->reprobe_pending = true;
+        }
+        break;
+    case I2C_BUS_ERR_TIMEOUT:
+        bus->stats.timeouts++;
+        recover_bus(bus);
+        break;
+    default:
+        bus->stats.aborts++;
+        recover_bus(bus);
+        break;
+    }
+
+    bus->head = next_index(bus->head);
+    bus->active = false;
+
+    if (bus->head != bus->tail)
+    {
+        start_transfer(bus);
+    }
+
+    if (transfer.callback)
+    {
+        transfer.callback(result, transfer.user_data);
+    }
+    __sev(); // Acorda quem estiver aguardando em WFE
+}
+
+static void i2c_bus_irq_handler(i2c_bus_t *bus)
+{
+    i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+    uint32_t status = hw->intr_stat;
+
+    if (status & I2C_IC_INTR_STAT_R_TX_ABRT_BITS)
+    {
+        uint32_t source = hw->tx_abrt_source;
+        dma_channel_abort(bus->tx_dma);
+        dma_channel_abort(bus->rx_dma);
+        (void)hw->clr_tx_abrt;
+
+        if (source & (I2C_IC_TX_ABRT_SOURCE_ABRT_7B_ADDR_NOACK_BITS | I2C_IC_TX_ABRT_SOURCE_ABRT_TXDATA_NOACK_BITS))
+        {
+            bus->result = I2C_BUS_ERR_NAK;
+        }
+        else
+        {
+            bus->result = I2C_BUS_ERR_ABORT;
+        }
+    }
+
+    if (status & I2C_IC_INTR_STAT_R_STOP_DET_BITS)
+    {
+        (void)hw->clr_stop_det;
+        if (bus->active)
+        {
+            // O último byte recebido pode ainda estar sendo copiado pelo DMA (no máximo alguns ciclos)
+            for (int spin = 0; bus->result == I2C_BUS_OK && dma_channel_is_busy(bus->rx_dma); spin++)
+            {
+                if (spin > 1000)
+                {
+                    dma_channel_abort(bus->rx_dma);
+                    bus->result = I2C_BUS_ERR_ABORT; // Faltaram bytes na leitura
+                }
+            }
+            finish_transfer(bus);
+        }
+    }
+}
+
+static void i2c0_bus_irq(void)
+{
+    i2c_bus_irq_handler(buses[0]);
+}
+
+static void i2c1_bus_irq(void)
+{
+    i2c_bus_irq_handler(buses[1]);
+}
+
+void i2c_bus_init(i2c_bus_t *bus, i2c_inst_t *i2c, uint sda_pin, uint scl_pin, uint baudrate)
+{
+    uint index = i2c_hw_index(i2c);
+
+    bus->i2c = i2c;
+    bus->sda_pin = sda_pin;
+    bus->scl_pin = scl_pin;
+    bus->baudrate = baudrate;
+    bus->head = 0;
+    bus->tail = 0;
+    bus->active = false;
+    bus->result = I2C_BUS_OK;
+    bus->timeout_alarm = 0;
+    bus->consecutive_naks = 0;
+    bus->reprobe_pending = false;
+    bus->hook_count = 0;
+    memset(&bus->stats, 0, sizeof(bus->stats));
+    buses[index] = bus;
+
+    bus->tx_dma = dma_claim_unused_channel(true);
+    bus->rx_dma = dma_claim_unused_channel(true);
+
+    configure_peripheral(bus);
+
+    uint irq = I2C0_IRQ + index;
+    irq_set_exclusive_handler(irq, index == 0 ? i2c0_bus_irq : i2c1_bus_irq);
+    irq_set_enabled(irq, true);
+}
+
+void i2c_device_init(i2c_device_t *device, i2c_bus_t *bus, uint8_t addr)
+{
+    device->bus = bus;
+    device->addr = addr;
+}
+
+i2c_bus_result_t i2c_bus_submit(const i2c_device_t *device,
+                                const uint8_t *write_data, size_t write_len,
+                                uint8_t *read_data, size_t read_len,
+                                i2c_bus_callback_t callback, void *user_data)
+{
+    i2c_bus_t *bus = device->bus;
+
+    if (write_len + read_len == 0 || write_len + read_len > I2C_BUS_MAX_TRANSFER)
+    {
+        return I2C_BUS_ERR_ABORT;
+    }
+
+    uint32_t irq_state = save_and_disable_interrupts();
+
+    uint8_t tail = bus->tail;
+    if (next_index(tail) == bus->head)
+    {
+        bus->stats.queue_full++;
+        restore_interrupts(irq_state);
+        return I2C_BUS_ERR_QUEUE_FULL;
+    }
+
+    i2c_bus_transfer_t *transfer = &bus->queue[tail];
+    transfer->addr = device->addr;
+    transfer->write_data = write_data;
+    transfer->write_len = write_len;
+    transfer->read_data = read_data;
+    transfer->read_len = read_len;
+    transfer->callback = callback;
+    transfer->user_data = user_data;
+    bus->tail = next_index(tail);
+
+    if (!bus->active)
+    {
+        start_transfer(bus);
+    }
+
+    restore_interrupts(irq_state);
+    return I2C_BUS_OK;
+}
+
+static void blocking_callback(i2c_bus_result_t result, void *user_data)
+{
+    struct blocking_wait *wait = (struct blocking_wait *)user_data;
+    wait->result = result;
+    wait->done = true;
+}
+
+i2c_bus_result_t i2c_bus_write_read(const i2c_device_t *device,
+                                    const uint8_t *write_data, size_t write_len,
+                                    uint8_t *read_data, size_t read_len)
+{
+    struct blocking_wait wait = {false, I2C_BUS_OK};
+
+    i2c_bus_result_t result = i2c_bus_submit(device, write_data, write_len, read_data, read_len,
+                                             blocking_callback, &wait);
+    if (result != I2C_BUS_OK)
+    {
+        return result;
+    }
+
+    while (!wait.done)
+    {
+        __wfe();
+    }
+    return wait.result;
+}
+
+i2c_bus_result_t i2c_bus_write(const i2c_device_t *device, const uint8_t *data, size_t len)
+{
+    return i2c_bus_write_read(device, data, len, NULL, 0);
+}
+
+i2c_bus_result_t i2c_bus_read(const i2c_device_t *device, uint8_t *data, size_t len)
+{
+    return i2c_bus_write_read(device, NULL, 0, data, len);
+}
+
+i2c_bus_result_t i2c_bus_write_reg(const i2c_device_t *device, uint8_t reg, uint8_t value)
+{
+    uint8_t buf[2] = {reg, value};
+    return i2c_bus_write(device, buf, 2);
+}
+
+i2c_bus_result_t i2c_bus_read_regs(const i2c_device_t *device, uint8_t reg, uint8_t *data, size_t len)
+{
+    return i2c_bus_write_read(device, &reg, 1, data, len);
+}
+
+bool i2c_bus_probe(const i2c_device_t *device)
+{
+    uint8_t dummy;
+    return i2c_bus_read(device, &dummy, 1) == I2C_BUS_OK;
+}
+
+bool i2c_bus_idle(const i2c_bus_t *bus)
+{
+    return !bus->active && bus->head == bus->tail;
+}
+
+bool i2c_bus_add_reprobe_hook(i2c_bus_t *bus, i2c_bus_reprobe_t hook, void *context)
+{
+    for (uint8_t i = 0; i < bus->hook_count; i++)
+    {
+        if (bus->hooks[i] == hook && bus->hook_contexts[i] == context)
+        {
+            return true; // Já registrada (ex.: dispositivo reinicializado)
+        }
+    }
+    if (bus->hook_count >= I2C_BUS_MAX_HOOKS)
+    {
+        return false;
+    }
+    bus->hooks[bus->hook_count] = hook;
+    bus->hook_contexts[bus->hook_count] = context;
+    bus->hook_count++;
+    return true;
+}
+
+void i2c_bus_service(i2c_bus_t *bus)
+{
+    if (!bus->reprobe_pending)
+    {
+        return;
+    }
+    bus->reprobe_pending = false;
+    bus->stats.reprobes++;
+
+    for (uint8_t i = 0; i < bus->hook_count; i++)
+    {
+        bus->hooks[i](bus->hook_contexts[i]);
+    }
+}
+
+void i2c_bus_get_stats(const i2c_bus_t *bus, i2c_bus_stats_t *stats)
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    *stats = bus->stats;
+    restore_interrupts(irq_state);
+}
+
+const char *i2c_bus_result_str(i2c_bus_result_t result)
+{
+    switch (result)
+    {
+    case I2C_BUS_OK:
+        return "ok";
+    case I2C_BUS_ERR_NAK:
+        return "nak";
+    case I2C_BUS_ERR_ABORT:
+        return "abort";
+    case I2C_BUS_ERR_QUEUE_FULL:
+        return "queue-full";
+    case I2C_BUS_ERR_TIMEOUT:
+        return "timeout";
+    }
+    return "?";
+}
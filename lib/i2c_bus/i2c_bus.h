@@ -0,0 +1,146 @@
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+
+// Gerenciador assíncrono de barramento I2C.
+// Cada barramento tem uma fila de transações que são executadas por DMA (um canal para os
+// comandos/dados enviados e outro para os dados recebidos). O fim de cada transação é
+// detectado pela interrupção STOP_DET/TX_ABRT do periférico, que chama o callback da
+// transação e dispara a próxima da fila. Os dois barramentos progridem em paralelo
+// enquanto a CPU executa outras tarefas.
+//
+// Toda transação tem um prazo (alarme de hardware). Se o prazo expirar, ou o controlador
+// abortar por outro motivo que não NAK, o barramento é recuperado: pulsos em SCL até o
+// escravo liberar SDA, condição de STOP manual e reinicialização do periférico. Em seguida
+// os dispositivos registrados são reidentificados por i2c_bus_service (contexto do laço).
+
+#define I2C_BUS_QUEUE_SIZE 8    // Transações pendentes por barramento
+#define I2C_BUS_MAX_TRANSFER 32 // Bytes escritos + lidos por transação
+#define I2C_BUS_MAX_HOOKS 4     // Dispositivos com rotina de reidentificação por barramento
+
+// Folga somada ao tempo de transmissão no prazo de cada transação (clock stretching etc.)
+#define I2C_BUS_TIMEOUT_MARGIN_US 2000
+
+// NAKs consecutivos que indicam um dispositivo reiniciado (reidentificação sem recuperar o barramento)
+#define I2C_BUS_NAK_REPROBE_THRESHOLD 3
+
+// Resultado de uma transação
+typedef enum {
+    I2C_BUS_OK = 0,
+    I2C_BUS_ERR_NAK = -1,       // Endereço ou dado não reconhecido pelo dispositivo
+    I2C_BUS_ERR_ABORT = -2,     // Transação abortada pelo controlador (ex.: perda de arbitragem)
+    I2C_BUS_ERR_QUEUE_FULL = -3, // Fila do barramento cheia
+    I2C_BUS_ERR_TIMEOUT = -4     // Prazo da transação expirado (barramento travado)
+} i2c_bus_result_t;
+
+// Contadores de diagnóstico de um barramento
+typedef struct {
+    uint32_t transfers;       // Transações concluídas (com ou sem erro)
+    uint32_t naks;            // Transações sem reconhecimento do dispositivo
+    uint32_t aborts;          // Transações abortadas pelo controlador
+    uint32_t timeouts;        // Transações com prazo expirado
+    uint32_t queue_full;      // Submissões recusadas por fila cheia
+    uint32_t recoveries;      // Recuperações do barramento executadas
+    uint32_t reprobes;        // Reidentificações de dispositivos executadas
+    uint32_t last_latency_us; // Duração da última transação
+    uint32_t max_latency_us;  // Maior duração de transação observada
+    uint32_t last_recovery_ms; // Instante da última recuperação (ms desde o boot)
+} i2c_bus_stats_t;
+
+// Rotina de reidentificação de um dispositivo após recuperação do barramento
+typedef void (*i2c_bus_reprobe_t)(void *context);
+
+// Callback de fim de transação. Executado no contexto da interrupção do barramento.
+typedef void (*i2c_bus_callback_t)(i2c_bus_result_t result, void *user_data);
+
+typedef struct i2c_bus i2c_bus_t;
+
+// Dispositivo em um barramento (vários dispositivos podem compartilhar o mesmo barramento)
+typedef struct {
+    i2c_bus_t *bus;
+    uint8_t addr;
+} i2c_device_t;
+
+// Transação enfileirada: escrita opcional seguida de leitura opcional (com repeated start)
+typedef struct {
+    uint8_t addr;
+    const uint8_t *write_data;
+    size_t write_len;
+    uint8_t *read_data;
+    size_t read_len;
+    i2c_bus_callback_t callback;
+    void *user_data;
+} i2c_bus_transfer_t;
+
+struct i2c_bus {
+    i2c_inst_t *i2c;
+    uint sda_pin;
+    uint scl_pin;
+    uint baudrate;
+    int tx_dma; // Canal DMA de comandos (memória -> IC_DATA_CMD)
+    int rx_dma; // Canal DMA de leitura (IC_DATA_CMD -> memória)
+    uint32_t cmd_buffer[I2C_BUS_MAX_TRANSFER];
+    i2c_bus_transfer_t queue[I2C_BUS_QUEUE_SIZE];
+    volatile uint8_t head;   // Próxima transação a executar
+    volatile uint8_t tail;   // Próxima posição livre
+    volatile bool active;    // Transação da cabeça da fila em andamento
+    volatile i2c_bus_result_t result;
+    volatile alarm_id_t timeout_alarm;  // Alarme do prazo da transação em andamento
+    uint32_t start_us;                  // Início da transação em andamento
+    uint8_t consecutive_naks;
+    volatile bool reprobe_pending;      // Dispositivos precisam ser reidentificados
+    i2c_bus_reprobe_t hooks[I2C_BUS_MAX_HOOKS];
+    void *hook_contexts[I2C_BUS_MAX_HOOKS];
+    uint8_t hook_count;
+    i2c_bus_stats_t stats;
+};
+
+// Inicializa o periférico, os pinos, os canais DMA e a interrupção do barramento
+void i2c_bus_init(i2c_bus_t *bus, i2c_inst_t *i2c, uint sda_pin, uint scl_pin, uint baudrate);
+
+// Associa um dispositivo a um barramento
+void i2c_device_init(i2c_device_t *device, i2c_bus_t *bus, uint8_t addr);
+
+// Enfileira uma transação sem bloquear. Os buffers precisam permanecer válidos até o callback.
+// Pode ser chamada a partir de callbacks. Retorna I2C_BUS_ERR_QUEUE_FULL se a fila estiver cheia.
+i2c_bus_result_t i2c_bus_submit(const i2c_device_t *device,
+                                const uint8_t *write_data, size_t write_len,
+                                uint8_t *read_data, size_t read_len,
+                                i2c_bus_callback_t callback, void *user_data);
+
+// Versões bloqueantes (não devem ser usadas em callbacks ou interrupções).
+// A CPU dorme (WFE) enquanto a transação é executada por DMA.
+i2c_bus_result_t i2c_bus_write_read(const i2c_device_t *device,
+                                    const uint8_t *write_data, size_t write_len,
+                                    uint8_t *read_data, size_t read_len);
+i2c_bus_result_t i2c_bus_write(const i2c_device_t *device, const uint8_t *data, size_t len);
+i2c_bus_result_t i2c_bus_read(const i2c_device_t *device, uint8_t *data, size_t len);
+
+// Escreve um registrador de 8 bits / lê registradores consecutivos
+i2c_bus_result_t i2c_bus_write_reg(const i2c_device_t *device, uint8_t reg, uint8_t value);
+i2c_bus_result_t i2c_bus_read_regs(const i2c_device_t *device, uint8_t reg, uint8_t *data, size_t len);
+
+// Verifica se o dispositivo responde no endereço (leitura de 1 byte)
+bool i2c_bus_probe(const i2c_device_t *device);
+
+// Indica se o barramento não tem transações em andamento ou pendentes
+bool i2c_bus_idle(const i2c_bus_t *bus);
+
+// Registra a rotina que reidentifica um dispositivo (ex.: relê a calibração) após uma recuperação
+bool i2c_bus_add_reprobe_hook(i2c_bus_t *bus, i2c_bus_reprobe_t hook, void *context);
+
+// Executa as reidentificações pendentes. Deve ser chamada periodicamente pelo laço principal.
+void i2c_bus_service(i2c_bus_t *bus);
+
+// Copia os contadores de diagnóstico do barramento
+void i2c_bus_get_stats(const i2c_bus_t *bus, i2c_bus_stats_t *stats);
+
+// Nome do resultado de uma transação (para logs)
+const char *i2c_bus_result_str(i2c_bus_result_t result);
+
+#endif // I2C_BUS_H
@@ -0,0 +1,189 @@
+#include <string.h>
+#include "pico/cyw43_arch.h"
+#include "hardware/sync.h"
+#include "power.h"
+
+static const char *const mode_names[POWER_MODE_COUNT] = {
+    [POWER_MODE_PERFORMANCE] = "performance",
+    [POWER_MODE_LOW_POWER] = "low-power",
+};
+
+static power_mode_t current_mode = POWER_MODE_PERFORMANCE;
+static volatile bool wake_requested = false;
+
+// Contabilidade do relatório. Atualizada pelo laço principal com interrupções desabilitadas,
+// para que o relatório lido pela pilha de rede seja consistente.
+static uint64_t period_start_us; // Início do relatório
+static uint64_t mark_us;         // Início do trecho em andamento
+static bool sleeping;            // Núcleo em WFE no trecho em andamento
+static uint64_t awake_total_us;
+static uint64_t asleep_total_us;
+static uint64_t charge_uaus;     // Carga em µA·µs
+static uint32_t wakeups;
+static uint32_t samples;
+
+static uint32_t segment_current_ua(bool asleep)
+{
+    uint32_t wifi = current_mode == POWER_MODE_LOW_POWER ? POWER_WIFI_SAVE_UA : POWER_WIFI_ACTIVE_UA;
+    return wifi + (asleep ? POWER_CORE_SLEEP_UA : POWER_CORE_ACTIVE_UA);
+}
+
+// Fecha o trecho em andamento e inicia outro no estado informado
+static void account_segment(bool next_sleeping)
+{
+    uint32_t status = save_and_disable_interrupts();
+    uint64_t now = time_us_64();
+    uint64_t elapsed = now - mark_us;
+
+    if (sleeping)
+        asleep_total_us += elapsed;
+    else
+        awake_total_us += elapsed;
+    charge_uaus += elapsed * segment_current_ua(sleeping);
+
+    mark_us = now;
+    sleeping = next_sleeping;
+    restore_interrupts(status);
+}
+
+static void reset_report(void)
+{
+    uint32_t status = save_and_disable_interrupts();
+    period_start_us = mark_us = time_us_64();
+    sleeping = false;
+    awake_total_us = asleep_total_us = charge_uaus = 0;
+    wakeups = samples = 0;
+    restore_interrupts(status);
+}
+
+static uint32_t wifi_pm_value(power_mode_t mode)
+{
+    if (mode == POWER_MODE_LOW_POWER)
+    {
+        return cyw43_pm_value(CYW43_PM2_POWERSAVE_MODE, POWER_LOW_POWER_SLEEP_RET_MS,
+                              1, POWER_LOW_POWER_DTIM_LISTEN, 10);
+    }
+    return CYW43_PERFORMANCE_PM;
+}
+
+void power_init(power_mode_t mode)
+{
+    reset_report();
+    power_set_mode(mode);
+}
+
+bool power_set_mode(power_mode_t mode)
+{
+    if (mode >= POWER_MODE_COUNT)
+    {
+        return false;
+    }
+
+    if (cyw43_wifi_pm(&cyw43_state, wifi_pm_value(mode)) != 0)
+    {
+        return false;
+    }
+
+    current_mode = mode;
+    reset_report();
+    return true;
+}
+
+power_mode_t power_get_mode(void)
+{
+    return current_mode;
+}
+
+const char *power_mode_name(power_mode_t mode)
+{
+    return mode < POWER_MODE_COUNT ? mode_names[mode] : "unknown";
+}
+
+bool power_mode_from_name(const char *name, power_mode_t *mode)
+{
+    for (int i = 0; i < POWER_MODE_COUNT; i++)
+    {
+        if (strcmp(name, mode_names[i]) == 0)
+        {
+            *mode = (power_mode_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool power_sleep_until(absolute_time_t target)
+{
+    bool woken = false;
+
+    account_segment(true);
+    while (!time_reached(target))
+    {
+        if (wake_requested)
+        {
+            wake_requested = false;
+            woken = true;
+            break;
+        }
+
+        // WFE: acorda com interrupções (Wi-Fi, DMA, GPIO), com __sev() ou no prazo
+        best_effort_wfe_or_timeout(target);
+        wakeups++;
+    }
+    account_segment(false);
+
+    return woken;
+}
+
+void power_wait_until(absolute_time_t target)
+{
+    account_segment(true);
+    while (!time_reached(target))
+    {
+        best_effort_wfe_or_timeout(target);
+        wakeups++;
+    }
+    account_segment(false);
+}
+
+void power_wait_event(void)
+{
+    account_segment(true);
+    __wfe();
+    wakeups++;
+    account_segment(false);
+}
+
+void power_request_wake(void)
+{
+    wake_requested = true;
+    __sev();
+}
+
+void power_note_sample(void)
+{
+    samples++;
+}
+
+void power_get_report(power_report_t *report)
+{
+    uint32_t status = save_and_disable_interrupts();
+    uint64_t now = time_us_64();
+    uint64_t open = now - mark_us;
+    uint64_t awake = awake_total_us + (sleeping ? 0 : open);
+    uint64_t asleep = asleep_total_us + (sleeping ? open : 0);
+    uint64_t charge = charge_uaus + open * segment_current_ua(sleeping);
+    uint64_t elapsed = now - period_start_us;
+    report->wakeups = wakeups;
+    report->samples = samples;
+    restore_interrupts(status);
+
+    report->mode = current_mode;
+    report->elapsed_ms = (uint32_t)(elapsed / 1000);
+    report->awake_ms = (uint32_t)(awake / 1000);
+    report->sleep_ms = (uint32_t)(asleep / 1000);
+    report->duty_permille = elapsed ? (uint32_t)(awake * 1000 / elapsed) : 1000;
+    report->avg_current_ua = elapsed ? (uint32_t)(charge / elapsed) : 0;
+    report->charge_uah = (uint32_t)(charge / 3600000000ULL); // µA·µs para µAh
+    report->charge_per_sample_uc = report->samples ? (uint32_t)(charge / report->samples / 1000000) : 0;
+}
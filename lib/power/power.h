@@ -0,0 +1,66 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include "pico/stdlib.h"
+
+// Modos de energia. No modo de baixo consumo o CYW43 entra em power-save (PM2) ouvindo
+// um a cada POWER_LOW_POWER_DTIM_LISTEN beacons DTIM, o que limita a latência extra do
+// HTTP a algumas centenas de milissegundos, e o núcleo dorme (WFE) entre as amostras.
+typedef enum {
+    POWER_MODE_PERFORMANCE, // Rádio sempre atento, menor latência
+    POWER_MODE_LOW_POWER,   // Power-save do Wi-Fi e BMP280 em modo forçado
+    POWER_MODE_COUNT
+} power_mode_t;
+
+// Parâmetros do power-save do CYW43 no modo de baixo consumo
+#define POWER_LOW_POWER_SLEEP_RET_MS 100 // Tempo acordado após tráfego antes de voltar a dormir
+#define POWER_LOW_POWER_DTIM_LISTEN  3   // Ouve um a cada N beacons DTIM
+
+// Correntes médias estimadas, em µA, usadas no relatório de energia. São aproximações
+// para comparar configurações, não medições.
+#define POWER_CORE_ACTIVE_UA   24000 // RP2040 a 125 MHz executando
+#define POWER_CORE_SLEEP_UA    8000  // RP2040 em WFE
+#define POWER_WIFI_ACTIVE_UA   32000 // CYW43 associado sem power-save agressivo
+#define POWER_WIFI_SAVE_UA     3000  // CYW43 associado em PM2
+
+// Relatório de energia acumulado desde a última troca de modo
+typedef struct {
+    power_mode_t mode;
+    uint32_t elapsed_ms;     // Tempo coberto pelo relatório
+    uint32_t awake_ms;       // Tempo com o núcleo acordado
+    uint32_t sleep_ms;       // Tempo com o núcleo em WFE
+    uint32_t duty_permille;  // Fração acordada, em milésimos
+    uint32_t wakeups;        // Despertares do núcleo (interrupções e eventos)
+    uint32_t samples;        // Amostras registradas com power_note_sample
+    uint32_t avg_current_ua; // Corrente média estimada
+    uint32_t charge_uah;     // Carga estimada consumida, em µAh
+    uint32_t charge_per_sample_uc; // Carga estimada por amostra, em µC (µA·s)
+} power_report_t;
+
+// Aplica o modo inicial. Deve ser chamada após cyw43_arch_init.
+void power_init(power_mode_t mode);
+
+// Troca o modo de energia e reinicia o relatório. Retorna false se o CYW43 recusar a configuração.
+bool power_set_mode(power_mode_t mode);
+power_mode_t power_get_mode(void);
+
+const char *power_mode_name(power_mode_t mode);
+bool power_mode_from_name(const char *name, power_mode_t *mode);
+
+// Dorme até target ou até power_request_wake. Retorna true se acordou antes do prazo.
+bool power_sleep_until(absolute_time_t target);
+
+// Esperas curtas fora de power_sleep_until (drivers aguardando o sensor ou o DMA), contabilizadas
+// como núcleo em WFE. Não atendem power_request_wake: o pedido fica para o próximo power_sleep_until.
+void power_wait_until(absolute_time_t target);
+void power_wait_event(void);
+
+// Acorda o laço principal (seguro em interrupções e na pilha de rede)
+void power_request_wake(void);
+
+// Conta uma amostra para o cálculo de carga por amostra
+void power_note_sample(void);
+
+void power_get_report(power_report_t *report);
+
+#endif // POWER_H
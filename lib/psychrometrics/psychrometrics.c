@@ -0,0 +1,171 @@
+#include "psychrometrics.h"
+
+// Pressão de saturação do vapor sobre a água, em centésimos de Pa, de -40 °C a 80 °C a cada 1 °C.
+// Gerada com: [round(610.94 * exp(17.625 * T / (T + 243.04)) * 100) for T in range(-40, 81)]
+#define ES_T_MIN (-4000) // centésimos de °C
+#define ES_T_MAX 8000
+#define ES_STEP 100
+#define ES_TABLE_SIZE ((ES_T_MAX - ES_T_MIN) / ES_STEP + 1)
+
+static const uint32_t es_table[ES_TABLE_SIZE] = {
+    1897, 2103, 2330, 2579, 2851, 3149, 3475, 3832,
+    4220, 4644, 5106, 5609, 6156, 6751, 7397, 8098,
+    8857, 9681, 10572, 11536, 12578, 13704, 14919, 16230,
+    17643, 19165, 20803, 22565, 24459, 26493, 28677, 31020,
+    33533, 36224, 39106, 42191, 45490, 49016, 52782, 56803,
+    61094, 65670, 70546, 75741, 81271, 87156, 93414, 100066,
+    107134, 114638, 122602, 131050, 140007, 149500, 159554, 170198,
+    181462, 193377, 205973, 219284, 233344, 248189, 263855, 280381,
+    297807, 316174, 335523, 355901, 377352, 399924, 423665, 448627,
+    474862, 502424, 531370, 561757, 593645, 627096, 662173, 698942,
+    737472, 777831, 820093, 864331, 910622, 959045, 1009680, 1062612,
+    1117926, 1175711, 1236058, 1299059, 1364812, 1433415, 1504969, 1579579,
+    1657350, 1738394, 1822823, 1910752, 2002300, 2097589, 2196742, 2299888,
+    2407158, 2518685, 2634608, 2755065, 2880202, 3010166, 3145107, 3285180,
+    3430542, 3581355, 3737783, 3899995, 4068163, 4242463, 4423075, 4610182,
+    4803971,
+};
+
+// Coeficientes da regressão de Rothfusz em °C, multiplicados por 10^8
+#define HI_C1 (-878469476LL)
+#define HI_C2 161139411LL
+#define HI_C3 233854884LL
+#define HI_C4 (-14611605LL)
+#define HI_C5 (-1230809LL)
+#define HI_C6 (-1642483LL)
+#define HI_C7 221173LL
+#define HI_C8 72546LL
+#define HI_C9 (-358LL)
+
+static int32_t clamp_i32(int32_t value, int32_t min, int32_t max)
+{
+    return value < min ? min : (value > max ? max : value);
+}
+
+// Raiz quadrada inteira (método bit a bit)
+static uint32_t isqrt32(uint32_t value)
+{
+    uint32_t result = 0;
+    uint32_t bit = 1u << 30;
+    while (bit > value)
+        bit >>= 2;
+    while (bit)
+    {
+        if (value >= result + bit)
+        {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else
+        {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return result;
+}
+
+// Pressão de saturação (centésimos de Pa) por interpolação linear, partindo do índice anterior
+static uint32_t saturation_pressure(psychro_state_t *state, int32_t temperature)
+{
+    temperature = clamp_i32(temperature, ES_T_MIN, ES_T_MAX - 1);
+    uint8_t index = (uint8_t)((temperature - ES_T_MIN) / ES_STEP);
+    state->es_index = index;
+
+    int32_t frac = temperature - (ES_T_MIN + index * ES_STEP);
+    uint32_t delta = es_table[index + 1] - es_table[index];
+    return es_table[index] + (uint32_t)(((uint64_t)delta * frac) / ES_STEP);
+}
+
+// Inverso da tabela: temperatura (centésimos de °C) em que a pressão de saturação vale vapor.
+// A busca parte do segmento do ponto de orvalho anterior, que muda pouco entre amostras.
+static int32_t dew_point_from_vapor(psychro_state_t *state, uint32_t vapor)
+{
+    if (vapor <= es_table[0])
+        return ES_T_MIN;
+    if (vapor >= es_table[ES_TABLE_SIZE - 1])
+        return ES_T_MAX;
+
+    uint8_t index = state->dew_index;
+    if (index >= ES_TABLE_SIZE - 1)
+        index = ES_TABLE_SIZE - 2;
+    while (index > 0 && es_table[index] > vapor)
+        index--;
+    while (index < ES_TABLE_SIZE - 2 && es_table[index + 1] <= vapor)
+        index++;
+    state->dew_index = index;
+
+    uint32_t delta = es_table[index + 1] - es_table[index];
+    return ES_T_MIN + index * ES_STEP + (int32_t)(((uint64_t)(vapor - es_table[index]) * ES_STEP) / delta);
+}
+
+// Índice de calor do NWS: fórmula simples e, acima de 80 °F, regressão de Rothfusz com ajustes
+static int32_t heat_index(int32_t t, int32_t rh)
+{
+    // Fórmula simples (Steadman) convertida para °C: 1,1 T - 3,944 + 0,02611 RH
+    int32_t simple = (11 * t) / 10 - 394 + (rh * 2611) / 100000;
+    if ((simple + t) / 2 < 2667) // 80 °F
+        return simple;
+
+    int64_t t64 = t;
+    int64_t rh64 = rh;
+    int64_t t_rh = t64 * rh64 / 100;
+    int64_t hi = HI_C1 +
+                 t64 * (HI_C2 + HI_C5 * t64 / 100) / 100 +
+                 rh64 * (HI_C3 + HI_C6 * rh64 / 100) / 100 +
+                 t_rh * (HI_C4 + HI_C7 * t64 / 100 + HI_C8 * rh64 / 100 + HI_C9 * t_rh / 100) / 100;
+    int32_t result = (int32_t)(hi / 1000000);
+
+    // Ajustes do NWS, calculados em centésimos de °F e convertidos para °C
+    int32_t tf = t * 9 / 5 + 3200;
+    if (rh < 1300 && tf > 8000 && tf < 11200)
+    {
+        int32_t distance = tf > 9500 ? tf - 9500 : 9500 - tf;
+        uint32_t ratio_q16 = (uint32_t)(((1700 - distance) << 16) / 1700);
+        uint32_t root_q16 = isqrt32(ratio_q16) << 8;
+        int32_t adjustment = (int32_t)(((int64_t)(1300 - rh) / 4 * root_q16) >> 16);
+        result -= adjustment * 5 / 9;
+    }
+    else if (rh > 8500 && tf > 8000 && tf < 8700)
+    {
+        int32_t adjustment = (rh - 8500) / 10 * ((8700 - tf) / 5) / 100;
+        result += adjustment * 5 / 9;
+    }
+    return result;
+}
+
+void psychro_init(psychro_state_t *state)
+{
+    state->es_index = 0;
+    state->dew_index = 0;
+    state->last_temperature = 0;
+    state->last_humidity = 0;
+    state->valid = false;
+    state->metrics.dew_point = 0;
+    state->metrics.heat_index = 0;
+    state->metrics.absolute_humidity = 0;
+}
+
+const psychro_metrics_t *psychro_update(psychro_state_t *state, int32_t temperature, int32_t humidity)
+{
+    humidity = clamp_i32(humidity, 0, 10000);
+
+    // Entradas iguais às da amostra anterior: nada a recalcular
+    if (state->valid && temperature == state->last_temperature && humidity == state->last_humidity)
+        return &state->metrics;
+
+    // Pressão parcial do vapor: e = es(T) * UR
+    uint32_t vapor = (uint32_t)(((uint64_t)saturation_pressure(state, temperature) * humidity) / 10000);
+
+    state->metrics.dew_point = humidity == 0 ? ES_T_MIN : dew_point_from_vapor(state, vapor);
+    state->metrics.heat_index = heat_index(temperature, humidity);
+
+    // Umidade absoluta: AH = e * M_w / (R * T) = 2,1674 * e[Pa] / T[K] g/m³
+    int32_t kelvin = temperature + 27315; // centésimos de K
+    state->metrics.absolute_humidity = (int32_t)(((uint64_t)vapor * 21674) / ((uint64_t)kelvin * 100));
+
+    state->last_temperature = temperature;
+    state->last_humidity = humidity;
+    state->valid = true;
+    return &state->metrics;
+}
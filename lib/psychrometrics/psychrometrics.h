@@ -0,0 +1,32 @@
+#ifndef PSYCHROMETRICS_H
+#define PSYCHROMETRICS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Grandezas derivadas de temperatura e umidade, calculadas apenas com inteiros e uma tabela
+// da pressão de saturação do vapor (Magnus/Alduchov-Eskridge, -40 °C a 80 °C), sem log()/exp().
+typedef struct {
+    int32_t dew_point;         // Ponto de orvalho, em centésimos de °C
+    int32_t heat_index;        // Índice de calor (NWS/Rothfusz), em centésimos de °C
+    int32_t absolute_humidity; // Umidade absoluta, em centésimos de g/m³
+} psychro_metrics_t;
+
+// Estado incremental: as buscas na tabela partem do segmento usado na amostra anterior
+// e o resultado é reaproveitado quando as entradas não mudam.
+typedef struct {
+    uint8_t es_index;
+    uint8_t dew_index;
+    int32_t last_temperature;
+    int32_t last_humidity;
+    bool valid;
+    psychro_metrics_t metrics;
+} psychro_state_t;
+
+void psychro_init(psychro_state_t *state);
+
+// Atualiza as grandezas derivadas.
+// temperature em centésimos de °C e humidity em centésimos de %.
+const psychro_metrics_t *psychro_update(psychro_state_t *state, int32_t temperature, int32_t humidity);
+
+#endif // PSYCHROMETRICS_H
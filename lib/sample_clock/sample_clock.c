@@ -0,0 +1,102 @@
+#include <string.h>
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "sample_clock.h"
+
+static sample_clock_t *active_clock;
+
+static void on_alarm(uint alarm_num)
+{
+    sample_clock_t *clock = active_clock;
+    if (clock && (int)alarm_num == clock->alarm)
+    {
+        clock->fired_us = time_us_64();
+        clock->fired = true;
+    }
+}
+
+// Programa o alarme para o instante atual; um instante já passado conta como disparado
+static void arm(sample_clock_t *clock)
+{
+    clock->fired = false;
+    if (clock->alarm >= 0 && !hardware_alarm_set_target((uint)clock->alarm, from_us_since_boot(clock->tick_us)))
+        return;
+
+    clock->fired_us = time_us_64();
+    clock->fired = clock->fired_us >= clock->tick_us;
+}
+
+bool sample_clock_init(sample_clock_t *clock, uint64_t first_us)
+{
+    memset(clock, 0, sizeof(*clock));
+    clock->alarm = hardware_alarm_claim_unused(false);
+    active_clock = clock;
+    if (clock->alarm >= 0)
+        hardware_alarm_set_callback((uint)clock->alarm, on_alarm);
+
+    clock->tick_us = first_us;
+    arm(clock);
+    return clock->alarm >= 0;
+}
+
+void sample_clock_restart(sample_clock_t *clock, uint64_t tick_us)
+{
+    clock->tick_us = tick_us;
+    arm(clock);
+}
+
+void sample_clock_advance(sample_clock_t *clock, uint32_t interval_us, uint64_t now_us)
+{
+    uint64_t tick = clock->tick_us + interval_us;
+    if (tick <= now_us && interval_us)
+    {
+        // Próximo instante da grade depois de agora
+        uint64_t skipped = (now_us - tick) / interval_us + 1;
+        tick += skipped * interval_us;
+        uint32_t status = save_and_disable_interrupts();
+        clock->report.missed += (uint32_t)skipped;
+        restore_interrupts(status);
+    }
+    clock->tick_us = tick;
+    arm(clock);
+}
+
+uint64_t sample_clock_tick_us(const sample_clock_t *clock)
+{
+    return clock->tick_us;
+}
+
+bool sample_clock_fired(const sample_clock_t *clock)
+{
+    // Sem alarme de hardware, o tempo do sistema decide
+    return clock->fired || (clock->alarm < 0 && time_us_64() >= clock->tick_us);
+}
+
+void sample_clock_note(sample_clock_t *clock, uint64_t acquired_us)
+{
+    uint64_t late = acquired_us > clock->tick_us ? acquired_us - clock->tick_us : 0;
+    uint32_t jitter = late > UINT32_MAX ? UINT32_MAX : (uint32_t)late;
+    uint32_t bucket = jitter ? 32 - __builtin_clz(jitter) : 0;
+    if (bucket >= SAMPLE_CLOCK_BUCKETS)
+        bucket = SAMPLE_CLOCK_BUCKETS - 1;
+    uint32_t irq_latency = clock->fired && clock->fired_us > clock->tick_us ? (uint32_t)(clock->fired_us - clock->tick_us)
+                                                                            : 0;
+
+    uint32_t status = save_and_disable_interrupts();
+    sample_clock_report_t *report = &clock->report;
+    report->ticks++;
+    report->histogram[bucket]++;
+    report->jitter_sum_us += jitter;
+    if (jitter > report->max_jitter_us)
+        report->max_jitter_us = jitter;
+    if (irq_latency > report->max_irq_latency_us)
+        report->max_irq_latency_us = irq_latency;
+    restore_interrupts(status);
+}
+
+void sample_clock_get_report(const sample_clock_t *clock, sample_clock_report_t *report)
+{
+    uint32_t status = save_and_disable_interrupts();
+    *report = clock->report;
+    restore_interrupts(status);
+}
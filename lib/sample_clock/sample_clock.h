@@ -0,0 +1,55 @@
+#ifndef SAMPLE_CLOCK_H
+#define SAMPLE_CLOCK_H
+
+#include "pico/stdlib.h"
+
+// Relógio de amostragem: uma grade de instantes com intervalo fixo, marcada por um alarme de hardware
+// dedicado. Cada instante é agendado a partir do anterior (e não do fim do processamento), então o
+// período não acumula o tempo gasto pelo laço; se o laço atrasar além de um instante, os instantes
+// perdidos são pulados sem mudar a fase. O atraso de cada aquisição em relação à grade vai para um
+// histograma em potências de 2: a faixa i > 0 conta atrasos de 2^(i-1) a 2^i - 1 µs, e a última
+// também os maiores.
+// Um único relógio por firmware (o alarme chama de volta o último relógio iniciado).
+
+#define SAMPLE_CLOCK_BUCKETS 16 // Até 16 ms na última faixa
+
+typedef struct {
+    uint32_t ticks;             // Aquisições registradas
+    uint32_t missed;            // Instantes pulados por atraso do laço
+    uint32_t max_jitter_us;
+    uint32_t max_irq_latency_us; // Atraso do alarme até a interrupção
+    uint64_t jitter_sum_us;
+    uint32_t histogram[SAMPLE_CLOCK_BUCKETS];
+} sample_clock_report_t;
+
+typedef struct {
+    int alarm;                  // Alarme de hardware (-1 se nenhum estava livre)
+    uint64_t tick_us;           // Próximo instante da grade, em µs desde o boot
+    volatile bool fired;        // O alarme do instante atual disparou
+    volatile uint64_t fired_us; // Quando a interrupção atendeu o alarme
+    sample_clock_report_t report;
+} sample_clock_t;
+
+// Reserva um alarme de hardware e agenda o primeiro instante. Sem alarme livre, o relógio segue
+// funcionando pelo tempo do sistema (sample_clock_fired compara com o instante).
+bool sample_clock_init(sample_clock_t *clock, uint64_t first_us);
+
+// Recomeça a grade em tick_us (ao voltar de uma reprodução, por exemplo), sem contar atraso
+void sample_clock_restart(sample_clock_t *clock, uint64_t tick_us);
+
+// Agenda o instante seguinte, interval_us depois do atual. Instantes já passados em now_us são
+// pulados e contados como perdidos.
+void sample_clock_advance(sample_clock_t *clock, uint32_t interval_us, uint64_t now_us);
+
+uint64_t sample_clock_tick_us(const sample_clock_t *clock);
+
+// Indica se o instante atual já chegou (o alarme disparou)
+bool sample_clock_fired(const sample_clock_t *clock);
+
+// Registra uma aquisição iniciada em acquired_us para o instante atual
+void sample_clock_note(sample_clock_t *clock, uint64_t acquired_us);
+
+// Cópia consistente das medidas (pode ser chamada em interrupções)
+void sample_clock_get_report(const sample_clock_t *clock, sample_clock_report_t *report);
+
+#endif // SAMPLE_CLOCK_H
@@ -0,0 +1,151 @@
+#include "hardware/sync.h"
+#include "sample_log.h"
+
+static tsdb_block_t *block_at(sample_log_t *log, uint32_t position)
+{
+    return &log->blocks[(log->oldest + position) % SAMPLE_LOG_BLOCKS];
+}
+
+static const tsdb_block_t *const_block_at(const sample_log_t *log, uint32_t position)
+{
+    return &log->blocks[(log->oldest + position) % SAMPLE_LOG_BLOCKS];
+}
+
+static void record_to_point(const sample_record_t *record, tsdb_point_t *point)
+{
+    point->time_ms = record->time_ms;
+    point->values[0] = record->temperature;
+    point->values[1] = record->humidity;
+    point->values[2] = (int32_t)record->pressure;
+}
+
+void sample_log_init(sample_log_t *log)
+{
+    log->oldest = 0;
+    log->used = 0;
+    log->next_seq = 1;
+}
+
+uint32_t sample_log_append(sample_log_t *log, sample_record_t *record)
+{
+    tsdb_point_t point;
+    record_to_point(record, &point);
+
+    // A pilha de rede lê o registro em interrupção: a escrita não pode ser interrompida no meio
+    uint32_t status = save_and_disable_interrupts();
+    record->seq = log->next_seq++;
+
+    if (log->used == 0 || !tsdb_block_append(block_at(log, log->used - 1), &point))
+    {
+        // Bloco ativo cheio: abre outro, descartando o mais antigo se necessário
+        if (log->used == SAMPLE_LOG_BLOCKS)
+        {
+            log->oldest = (log->oldest + 1) % SAMPLE_LOG_BLOCKS;
+            log->used--;
+        }
+        tsdb_block_init(block_at(log, log->used), record->seq, &point);
+        log->used++;
+    }
+    restore_interrupts(status);
+
+    return record->seq;
+}
+
+uint32_t sample_log_first_seq(const sample_log_t *log)
+{
+    return log->used ? const_block_at(log, 0)->first_seq : 0;
+}
+
+uint32_t sample_log_last_seq(const sample_log_t *log)
+{
+    return log->used ? log->next_seq - 1 : 0;
+}
+
+uint32_t sample_log_bytes_used(const sample_log_t *log)
+{
+    uint32_t bytes = 0;
+    for (uint32_t i = 0; i < log->used; i++)
+    {
+        const tsdb_block_t *block = const_block_at(log, i);
+        bytes += sizeof(*block) - sizeof(block->data) + (block->bit_len + 7) / 8;
+    }
+    return bytes;
+}
+
+void sample_log_seek(const sample_log_t *log, sample_log_cursor_t *cursor, uint32_t since)
+{
+    cursor->log = log;
+    cursor->block = 0;
+
+    // Pula os blocos inteiros anteriores a since pelo cabeçalho, sem decodificá-los
+    while (cursor->block + 1 < log->used &&
+           const_block_at(log, cursor->block + 1)->first_seq <= since + 1)
+    {
+        cursor->block++;
+    }
+
+    if (log->used == 0)
+        return;
+
+    const tsdb_block_t *block = const_block_at(log, cursor->block);
+    tsdb_decoder_init(&cursor->decoder, block);
+
+    // Descarta os pontos do bloco até since
+    tsdb_point_t point;
+    for (uint32_t seq = block->first_seq; seq <= since && tsdb_decoder_next(&cursor->decoder, &point); seq++)
+    {
+    }
+}
+
+bool sample_log_next(sample_log_cursor_t *cursor, sample_record_t *record)
+{
+    const sample_log_t *log = cursor->log;
+    tsdb_point_t point;
+
+    while (cursor->block < log->used)
+    {
+        uint32_t seq = cursor->decoder.block->first_seq + cursor->decoder.index;
+        if (tsdb_decoder_next(&cursor->decoder, &point))
+        {
+            record->seq = seq;
+            record->time_ms = point.time_ms;
+            record->temperature = (int16_t)point.values[0];
+            record->humidity = (uint16_t)point.values[1];
+            record->pressure = (uint32_t)point.values[2];
+            return true;
+        }
+
+        if (++cursor->block < log->used)
+            tsdb_decoder_init(&cursor->decoder, const_block_at(log, cursor->block));
+    }
+    return false;
+}
+
+uint32_t sample_log_seq_at(const sample_log_t *log, uint32_t time_ms)
+{
+    uint32_t position = 0;
+    while (position < log->used && const_block_at(log, position)->last.time_ms < time_ms)
+        position++;
+    if (position == log->used)
+        return log->next_seq;
+
+    const tsdb_block_t *block = const_block_at(log, position);
+    tsdb_decoder_t decoder;
+    tsdb_point_t point;
+    tsdb_decoder_init(&decoder, block);
+    for (uint32_t seq = block->first_seq; tsdb_decoder_next(&decoder, &point); seq++)
+    {
+        if (point.time_ms >= time_ms)
+            return seq;
+    }
+    return block->first_seq + block->count; // Inalcançável: last.time_ms >= time_ms
+}
+
+bool sample_log_time_range(const sample_log_t *log, uint32_t *first_ms, uint32_t *last_ms)
+{
+    if (log->used == 0)
+        return false;
+    *first_ms = const_block_at(log, 0)->first.time_ms;
+    *last_ms = const_block_at(log, log->used - 1)->last.time_ms;
+    return true;
+}
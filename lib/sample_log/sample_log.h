@@ -0,0 +1,66 @@
+#ifndef SAMPLE_LOG_H
+#define SAMPLE_LOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "tsdb/tsdb.h"
+
+// Registro circular das amostras recentes com números de sequência crescentes, para que
+// um coletor recupere apenas o que perdeu (ex.: durante uma queda do Wi-Fi) com uma única
+// requisição incremental. As amostras são comprimidas em blocos independentes (tsdb); quando
+// todos os blocos estão ocupados, o mais antigo é descartado inteiro.
+// A sequência começa em 1 a cada inicialização.
+
+#define SAMPLE_LOG_BLOCKS 32 // Blocos de TSDB_BLOCK_BYTES (~430 amostras cada com leituras estáveis)
+
+typedef struct {
+    uint32_t seq;
+    uint32_t time_ms;     // Instante da amostra (ms desde o boot)
+    int16_t temperature;  // Centésimos de °C
+    uint16_t humidity;    // Centésimos de %
+    uint32_t pressure;    // Pa
+} sample_record_t;
+
+typedef struct {
+    tsdb_block_t blocks[SAMPLE_LOG_BLOCKS];
+    uint32_t oldest;      // Índice do bloco mais antigo
+    uint32_t used;        // Blocos em uso (o último é o bloco ativo)
+    uint32_t next_seq;    // Sequência da próxima amostra
+} sample_log_t;
+
+// Leitura sequencial a partir de uma sequência. Válido apenas enquanto nenhuma amostra
+// for acrescentada (a pilha de rede o usa dentro de uma única interrupção).
+typedef struct {
+    const sample_log_t *log;
+    uint32_t block;       // Posição do bloco a partir do mais antigo
+    tsdb_decoder_t decoder;
+} sample_log_cursor_t;
+
+void sample_log_init(sample_log_t *log);
+
+// Armazena uma amostra (o campo seq é preenchido) e retorna sua sequência.
+// Chamada pelo laço principal; pode ser lida concorrentemente pela pilha de rede.
+uint32_t sample_log_append(sample_log_t *log, sample_record_t *record);
+
+// Posiciona o cursor na primeira amostra com seq > since (ou na mais antiga disponível)
+void sample_log_seek(const sample_log_t *log, sample_log_cursor_t *cursor, uint32_t since);
+
+// Lê a próxima amostra. Retorna false quando não há mais amostras.
+bool sample_log_next(sample_log_cursor_t *cursor, sample_record_t *record);
+
+// Sequência da primeira amostra com instante >= time_ms (última sequência + 1 se não houver).
+// Pula os blocos anteriores pelo cabeçalho e decodifica apenas o bloco que contém o instante.
+uint32_t sample_log_seq_at(const sample_log_t *log, uint32_t time_ms);
+
+// Instantes da amostra mais antiga e da mais recente. Retorna false se o registro estiver vazio.
+bool sample_log_time_range(const sample_log_t *log, uint32_t *first_ms, uint32_t *last_ms);
+
+// Menor e maior sequência armazenadas (0 se o registro estiver vazio)
+uint32_t sample_log_first_seq(const sample_log_t *log);
+uint32_t sample_log_last_seq(const sample_log_t *log);
+
+// Memória ocupada pelas amostras comprimidas, em bytes
+uint32_t sample_log_bytes_used(const sample_log_t *log);
+
+#endif // SAMPLE_LOG_H
@@ -0,0 +1,141 @@
+#include <stddef.h>
+#include "sampler.h"
+
+static int32_t abs32(int32_t value)
+{
+    return value < 0 ? -value : value;
+}
+
+static void set_reference(sampler_t *sampler, int32_t temp, int32_t humidity, int32_t pressure)
+{
+    sampler->ref_temp = temp;
+    sampler->ref_humidity = humidity;
+    sampler->ref_pressure = pressure;
+}
+
+// Verifica se alguma grandeza saiu da zona morta em relação aos valores informados
+static bool outside_deadband(const sampler_config_t *config,
+                             int32_t temp, int32_t humidity, int32_t pressure,
+                             int32_t base_temp, int32_t base_humidity, int32_t base_pressure)
+{
+    return abs32(temp - base_temp) > config->temp_deadband ||
+           abs32(humidity - base_humidity) > config->humidity_deadband ||
+           abs32(pressure - base_pressure) > config->pressure_deadband;
+}
+
+void sampler_default_config(sampler_config_t *config)
+{
+    config->min_interval_ms = SAMPLER_DEFAULT_MIN_INTERVAL_MS;
+    config->max_interval_ms = SAMPLER_DEFAULT_MAX_INTERVAL_MS;
+    config->temp_deadband = SAMPLER_DEFAULT_TEMP_DEADBAND;
+    config->humidity_deadband = SAMPLER_DEFAULT_HUMIDITY_DEADBAND;
+    config->pressure_deadband = SAMPLER_DEFAULT_PRESSURE_DEADBAND;
+    config->alert_margin = SAMPLER_DEFAULT_ALERT_MARGIN;
+}
+
+void sampler_init(sampler_t *sampler, const sampler_config_t *config)
+{
+    sampler_default_config(&sampler->config);
+    if (config)
+    {
+        sampler_set_config(sampler, config);
+    }
+    sampler->interval_ms = sampler->config.min_interval_ms;
+    sampler->reason = SAMPLER_REASON_STARTUP;
+    sampler->initialized = false;
+}
+
+bool sampler_set_config(sampler_t *sampler, const sampler_config_t *config)
+{
+    if (config->min_interval_ms < 100 || config->max_interval_ms < config->min_interval_ms ||
+        config->max_interval_ms > 3600000 || config->temp_deadband < 0 ||
+        config->humidity_deadband < 0 || config->pressure_deadband < 0 || config->alert_margin < 0)
+    {
+        return false;
+    }
+
+    sampler->config = *config;
+
+    // Mantém o intervalo atual dentro dos novos limites
+    if (sampler->interval_ms < config->min_interval_ms)
+        sampler->interval_ms = config->min_interval_ms;
+    if (sampler->interval_ms > config->max_interval_ms)
+        sampler->interval_ms = config->max_interval_ms;
+    return true;
+}
+
+uint32_t sampler_update(sampler_t *sampler, int32_t temp, int32_t humidity, int32_t pressure,
+                        int32_t alert_low, int32_t alert_high)
+{
+    const sampler_config_t *config = &sampler->config;
+
+    if (!sampler->initialized)
+    {
+        sampler->interval_ms = config->min_interval_ms;
+        sampler->reason = SAMPLER_REASON_STARTUP;
+        sampler->initialized = true;
+        set_reference(sampler, temp, humidity, pressure);
+    }
+    else if (temp >= alert_high - config->alert_margin || temp <= alert_low + config->alert_margin)
+    {
+        sampler->interval_ms = config->min_interval_ms;
+        sampler->reason = SAMPLER_REASON_ALERT;
+        set_reference(sampler, temp, humidity, pressure);
+    }
+    else if (outside_deadband(config, temp, humidity, pressure,
+                              sampler->last_temp, sampler->last_humidity, sampler->last_pressure))
+    {
+        sampler->interval_ms = config->min_interval_ms;
+        sampler->reason = SAMPLER_REASON_CHANGE;
+        set_reference(sampler, temp, humidity, pressure);
+    }
+    else if (outside_deadband(config, temp, humidity, pressure,
+                              sampler->ref_temp, sampler->ref_humidity, sampler->ref_pressure))
+    {
+        sampler->interval_ms /= 2;
+        if (sampler->interval_ms < config->min_interval_ms)
+            sampler->interval_ms = config->min_interval_ms;
+        sampler->reason = SAMPLER_REASON_DRIFT;
+        set_reference(sampler, temp, humidity, pressure);
+    }
+    else
+    {
+        sampler->interval_ms = sampler->interval_ms > config->max_interval_ms / 2
+                                   ? config->max_interval_ms
+                                   : sampler->interval_ms * 2;
+        sampler->reason = SAMPLER_REASON_STABLE;
+    }
+
+    sampler->last_temp = temp;
+    sampler->last_humidity = humidity;
+    sampler->last_pressure = pressure;
+    return sampler->interval_ms;
+}
+
+uint32_t sampler_interval_ms(const sampler_t *sampler)
+{
+    return sampler->interval_ms;
+}
+
+sampler_reason_t sampler_reason(const sampler_t *sampler)
+{
+    return sampler->reason;
+}
+
+const char *sampler_reason_str(sampler_reason_t reason)
+{
+    switch (reason)
+    {
+    case SAMPLER_REASON_STARTUP:
+        return "startup";
+    case SAMPLER_REASON_STABLE:
+        return "stable";
+    case SAMPLER_REASON_DRIFT:
+        return "drift";
+    case SAMPLER_REASON_CHANGE:
+        return "change";
+    case SAMPLER_REASON_ALERT:
+        return "alert";
+    }
+    return "unknown";
+}
@@ -0,0 +1,65 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Amostragem adaptativa: o intervalo entre amostras dobra enquanto as leituras ficam dentro
+// das zonas mortas e volta ao mínimo quando há variação rápida ou quando a temperatura se
+// aproxima de um limite de alerta. Uma deriva lenta (acumulada desde a última referência)
+// reduz o intervalo pela metade.
+// Temperaturas em centésimos de °C, umidade em centésimos de % e pressão em Pa.
+
+#define SAMPLER_DEFAULT_MIN_INTERVAL_MS   1000
+#define SAMPLER_DEFAULT_MAX_INTERVAL_MS   60000
+#define SAMPLER_DEFAULT_TEMP_DEADBAND     10   // 0,1 °C
+#define SAMPLER_DEFAULT_HUMIDITY_DEADBAND 50   // 0,5 %
+#define SAMPLER_DEFAULT_PRESSURE_DEADBAND 20   // 0,2 hPa
+#define SAMPLER_DEFAULT_ALERT_MARGIN      100  // 1 °C
+
+// Motivo do intervalo escolhido na última amostra
+typedef enum {
+    SAMPLER_REASON_STARTUP, // Primeira amostra
+    SAMPLER_REASON_STABLE,  // Leituras dentro das zonas mortas: intervalo ampliado
+    SAMPLER_REASON_DRIFT,   // Deriva lenta acumulada: intervalo reduzido pela metade
+    SAMPLER_REASON_CHANGE,  // Variação rápida entre amostras: intervalo mínimo
+    SAMPLER_REASON_ALERT,   // Temperatura próxima de um limite de alerta: intervalo mínimo
+} sampler_reason_t;
+
+typedef struct {
+    uint32_t min_interval_ms;
+    uint32_t max_interval_ms;
+    int32_t temp_deadband;
+    int32_t humidity_deadband;
+    int32_t pressure_deadband;
+    int32_t alert_margin;     // Distância do limite de alerta que força o intervalo mínimo
+} sampler_config_t;
+
+typedef struct {
+    sampler_config_t config;
+    uint32_t interval_ms;
+    sampler_reason_t reason;
+    bool initialized;
+    int32_t last_temp, last_humidity, last_pressure; // Amostra anterior
+    int32_t ref_temp, ref_humidity, ref_pressure;    // Referência para detectar deriva
+} sampler_t;
+
+// Inicializa com a configuração informada (ou a padrão, se config for NULL)
+void sampler_init(sampler_t *sampler, const sampler_config_t *config);
+
+// Preenche a configuração padrão
+void sampler_default_config(sampler_config_t *config);
+
+// Aplica uma nova configuração. Retorna false (sem alterar nada) se for inválida.
+bool sampler_set_config(sampler_t *sampler, const sampler_config_t *config);
+
+// Registra uma amostra e retorna o intervalo até a próxima, em ms.
+// alert_low e alert_high são os limites de temperatura (já descontado o offset).
+uint32_t sampler_update(sampler_t *sampler, int32_t temp, int32_t humidity, int32_t pressure,
+                        int32_t alert_low, int32_t alert_high);
+
+uint32_t sampler_interval_ms(const sampler_t *sampler);
+sampler_reason_t sampler_reason(const sampler_t *sampler);
+const char *sampler_reason_str(sampler_reason_t reason);
+
+#endif // SAMPLER_H
@@ -0,0 +1,46 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "snapshot.h"
+
+void snapshot_init(snapshot_t *snapshot, void *copy0, void *copy1, size_t size, const void *initial)
+{
+    snapshot->seq = 0;
+    snapshot->size = size;
+    snapshot->copies[0] = copy0;
+    snapshot->copies[1] = copy1;
+    if (initial)
+    {
+        memcpy(copy0, initial, size);
+        memcpy(copy1, initial, size);
+    }
+    __dmb();
+}
+
+void snapshot_publish(snapshot_t *snapshot, const void *data)
+{
+    // Leitores passam para copies[1] enquanto copies[0] é atualizada...
+    snapshot->seq++;
+    __dmb();
+    memcpy(snapshot->copies[0], data, snapshot->size);
+    __dmb();
+
+    // ...e voltam para copies[0] enquanto copies[1] é atualizada
+    snapshot->seq++;
+    __dmb();
+    memcpy(snapshot->copies[1], data, snapshot->size);
+    __dmb();
+}
+
+uint32_t snapshot_read(const snapshot_t *snapshot, void *out)
+{
+    uint32_t seq;
+    do
+    {
+        seq = snapshot->seq;
+        __dmb();
+        memcpy(out, snapshot->copies[seq & 1], snapshot->size);
+        __dmb();
+    } while (snapshot->seq != seq);
+
+    return seq >> 1;
+}
@@ -0,0 +1,33 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Publicação de instantâneos consistentes com um único escritor e leitores em qualquer
+// contexto (interrupções, callbacks da pilha de rede ou o outro núcleo), sem travas nem
+// desabilitar interrupções.
+//
+// Usa duas cópias e um contador de sequência (seqlock com "latch"): o bit menos significativo
+// do contador indica a cópia estável. O escritor atualiza primeiro a cópia que os leitores não
+// estão usando e depois a outra, de modo que sempre há uma cópia íntegra. Um leitor só repete a
+// leitura se o escritor avançar durante a cópia, o que não acontece quando o leitor interrompe
+// o escritor no mesmo núcleo, então a leitura em interrupção nunca fica presa.
+
+typedef struct {
+    volatile uint32_t seq; // Par: leitores usam copies[0]; ímpar: copies[1]
+    size_t size;
+    void *copies[2];
+} snapshot_t;
+
+// Associa as duas áreas de armazenamento (de size bytes cada) e publica initial
+// (se NULL, as áreas mantêm o conteúdo atual, ex.: zeradas por serem estáticas)
+void snapshot_init(snapshot_t *snapshot, void *copy0, void *copy1, size_t size, const void *initial);
+
+// Publica uma nova versão. Deve haver um único escritor.
+void snapshot_publish(snapshot_t *snapshot, const void *data);
+
+// Copia a versão mais recente para out e retorna seu número de versão
+uint32_t snapshot_read(const snapshot_t *snapshot, void *out);
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,215 @@
+#include <math.h>
+#include <string.h>
+#include "stats.h"
+
+#define STATS_SLOTS (STATS_BUCKETS + 1)
+
+static const uint32_t default_windows_s[STATS_WINDOWS] = STATS_WINDOWS_S;
+
+static stats_bucket_t *slot(stats_window_t *window, uint32_t bucket)
+{
+    return &window->slots[bucket % STATS_SLOTS];
+}
+
+static const stats_bucket_t *slot_const(const stats_window_t *window, uint32_t bucket)
+{
+    return &window->slots[bucket % STATS_SLOTS];
+}
+
+static uint32_t deque_front(const stats_deque_t *deque)
+{
+    return deque->buckets[deque->head];
+}
+
+static uint32_t deque_back(const stats_deque_t *deque)
+{
+    return deque->buckets[(deque->head + deque->len - 1) % STATS_BUCKETS];
+}
+
+// Insere um balde completo, descartando do fim os que nunca mais serão o extremo da janela
+static void deque_push(stats_window_t *window, stats_deque_t *deque, uint32_t bucket, int metric, bool is_max)
+{
+    int32_t value = is_max ? slot(window, bucket)->metrics[metric].max : slot(window, bucket)->metrics[metric].min;
+    while (deque->len > 0)
+    {
+        int32_t back = is_max ? slot(window, deque_back(deque))->metrics[metric].max
+                              : slot(window, deque_back(deque))->metrics[metric].min;
+        if (is_max ? back > value : back < value)
+            break;
+        deque->len--;
+    }
+    deque->buckets[(deque->head + deque->len) % STATS_BUCKETS] = bucket;
+    deque->len++;
+}
+
+static void deque_expire(stats_deque_t *deque, uint32_t bucket)
+{
+    if (deque->len > 0 && deque_front(deque) == bucket)
+    {
+        deque->head = (deque->head + 1) % STATS_BUCKETS;
+        deque->len--;
+    }
+}
+
+static void accumulate(stats_bucket_t *total, const stats_bucket_t *bucket, int sign)
+{
+    total->count += sign * (int32_t)bucket->count;
+    total->sum_t += sign * bucket->sum_t;
+    total->sum_tt += sign * bucket->sum_tt;
+    for (int m = 0; m < STATS_METRICS; m++)
+    {
+        total->metrics[m].sum += sign * bucket->metrics[m].sum;
+        total->metrics[m].sumsq += sign * bucket->metrics[m].sumsq;
+        total->metrics[m].sum_tv += sign * bucket->metrics[m].sum_tv;
+    }
+}
+
+static void window_reset(stats_window_t *window, uint32_t bucket)
+{
+    memset(window->slots, 0, sizeof(window->slots));
+    memset(&window->total, 0, sizeof(window->total));
+    memset(window->min_deque, 0, sizeof(window->min_deque));
+    memset(window->max_deque, 0, sizeof(window->max_deque));
+    window->current = bucket;
+    window->started = true;
+}
+
+// Fecha o balde em andamento e abre o seguinte: o balde que sai da janela é subtraído dos
+// totais e das filas, e o fechado é somado. Custo constante (amortizado nas filas).
+static void window_advance(stats_window_t *window)
+{
+    // O balde que sai da janela (closed - STATS_BUCKETS) ocupa o slot do próximo; o slot é
+    // calculado a partir de closed para não depender da volta do contador no início
+    uint32_t closed = window->current;
+    uint32_t expired = closed - STATS_BUCKETS;
+    const stats_bucket_t *old = slot(window, closed + 1);
+
+    if (old->count > 0)
+    {
+        accumulate(&window->total, old, -1);
+        for (int m = 0; m < STATS_METRICS; m++)
+        {
+            deque_expire(&window->min_deque[m], expired);
+            deque_expire(&window->max_deque[m], expired);
+        }
+    }
+
+    const stats_bucket_t *done = slot(window, closed);
+    if (done->count > 0)
+    {
+        accumulate(&window->total, done, 1);
+        for (int m = 0; m < STATS_METRICS; m++)
+        {
+            deque_push(window, &window->min_deque[m], closed, m, false);
+            deque_push(window, &window->max_deque[m], closed, m, true);
+        }
+    }
+
+    window->current = closed + 1;
+    memset(slot(window, window->current), 0, sizeof(stats_bucket_t));
+}
+
+void stats_init(stats_t *stats, const uint32_t window_s[STATS_WINDOWS])
+{
+    memset(stats, 0, sizeof(*stats));
+    for (int w = 0; w < STATS_WINDOWS; w++)
+    {
+        uint32_t seconds = window_s ? window_s[w] : default_windows_s[w];
+        if (seconds < STATS_BUCKETS)
+            seconds = STATS_BUCKETS; // Baldes de pelo menos 1 s
+        stats->windows[w].window_s = seconds;
+        stats->windows[w].bucket_ms = seconds * 1000u / STATS_BUCKETS;
+    }
+}
+
+void stats_add(stats_t *stats, uint32_t now_ms, const int32_t values[STATS_METRICS])
+{
+    int64_t t = now_ms / 1000u;
+
+    for (int w = 0; w < STATS_WINDOWS; w++)
+    {
+        stats_window_t *window = &stats->windows[w];
+        uint32_t bucket = now_ms / window->bucket_ms;
+
+        // Uma pausa maior que a janela inteira descarta tudo
+        if (!window->started || bucket - window->current > STATS_BUCKETS)
+            window_reset(window, bucket);
+        while (window->current != bucket)
+            window_advance(window);
+
+        stats_bucket_t *current = slot(window, bucket);
+        current->count++;
+        current->sum_t += t;
+        current->sum_tt += t * t;
+        for (int m = 0; m < STATS_METRICS; m++)
+        {
+            stats_moment_t *moment = &current->metrics[m];
+            int32_t value = values[m];
+            if (current->count == 1 || value < moment->min)
+                moment->min = value;
+            if (current->count == 1 || value > moment->max)
+                moment->max = value;
+            moment->sum += value;
+            moment->sumsq += (int64_t)value * value;
+            moment->sum_tv += t * value;
+        }
+    }
+}
+
+void stats_summary(const stats_t *stats, int window_index, stats_window_summary_t *summary)
+{
+    const stats_window_t *window = &stats->windows[window_index];
+    const stats_bucket_t *current = slot_const(window, window->current);
+
+    memset(summary, 0, sizeof(*summary));
+    summary->window_s = window->window_s;
+    if (!window->started)
+        return;
+
+    stats_bucket_t total = window->total;
+    accumulate(&total, current, 1);
+    summary->count = total.count;
+    if (total.count == 0)
+        return;
+
+    // Somas centradas em double: os momentos inteiros são exatos, a subtração é feita uma única vez
+    double n = total.count;
+    double sxx = (double)total.sum_tt - (double)total.sum_t * (double)total.sum_t / n;
+
+    for (int m = 0; m < STATS_METRICS; m++)
+    {
+        const stats_moment_t *moment = &total.metrics[m];
+        stats_metric_summary_t *out = &summary->metrics[m];
+        bool have_min = false, have_max = false;
+
+        if (current->count > 0)
+        {
+            out->min = current->metrics[m].min;
+            out->max = current->metrics[m].max;
+            have_min = have_max = true;
+        }
+        if (window->min_deque[m].len > 0)
+        {
+            int32_t min = slot_const(window, deque_front(&window->min_deque[m]))->metrics[m].min;
+            out->min = have_min && out->min < min ? out->min : min;
+        }
+        if (window->max_deque[m].len > 0)
+        {
+            int32_t max = slot_const(window, deque_front(&window->max_deque[m]))->metrics[m].max;
+            out->max = have_max && out->max > max ? out->max : max;
+        }
+
+        double mean = (double)moment->sum / n;
+        out->mean = (float)mean;
+        if (total.count > 1)
+        {
+            double var = ((double)moment->sumsq - (double)moment->sum * mean) / (n - 1);
+            out->stddev = var > 0 ? (float)sqrt(var) : 0.0f;
+        }
+        if (sxx > 0)
+        {
+            double sxy = (double)moment->sum_tv - (double)total.sum_t * mean;
+            out->slope_per_hour = (float)(sxy / sxx * 3600.0);
+        }
+    }
+}
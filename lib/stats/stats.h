@@ -0,0 +1,89 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Estatísticas em janelas deslizantes (ex.: 1 min, 1 h e 24 h) por grandeza, com custo constante
+// por amostra. Cada janela é dividida em STATS_BUCKETS baldes com momentos inteiros exatos
+// (contagem, soma, soma dos quadrados e somas da regressão); os totais dos baldes completos são
+// mantidos incrementalmente (o balde que sai da janela é subtraído). Mínimo e máximo vêm de filas
+// monotônicas sobre os extremos dos baldes. A janela cobre os últimos STATS_BUCKETS baldes
+// completos mais o balde em andamento.
+// Valores em centésimos de °C, centésimos de % e Pa.
+
+#define STATS_WINDOWS 3  // Janelas simultâneas
+#define STATS_METRICS 3  // Temperatura, umidade e pressão
+#define STATS_BUCKETS 24 // Baldes completos por janela
+
+#ifndef STATS_WINDOWS_S
+#define STATS_WINDOWS_S {60, 3600, 86400} // Janelas padrão, em segundos
+#endif
+
+typedef enum {
+    STATS_METRIC_TEMPERATURE,
+    STATS_METRIC_HUMIDITY,
+    STATS_METRIC_PRESSURE,
+} stats_metric_t;
+
+typedef struct {
+    int64_t sum;
+    int64_t sumsq;
+    int64_t sum_tv; // Soma de tempo × valor (regressão)
+    int32_t min;
+    int32_t max;
+} stats_moment_t;
+
+typedef struct {
+    uint32_t count;
+    int64_t sum_t;  // Soma dos instantes, em s desde o boot
+    int64_t sum_tt;
+    stats_moment_t metrics[STATS_METRICS];
+} stats_bucket_t;
+
+// Fila monotônica de números de balde (o extremo de cada um fica no próprio balde)
+typedef struct {
+    uint32_t buckets[STATS_BUCKETS];
+    uint8_t head;
+    uint8_t len;
+} stats_deque_t;
+
+typedef struct {
+    uint32_t window_s;
+    uint32_t bucket_ms;
+    uint32_t current;   // Número do balde em andamento
+    bool started;
+    stats_bucket_t slots[STATS_BUCKETS + 1];
+    stats_bucket_t total; // Soma dos baldes completos na janela (min e max não usados)
+    stats_deque_t min_deque[STATS_METRICS];
+    stats_deque_t max_deque[STATS_METRICS];
+} stats_window_t;
+
+typedef struct {
+    stats_window_t windows[STATS_WINDOWS];
+} stats_t;
+
+typedef struct {
+    int32_t min;
+    int32_t max;
+    float mean;
+    float stddev;
+    float slope_per_hour; // Tendência por mínimos quadrados, em unidades por hora
+} stats_metric_summary_t;
+
+typedef struct {
+    uint32_t window_s;
+    uint32_t count;       // Amostras na janela (sem amostras, os demais campos são zero)
+    stats_metric_summary_t metrics[STATS_METRICS];
+} stats_window_summary_t;
+
+// Inicia as janelas (em segundos, até 49 dias; NULL usa STATS_WINDOWS_S)
+void stats_init(stats_t *stats, const uint32_t window_s[STATS_WINDOWS]);
+
+// Acrescenta uma amostra a todas as janelas
+void stats_add(stats_t *stats, uint32_t now_ms, const int32_t values[STATS_METRICS]);
+
+// Resume uma janela
+void stats_summary(const stats_t *stats, int window, stats_window_summary_t *summary);
+
+#endif // STATS_H
@@ -0,0 +1,198 @@
+#include <stdatomic.h>
+#include <string.h>
+#include "trace.h"
+
+static const uint8_t magic[4] = {'W', 'X', 'T', '1'};
+
+static void put_u32(uint8_t *out, uint32_t value)
+{
+    out[0] = value;
+    out[1] = value >> 8;
+    out[2] = value >> 16;
+    out[3] = value >> 24;
+}
+
+static uint32_t get_u32(const uint8_t *in)
+{
+    return in[0] | (uint32_t)in[1] << 8 | (uint32_t)in[2] << 16 | (uint32_t)in[3] << 24;
+}
+
+static uint8_t *slot(trace_t *trace, uint16_t index)
+{
+    return &trace->frames[(uint32_t)((trace->head + index) % TRACE_FRAMES) * TRACE_FRAME_SIZE];
+}
+
+void trace_init(trace_t *trace)
+{
+    memset(trace, 0, sizeof(*trace));
+    trace->mode = TRACE_IDLE;
+}
+
+void trace_start_record(trace_t *trace, const uint8_t calib[TRACE_CALIB_SIZE], uint32_t now_ms)
+{
+    trace->mode = TRACE_IDLE;
+    trace->count = 0;
+    trace->head = 0;
+    trace->dropped = 0;
+    trace->imported = 0;
+
+    memcpy(trace->header, magic, sizeof(magic));
+    trace->header[4] = TRACE_VERSION;
+    trace->header[5] = TRACE_FRAME_SIZE;
+    trace->header[6] = 0;
+    trace->header[7] = 0;
+    put_u32(&trace->header[8], now_ms);
+    memcpy(&trace->header[12], calib, TRACE_CALIB_SIZE);
+    trace->mode = TRACE_RECORDING;
+}
+
+void trace_record(trace_t *trace, const trace_frame_t *frame)
+{
+    if (trace->mode != TRACE_RECORDING)
+        return;
+
+    // trace_export pode rodar em interrupção no meio desta função: o quadro mais antigo sai da
+    // contagem antes de ser sobrescrito e o novo só entra depois de escrito
+    if (trace->count == TRACE_FRAMES)
+    {
+        trace->count--;
+        atomic_signal_fence(memory_order_seq_cst);
+        trace->head = (trace->head + 1) % TRACE_FRAMES;
+        trace->dropped++;
+    }
+    atomic_signal_fence(memory_order_seq_cst);
+
+    uint8_t *out = slot(trace, trace->count);
+    put_u32(out, frame->time_ms);
+    out[4] = frame->flags;
+    memcpy(&out[5], frame->bmp, sizeof(frame->bmp));
+    memcpy(&out[11], frame->aht, sizeof(frame->aht));
+
+    atomic_signal_fence(memory_order_seq_cst);
+    trace->count++;
+}
+
+bool trace_start_replay(trace_t *trace, trace_speed_t speed, uint64_t now_us)
+{
+    if (trace->count == 0)
+        return false;
+
+    trace->speed = speed;
+    trace->cursor = 0;
+    trace->replayed = 0;
+    trace->busy_us = 0;
+    trace->max_frame_us = 0;
+    trace->started_us = now_us;
+    trace->finished_us = 0;
+    trace->mode = TRACE_REPLAYING;
+    return true;
+}
+
+bool trace_next(trace_t *trace, trace_frame_t *frame, uint64_t now_us)
+{
+    if (trace->mode != TRACE_REPLAYING)
+        return false;
+    if (trace->cursor >= trace->count)
+    {
+        trace_stop(trace, now_us);
+        return false;
+    }
+
+    const uint8_t *in = slot(trace, trace->cursor++);
+    frame->time_ms = get_u32(in);
+    frame->flags = in[4];
+    memcpy(frame->bmp, &in[5], sizeof(frame->bmp));
+    memcpy(frame->aht, &in[11], sizeof(frame->aht));
+    return true;
+}
+
+uint32_t trace_next_interval_ms(const trace_t *trace)
+{
+    if (trace->speed == TRACE_SPEED_MAX || trace->cursor == 0 || trace->cursor >= trace->count)
+        return 0;
+
+    uint32_t last = get_u32(slot((trace_t *)trace, trace->cursor - 1));
+    uint32_t next = get_u32(slot((trace_t *)trace, trace->cursor));
+    return next - last;
+}
+
+void trace_note_processed(trace_t *trace, uint32_t elapsed_us)
+{
+    trace->replayed++;
+    trace->busy_us += elapsed_us;
+    if (elapsed_us > trace->max_frame_us)
+        trace->max_frame_us = elapsed_us;
+}
+
+void trace_stop(trace_t *trace, uint64_t now_us)
+{
+    if (trace->mode == TRACE_REPLAYING)
+        trace->finished_us = now_us;
+    trace->mode = TRACE_IDLE;
+}
+
+const uint8_t *trace_calib(const trace_t *trace)
+{
+    return &trace->header[12];
+}
+
+size_t trace_export(const trace_t *trace, uint8_t *out, size_t room)
+{
+    uint16_t count = trace->count;
+    uint16_t head = trace->head;
+    size_t len = TRACE_HEADER_SIZE + (size_t)count * TRACE_FRAME_SIZE;
+    if (len > room)
+        return 0;
+
+    memcpy(out, trace->header, TRACE_HEADER_SIZE);
+    out += TRACE_HEADER_SIZE;
+
+    // Até duas partes contíguas: do mais antigo ao fim do buffer e do início ao mais novo
+    uint16_t first = count < TRACE_FRAMES - head ? count : TRACE_FRAMES - head;
+    memcpy(out, &trace->frames[(uint32_t)head * TRACE_FRAME_SIZE], (size_t)first * TRACE_FRAME_SIZE);
+    memcpy(out + (size_t)first * TRACE_FRAME_SIZE, trace->frames, (size_t)(count - first) * TRACE_FRAME_SIZE);
+    return len;
+}
+
+static bool import_fail(trace_t *trace)
+{
+    trace->imported = 0;
+    trace->count = 0;
+    return false;
+}
+
+bool trace_import(trace_t *trace, uint32_t offset, const uint8_t *data, size_t len)
+{
+    if (trace->mode != TRACE_IDLE)
+        return false;
+    if (offset == 0)
+    {
+        trace->head = 0;
+        trace->count = 0;
+        trace->dropped = 0;
+        trace->imported = 0;
+    }
+    if (offset != trace->imported)
+        return false;
+    if (len > TRACE_EXPORT_SIZE - offset)
+        return import_fail(trace);
+
+    uint32_t end = offset + len;
+    if (offset < TRACE_HEADER_SIZE)
+    {
+        size_t part = end < TRACE_HEADER_SIZE ? len : TRACE_HEADER_SIZE - offset;
+        memcpy(&trace->header[offset], data, part);
+        data += part;
+        len -= part;
+        if (end >= TRACE_HEADER_SIZE &&
+            (memcmp(trace->header, magic, sizeof(magic)) != 0 || trace->header[4] != TRACE_VERSION ||
+             trace->header[5] != TRACE_FRAME_SIZE))
+            return import_fail(trace);
+    }
+    if (len)
+        memcpy(&trace->frames[end - len - TRACE_HEADER_SIZE], data, len);
+
+    trace->imported = end;
+    trace->count = end > TRACE_HEADER_SIZE ? (end - TRACE_HEADER_SIZE) / TRACE_FRAME_SIZE : 0;
+    return true;
+}
@@ -0,0 +1,103 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Gravação e reprodução das leituras brutas dos sensores. Cada amostra vira um quadro de
+// TRACE_FRAME_SIZE bytes com o instante, os 6 registradores de dados do BMP280 e os 7 bytes de
+// resultado do AHT20 (com o CRC); o cabeçalho guarda a calibração do BMP280, de modo que um trace
+// gravado em uma placa pode ser reproduzido em outra passando pela mesma compensação. A gravação é circular: com o
+// buffer cheio, o quadro mais antigo dá lugar ao novo.
+//
+// Formato exportado (inteiros little-endian):
+//   cabeçalho: "WXT1", versão (1 byte), TRACE_FRAME_SIZE (1 byte), 2 bytes reservados,
+//              início da gravação em ms desde o boot (4 bytes), calibração do BMP280 (24 bytes)
+//   quadros:   instante em ms (4 bytes), flags (1 byte), BMP280 (6 bytes), AHT20 (7 bytes)
+
+#define TRACE_VERSION 2 // 2: resultado do AHT20 com o byte de CRC
+#define TRACE_HEADER_SIZE 36
+#define TRACE_FRAME_SIZE 18
+#define TRACE_FRAMES 1024      // ~18 KB: o trace inteiro cabe em uma resposta HTTP
+#define TRACE_CALIB_SIZE 24
+#define TRACE_AHT_SIZE 7       // AHT20_RESULT_SIZE
+#define TRACE_EXPORT_SIZE (TRACE_HEADER_SIZE + TRACE_FRAMES * TRACE_FRAME_SIZE)
+
+// Flags de um quadro: leitura concluída no barramento (o conteúdo ainda pode indicar sensor ocupado)
+#define TRACE_FRAME_BMP_VALID 0x01
+#define TRACE_FRAME_AHT_VALID 0x02
+
+typedef struct {
+    uint32_t time_ms;
+    uint8_t flags;
+    uint8_t bmp[6];
+    uint8_t aht[TRACE_AHT_SIZE];
+} trace_frame_t;
+
+typedef enum {
+    TRACE_IDLE,
+    TRACE_RECORDING,
+    TRACE_REPLAYING,
+} trace_mode_t;
+
+typedef enum {
+    TRACE_SPEED_REALTIME,  // Intervalos originais entre os quadros
+    TRACE_SPEED_MAX,       // Quadros em sequência, sem espera
+} trace_speed_t;
+
+typedef struct {
+    volatile trace_mode_t mode;
+    trace_speed_t speed;
+    uint8_t header[TRACE_HEADER_SIZE];
+    uint8_t frames[TRACE_FRAMES * TRACE_FRAME_SIZE];
+    volatile uint16_t head;     // Quadro mais antigo
+    volatile uint16_t count;    // Quadros gravados
+    uint16_t cursor;            // Próximo quadro da reprodução (0 = mais antigo)
+    uint32_t imported;          // Bytes recebidos por trace_import
+    uint32_t dropped;           // Quadros sobrescritos na gravação
+
+    // Medidas da última reprodução
+    uint32_t replayed;
+    uint64_t started_us;
+    uint64_t finished_us;
+    uint64_t busy_us;           // Soma do processamento dos quadros
+    uint32_t max_frame_us;
+} trace_t;
+
+void trace_init(trace_t *trace);
+
+// Descarta o trace e começa a gravar; calib são os registradores de calibração do BMP280
+void trace_start_record(trace_t *trace, const uint8_t calib[TRACE_CALIB_SIZE], uint32_t now_ms);
+
+// Acrescenta um quadro (só durante a gravação)
+void trace_record(trace_t *trace, const trace_frame_t *frame);
+
+// Começa a reproduzir desde o quadro mais antigo. Retorna false se não houver quadros.
+bool trace_start_replay(trace_t *trace, trace_speed_t speed, uint64_t now_us);
+
+// Próximo quadro da reprodução. No fim, volta ao modo ocioso e retorna false.
+bool trace_next(trace_t *trace, trace_frame_t *frame, uint64_t now_us);
+
+// Intervalo original entre o último quadro entregue e o seguinte (0 no fim ou em TRACE_SPEED_MAX)
+uint32_t trace_next_interval_ms(const trace_t *trace);
+
+// Contabiliza o processamento de um quadro reproduzido
+void trace_note_processed(trace_t *trace, uint32_t elapsed_us);
+
+// Interrompe a gravação ou a reprodução
+void trace_stop(trace_t *trace, uint64_t now_us);
+
+// Calibração do BMP280 do cabeçalho
+const uint8_t *trace_calib(const trace_t *trace);
+
+// Grava o trace no formato exportado, do quadro mais antigo ao mais novo. Retorna o tamanho, ou 0 se
+// room não bastar. Pode ser chamada durante a gravação (o quadro em escrita não entra).
+size_t trace_export(const trace_t *trace, uint8_t *out, size_t room);
+
+// Recebe um trace exportado em partes sequenciais: offset 0 recomeça; offset deve ser igual ao total
+// já recebido. Só no modo ocioso. Retorna false se a parte estiver fora de ordem, não couber ou o
+// cabeçalho for inválido (o trace recebido até então é descartado).
+bool trace_import(trace_t *trace, uint32_t offset, const uint8_t *data, size_t len);
+
+#endif // TRACE_H
@@ -0,0 +1,151 @@
+#include <string.h>
+#include "tsdb.h"
+
+// Larguras dos campos após os prefixos '10', '110', '1110' e '1111' ('0' = zero)
+static const uint8_t time_widths[4] = {7, 9, 12, 32};
+static const uint8_t value_widths[4] = {4, 8, 16, 32};
+
+static uint32_t zigzag(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value)
+{
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+// Faixa do código: -1 para zero, 0 a 3 para as larguras da tabela
+static int bucket(uint32_t value, const uint8_t widths[4])
+{
+    if (value == 0)
+        return -1;
+    for (int i = 0; i < 3; i++)
+    {
+        if (value < (1u << widths[i]))
+            return i;
+    }
+    return 3;
+}
+
+static uint32_t encoded_bits(uint32_t value, const uint8_t widths[4])
+{
+    int b = bucket(value, widths);
+    if (b < 0)
+        return 1;
+    return (uint32_t)(b < 3 ? b + 2 : 4) + widths[b];
+}
+
+// Escreve os n bits menos significativos de value (MSB primeiro)
+static void put_bits(tsdb_block_t *block, uint32_t value, uint8_t n)
+{
+    while (n--)
+    {
+        if ((value >> n) & 1)
+            block->data[block->bit_len >> 3] |= (uint8_t)(0x80 >> (block->bit_len & 7));
+        block->bit_len++;
+    }
+}
+
+static uint32_t get_bits(tsdb_decoder_t *decoder, uint8_t n)
+{
+    uint32_t value = 0;
+    while (n--)
+    {
+        uint32_t pos = decoder->bit_pos++;
+        value = (value << 1) | ((decoder->block->data[pos >> 3] >> (7 - (pos & 7))) & 1);
+    }
+    return value;
+}
+
+static void put_code(tsdb_block_t *block, uint32_t value, const uint8_t widths[4])
+{
+    int b = bucket(value, widths);
+    if (b < 0)
+    {
+        put_bits(block, 0, 1);
+        return;
+    }
+
+    // Prefixo unário: '10', '110', '1110' ou '1111'
+    if (b < 3)
+        put_bits(block, (0xFu >> (3 - b)) << 1, (uint8_t)(b + 2));
+    else
+        put_bits(block, 0xF, 4);
+    put_bits(block, value, widths[b]);
+}
+
+static uint32_t get_code(tsdb_decoder_t *decoder, const uint8_t widths[4])
+{
+    int b = 0;
+    if (!get_bits(decoder, 1))
+        return 0;
+    while (b < 3 && get_bits(decoder, 1))
+        b++;
+    return get_bits(decoder, widths[b]);
+}
+
+void tsdb_block_init(tsdb_block_t *block, uint32_t first_seq, const tsdb_point_t *first)
+{
+    block->first_seq = first_seq;
+    block->count = 1;
+    block->bit_len = 0;
+    block->first = *first;
+    block->last = *first;
+    block->last_delta_t = 0;
+    memset(block->data, 0, sizeof(block->data));
+}
+
+bool tsdb_block_append(tsdb_block_t *block, const tsdb_point_t *point)
+{
+    int32_t delta_t = (int32_t)(point->time_ms - block->last.time_ms);
+    uint32_t time_code = zigzag(delta_t - block->last_delta_t);
+    uint32_t value_codes[TSDB_CHANNELS];
+
+    // Calcula o tamanho exato antes de escrever, para não deixar um ponto pela metade
+    uint32_t bits = encoded_bits(time_code, time_widths);
+    for (int i = 0; i < TSDB_CHANNELS; i++)
+    {
+        value_codes[i] = zigzag(point->values[i] - block->last.values[i]);
+        bits += encoded_bits(value_codes[i], value_widths);
+    }
+    if (block->bit_len + bits > TSDB_BLOCK_BYTES * 8 || block->count == UINT16_MAX)
+        return false;
+
+    put_code(block, time_code, time_widths);
+    for (int i = 0; i < TSDB_CHANNELS; i++)
+        put_code(block, value_codes[i], value_widths);
+
+    block->last = *point;
+    block->last_delta_t = delta_t;
+    block->count++;
+    return true;
+}
+
+void tsdb_decoder_init(tsdb_decoder_t *decoder, const tsdb_block_t *block)
+{
+    decoder->block = block;
+    decoder->bit_pos = 0;
+    decoder->index = 0;
+    decoder->prev = block->first;
+    decoder->prev_delta_t = 0;
+}
+
+bool tsdb_decoder_next(tsdb_decoder_t *decoder, tsdb_point_t *point)
+{
+    const tsdb_block_t *block = decoder->block;
+    if (decoder->index >= block->count)
+        return false;
+
+    if (decoder->index > 0)
+    {
+        decoder->prev_delta_t += unzigzag(get_code(decoder, time_widths));
+        decoder->prev.time_ms += (uint32_t)decoder->prev_delta_t;
+        for (int i = 0; i < TSDB_CHANNELS; i++)
+            decoder->prev.values[i] += unzigzag(get_code(decoder, value_widths));
+    }
+
+    decoder->index++;
+    *point = decoder->prev;
+    return true;
+}
@@ -0,0 +1,54 @@
+#ifndef TSDB_H
+#define TSDB_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Compressão de séries temporais em blocos (estilo Gorilla). Cada bloco guarda o primeiro
+// ponto sem compressão no cabeçalho e os seguintes em um fluxo de bits:
+// - instante: delta-do-delta em zigzag, com prefixo de tamanho variável (1 bit se o
+//   intervalo não mudou);
+// - canais: delta em relação ao ponto anterior em zigzag, com prefixo de tamanho
+//   variável (1 bit se o valor não mudou).
+// Os blocos são independentes: uma consulta por intervalo decodifica apenas os blocos
+// que cobrem o trecho pedido.
+
+#define TSDB_CHANNELS    3    // Valores inteiros por ponto
+#define TSDB_BLOCK_BYTES 1024 // Tamanho do fluxo de bits de um bloco
+
+typedef struct {
+    uint32_t time_ms;
+    int32_t values[TSDB_CHANNELS];
+} tsdb_point_t;
+
+typedef struct {
+    uint32_t first_seq;   // Sequência do primeiro ponto
+    uint16_t count;       // Pontos no bloco (inclui o primeiro)
+    uint16_t bit_len;     // Bits usados em data
+    tsdb_point_t first;   // Primeiro ponto, sem compressão
+    tsdb_point_t last;    // Último ponto (estado do codificador e limite da consulta)
+    int32_t last_delta_t; // Último intervalo entre instantes
+    uint8_t data[TSDB_BLOCK_BYTES];
+} tsdb_block_t;
+
+// Decodificador incremental de um bloco
+typedef struct {
+    const tsdb_block_t *block;
+    uint32_t bit_pos;
+    uint16_t index;       // Próximo ponto a decodificar
+    tsdb_point_t prev;
+    int32_t prev_delta_t;
+} tsdb_decoder_t;
+
+// Inicia um bloco com seu primeiro ponto
+void tsdb_block_init(tsdb_block_t *block, uint32_t first_seq, const tsdb_point_t *first);
+
+// Acrescenta um ponto. Retorna false se não couber (o chamador deve iniciar outro bloco).
+bool tsdb_block_append(tsdb_block_t *block, const tsdb_point_t *point);
+
+void tsdb_decoder_init(tsdb_decoder_t *decoder, const tsdb_block_t *block);
+
+// Decodifica o próximo ponto. Retorna false ao fim do bloco.
+bool tsdb_decoder_next(tsdb_decoder_t *decoder, tsdb_point_t *point);
+
+#endif // TSDB_H
@@ -0,0 +1,88 @@
+#include <string.h>
+#include "wallclock.h"
+
+void wallclock_init(wallclock_t *clock)
+{
+    memset(clock, 0, sizeof(*clock));
+}
+
+// Reta de referência: hora da última referência mais o tempo decorrido com a correção de frequência
+static int64_t line_us(const wallclock_t *clock, uint64_t mono_us)
+{
+    int64_t elapsed = (int64_t)(mono_us - clock->base_mono_us);
+    return clock->base_unix_us + elapsed + elapsed * clock->freq_ppb / 1000000000;
+}
+
+int64_t wallclock_unix_us(const wallclock_t *clock, uint64_t mono_us)
+{
+    if (!clock->synced)
+        return 0;
+
+    // O erro de fase da referência diminui a WALLCLOCK_SLEW_PPB até zerar
+    int64_t elapsed = (int64_t)(mono_us - clock->base_mono_us);
+    int64_t absorbed = elapsed > 0 ? elapsed * WALLCLOCK_SLEW_PPB / 1000000000 : 0;
+    int64_t residual = clock->residual_us;
+    if (residual > absorbed)
+        residual -= absorbed;
+    else if (residual < -absorbed)
+        residual += absorbed;
+    else
+        residual = 0;
+    return line_us(clock, mono_us) + residual;
+}
+
+void wallclock_sync(wallclock_t *clock, uint64_t mono_us, int64_t unix_us)
+{
+    if (!clock->synced)
+    {
+        clock->synced = true;
+        clock->freq_anchor_us = mono_us;
+        clock->freq_error_us = 0;
+        clock->residual_us = 0;
+        clock->last_offset_us = 0;
+        clock->steps++;
+    }
+    else
+    {
+        int64_t shown = wallclock_unix_us(clock, mono_us);
+        int64_t offset = unix_us - shown;
+        clock->last_offset_us = offset;
+
+        if (offset > WALLCLOCK_STEP_US || offset < -WALLCLOCK_STEP_US)
+        {
+            // Salto: a estimativa de frequência recomeça (a referência pode ter mudado de fonte)
+            clock->residual_us = 0;
+            clock->freq_anchor_us = mono_us;
+            clock->freq_error_us = 0;
+            clock->steps++;
+        }
+        else
+        {
+            // A hora mostrada continua de onde estava; a diferença é absorvida aos poucos
+            clock->residual_us = shown - unix_us;
+
+            // O erro da reta só depende da frequência: acumulado por uma janela longa, o ruído da
+            // rede pesa pouco na estimativa
+            clock->freq_error_us += unix_us - line_us(clock, mono_us);
+            uint64_t span = mono_us - clock->freq_anchor_us;
+            if (span >= WALLCLOCK_FREQ_SPAN_US)
+            {
+                // Primeira estimativa inteira; depois, metade do erro medido (filtra o ruído)
+                int64_t error_ppb = clock->freq_error_us * 1000000000 / (int64_t)span;
+                int64_t freq = clock->freq_ppb + (clock->freq_estimated ? error_ppb / 2 : error_ppb);
+                if (freq > WALLCLOCK_MAX_FREQ_PPB)
+                    freq = WALLCLOCK_MAX_FREQ_PPB;
+                else if (freq < -WALLCLOCK_MAX_FREQ_PPB)
+                    freq = -WALLCLOCK_MAX_FREQ_PPB;
+                clock->freq_ppb = (int32_t)freq;
+                clock->freq_estimated = true;
+                clock->freq_anchor_us = mono_us;
+                clock->freq_error_us = 0;
+            }
+        }
+    }
+
+    clock->base_mono_us = mono_us;
+    clock->base_unix_us = unix_us;
+    clock->syncs++;
+}
@@ -0,0 +1,47 @@
+#ifndef WALLCLOCK_H
+#define WALLCLOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Relógio de parede disciplinado por referências externas (SNTP). Converte o tempo monotônico
+// (µs desde o boot) em hora Unix a partir da última referência, corrigindo a frequência do cristal
+// pelo erro acumulado entre referências (um FLL simples). Erros de fase pequenos são absorvidos aos
+// poucos, a no máximo WALLCLOCK_SLEW_PPB, de modo que a hora nunca volta atrás; a primeira referência
+// e erros acima de WALLCLOCK_STEP_US ajustam a hora de uma vez.
+// Só inteiros: o produto de um intervalo em µs pela correção em ppb cabe em 64 bits por semanas.
+
+#define WALLCLOCK_STEP_US 128000          // Erro a partir do qual a hora salta (limiar do NTP)
+#define WALLCLOCK_SLEW_PPB 500000         // Taxa máxima de absorção de um erro de fase (500 ppm)
+#define WALLCLOCK_MAX_FREQ_PPB 500000     // Correção máxima de frequência (500 ppm)
+#ifndef WALLCLOCK_FREQ_SPAN_US
+#define WALLCLOCK_FREQ_SPAN_US 1800000000ULL // Janela mínima para estimar a frequência (30 min)
+#endif
+
+typedef struct {
+    bool synced;
+    uint64_t base_mono_us;      // Instante monotônico da última referência
+    int64_t base_unix_us;       // Hora Unix da referência nesse instante
+    int64_t residual_us;        // Erro de fase na referência, absorvido a partir de base_mono_us
+    int32_t freq_ppb;           // Correção de frequência (positiva: o cristal atrasa)
+
+    // Estimativa de frequência: erros da reta acumulados desde freq_anchor_us
+    uint64_t freq_anchor_us;
+    int64_t freq_error_us;
+    bool freq_estimated;
+
+    // Medidas
+    uint32_t syncs;             // Referências aceitas
+    uint32_t steps;             // Ajustes de uma vez (inclui a primeira referência)
+    int64_t last_offset_us;     // Referência menos a hora mostrada, na última sincronização
+} wallclock_t;
+
+void wallclock_init(wallclock_t *clock);
+
+// Aplica uma referência: a hora Unix unix_us valia no instante monotônico mono_us
+void wallclock_sync(wallclock_t *clock, uint64_t mono_us, int64_t unix_us);
+
+// Hora Unix em µs no instante monotônico mono_us, ou 0 antes da primeira referência
+int64_t wallclock_unix_us(const wallclock_t *clock, uint64_t mono_us);
+
+#endif // WALLCLOCK_H
@@ -0,0 +1,159 @@
+#include "pico/cyw43_arch.h"
+#include "pico/rand.h"
+#include "wifi_supervisor.h"
+
+static void set_state(wifi_supervisor_t *sup, wifi_state_t state)
+{
+    sup->state = state;
+    if (sup->callback)
+    {
+        sup->callback(state, sup->context);
+    }
+}
+
+// Encerra a tentativa atual e agenda a próxima após a espera exponencial
+static void fail_attempt(wifi_supervisor_t *sup)
+{
+    cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA); // Interrompe uma associação pendente
+    sup->failures++;
+
+    // Jitter: metade da espera é fixa e metade aleatória, para que estações que perderam
+    // o ponto de acesso ao mesmo tempo não tentem reconectar em sincronia
+    uint32_t half = sup->backoff_ms / 2;
+    uint32_t delay_ms = half + get_rand_32() % (half + 1);
+    sup->deadline = make_timeout_time_ms(delay_ms);
+
+    sup->backoff_ms = sup->backoff_ms >= WIFI_BACKOFF_MAX_MS / 2 ? WIFI_BACKOFF_MAX_MS : sup->backoff_ms * 2;
+    set_state(sup, WIFI_STATE_BACKOFF);
+}
+
+static void begin_attempt(wifi_supervisor_t *sup)
+{
+    sup->deadline = make_timeout_time_ms(WIFI_CONNECT_TIMEOUT_MS);
+    sup->next_poll = make_timeout_time_ms(WIFI_CONNECT_POLL_MS);
+    set_state(sup, WIFI_STATE_CONNECTING);
+
+    if (cyw43_arch_wifi_connect_async(sup->ssid, sup->password, sup->auth) != 0)
+    {
+        fail_attempt(sup);
+    }
+}
+
+void wifi_supervisor_init(wifi_supervisor_t *sup, const char *ssid, const char *password, uint32_t auth,
+                          wifi_state_callback_t callback, void *context)
+{
+    sup->ssid = ssid;
+    sup->password = password;
+    sup->auth = auth;
+    sup->state = WIFI_STATE_IDLE;
+    sup->deadline = at_the_end_of_time;
+    sup->next_poll = at_the_end_of_time;
+    sup->backoff_ms = WIFI_BACKOFF_MIN_MS;
+    sup->failures = 0;
+    sup->connects = 0;
+    sup->disconnects = 0;
+    sup->last_status = CYW43_LINK_DOWN;
+    sup->callback = callback;
+    sup->context = context;
+}
+
+void wifi_supervisor_start(wifi_supervisor_t *sup)
+{
+    if (sup->state == WIFI_STATE_IDLE)
+    {
+        begin_attempt(sup);
+    }
+}
+
+void wifi_supervisor_poll(wifi_supervisor_t *sup)
+{
+    switch (sup->state)
+    {
+    case WIFI_STATE_IDLE:
+        break;
+
+    case WIFI_STATE_CONNECTING:
+        if (!time_reached(sup->next_poll))
+            break;
+
+        sup->last_status = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA);
+        if (sup->last_status == CYW43_LINK_UP)
+        {
+            sup->failures = 0;
+            sup->backoff_ms = WIFI_BACKOFF_MIN_MS;
+            sup->connects++;
+            sup->next_poll = make_timeout_time_ms(WIFI_LINK_CHECK_MS);
+            set_state(sup, WIFI_STATE_CONNECTED);
+        }
+        else if (sup->last_status < 0 || time_reached(sup->deadline))
+        {
+            // CYW43_LINK_FAIL, CYW43_LINK_NONET, CYW43_LINK_BADAUTH ou prazo expirado
+            fail_attempt(sup);
+        }
+        else
+        {
+            sup->next_poll = make_timeout_time_ms(WIFI_CONNECT_POLL_MS);
+        }
+        break;
+
+    case WIFI_STATE_CONNECTED:
+        if (!time_reached(sup->next_poll))
+            break;
+
+        sup->last_status = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA);
+        if (sup->last_status != CYW43_LINK_UP)
+        {
+            // Queda do link: a primeira tentativa é imediata, as seguintes seguem a espera exponencial
+            sup->disconnects++;
+            cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+            begin_attempt(sup);
+        }
+        else
+        {
+            sup->next_poll = make_timeout_time_ms(WIFI_LINK_CHECK_MS);
+        }
+        break;
+
+    case WIFI_STATE_BACKOFF:
+        if (time_reached(sup->deadline))
+        {
+            begin_attempt(sup);
+        }
+        break;
+    }
+}
+
+absolute_time_t wifi_supervisor_next_event(const wifi_supervisor_t *sup)
+{
+    switch (sup->state)
+    {
+    case WIFI_STATE_CONNECTING:
+    case WIFI_STATE_CONNECTED:
+        return sup->next_poll;
+    case WIFI_STATE_BACKOFF:
+        return sup->deadline;
+    default:
+        return at_the_end_of_time;
+    }
+}
+
+bool wifi_supervisor_is_connected(const wifi_supervisor_t *sup)
+{
+    return sup->state == WIFI_STATE_CONNECTED;
+}
+
+const char *wifi_supervisor_state_str(wifi_state_t state)
+{
+    switch (state)
+    {
+    case WIFI_STATE_IDLE:
+        return "idle";
+    case WIFI_STATE_CONNECTING:
+        return "connecting";
+    case WIFI_STATE_CONNECTED:
+        return "connected";
+    case WIFI_STATE_BACKOFF:
+        return "backoff";
+    }
+    return "unknown";
+}
@@ -0,0 +1,57 @@
+#ifndef WIFI_SUPERVISOR_H
+#define WIFI_SUPERVISOR_H
+
+#include "pico/stdlib.h"
+
+// Supervisor de conexão Wi-Fi sem bloqueio. A associação é iniciada com
+// cyw43_arch_wifi_connect_async e acompanhada pelo status do link a cada chamada de
+// wifi_supervisor_poll. Falhas esperam um intervalo exponencial com jitter antes de nova
+// tentativa, e uma queda do link inicia a reconexão imediatamente.
+
+#define WIFI_CONNECT_TIMEOUT_MS  15000 // Prazo de uma tentativa de conexão
+#define WIFI_BACKOFF_MIN_MS      1000  // Espera após a primeira falha
+#define WIFI_BACKOFF_MAX_MS      60000 // Espera máxima entre tentativas
+#define WIFI_CONNECT_POLL_MS     250   // Consulta do status durante a conexão
+#define WIFI_LINK_CHECK_MS       5000  // Consulta do status com o link ativo
+
+typedef enum {
+    WIFI_STATE_IDLE,       // Supervisor ainda não iniciado
+    WIFI_STATE_CONNECTING, // Associação e DHCP em andamento
+    WIFI_STATE_CONNECTED,  // Link ativo com endereço IP
+    WIFI_STATE_BACKOFF,    // Aguardando para tentar novamente
+} wifi_state_t;
+
+typedef void (*wifi_state_callback_t)(wifi_state_t state, void *context);
+
+typedef struct {
+    const char *ssid;
+    const char *password;
+    uint32_t auth;
+    wifi_state_t state;
+    absolute_time_t deadline;   // Fim da tentativa ou da espera em andamento
+    absolute_time_t next_poll;  // Próxima consulta do status do link
+    uint32_t backoff_ms;        // Espera-base da próxima falha (antes do jitter)
+    uint32_t failures;          // Falhas consecutivas
+    uint32_t connects;          // Conexões bem-sucedidas
+    uint32_t disconnects;       // Quedas do link
+    int last_status;            // Último status retornado por cyw43_tcpip_link_status
+    wifi_state_callback_t callback;
+    void *context;
+} wifi_supervisor_t;
+
+void wifi_supervisor_init(wifi_supervisor_t *sup, const char *ssid, const char *password, uint32_t auth,
+                          wifi_state_callback_t callback, void *context);
+
+// Dispara a primeira tentativa de conexão
+void wifi_supervisor_start(wifi_supervisor_t *sup);
+
+// Avança a máquina de estados. Não bloqueia; deve ser chamada até wifi_supervisor_next_event.
+void wifi_supervisor_poll(wifi_supervisor_t *sup);
+
+// Instante em que wifi_supervisor_poll precisa ser chamada novamente
+absolute_time_t wifi_supervisor_next_event(const wifi_supervisor_t *sup);
+
+bool wifi_supervisor_is_connected(const wifi_supervisor_t *sup);
+const char *wifi_supervisor_state_str(wifi_state_t state);
+
+#endif // WIFI_SUPERVISOR_H
@@ -1,11 +1,10 @@
 #include <stdio.h>
 #include "pico/stdlib.h"
-#include "hardware/i2c.h"
 #include "pico/bootrom.h"
-#include <math.h>
 
 #include "pico/cyw43_arch.h" // Biblioteca para arquitetura Wi-Fi da Pico com CYW43
 #include "lwip/tcp.h"
+#include "lwip/apps/sntp.h"
 
 #include "lib/led/led.h"
 #include "lib/button/button.h"
@@ -14,9 +13,26 @@
 #include "lib/aht20/aht20.h"
 #include "lib/bmp280/bmp280.h"
 #include "lib/joystick/joystick.h"
+#include "lib/i2c_bus/i2c_bus.h"
+#include "lib/altitude/altitude.h"
+#include "lib/fusion/fusion.h"
+#include "lib/psychrometrics/psychrometrics.h"
+#include "lib/sampler/sampler.h"
+#include "lib/power/power.h"
+#include "lib/wifi_supervisor/wifi_supervisor.h"
+#include "lib/sample_log/sample_log.h"
+#include "lib/config_store/config_store.h"
+#include "lib/snapshot/snapshot.h"
+#include "lib/alerts/alerts.h"
+#include "lib/stats/stats.h"
+#include "lib/downsample/downsample.h"
+#include "lib/admission/admission.h"
+#include "lib/trace/trace.h"
+#include "lib/sample_clock/sample_clock.h"
+#include "lib/wallclock/wallclock.h"
 
 #include "config/wifi_config.h"
-#include "public/html_data.h"
+#include "html_data.h" // Gerado de public/index.html por cmake/embed_html.cmake
 
 #define I2C0_PORT i2c0              // i2c0 pinos 0 e 1
 #define I2C0_SDA 0                  // 0
@@ -24,55 +40,277 @@
 #define I2C1_PORT i2c1              // i2c1 pinos 2 e 3
 #define I2C1_SDA 2                  // 2
 #define I2C1_SCL 3                  // 3
-#define SEA_LEVEL_PRESSURE 101325.0 // 101325.0 // Pressão ao nível do mar em Pa
+#define I2C_BAUDRATE (400 * 1000)   // 400 kHz
+
+#ifndef BMP280_DEFAULT_PROFILE
+#define BMP280_DEFAULT_PROFILE BMP280_PROFILE_STANDARD // Perfil do BMP280 usado na inicialização
+#endif
+
+#define SAMPLES_PAGE_MAX 64           // Amostras por resposta de /api/samples
+#define HISTORY_POINTS_DEFAULT 200    // Baldes de /api/history sem points=
+#define HISTORY_POINTS_MAX 240        // Limite de points= (cada linha ocupa até ~64 bytes da resposta)
+#define HTTP_POLL_INTERVAL 8          // tcp_poll a cada 4 s (unidades de 500 ms)
+#define HTTP_STALL_POLLS 5            // Resposta sem progresso por 5 polls (20 s) é abortada
+
+#ifndef NTP_SERVER
+#define NTP_SERVER "pool.ntp.org"     // Servidor SNTP (nome ou IP; alterável por POST /api/time)
+#endif
+
+#ifndef POWER_DEFAULT_MODE
+#define POWER_DEFAULT_MODE POWER_MODE_PERFORMANCE // Modo de energia usado na inicialização
+#endif
 
 // Tipos de dados
 struct http_state
 {
     char response[20000];
     size_t len;
-    size_t sent;
+    size_t queued;  // Bytes já entregues ao lwIP
+    size_t sent;    // Bytes confirmados pelo cliente
+    uint8_t polls;  // Polls seguidos sem progresso
+
+    // Corpo de POST /api/trace/upload, juntado em response ao longo de um ou mais segmentos
+    bool upload;             // offset e Content-Length lidos
+    uint32_t upload_offset;
+    size_t upload_len;       // Content-Length
+    size_t upload_received;  // Bytes do corpo já copiados
 };
 
+// A página inteira (sem compressão) precisa caber na resposta junto com o cabeçalho
+_Static_assert(HTML_DATA_LEN + 256 <= sizeof(((struct http_state *)0)->response), "public/index.html grande demais");
+// O trace exportado também vai em uma única resposta
+_Static_assert(TRACE_EXPORT_SIZE + 256 <= sizeof(((struct http_state *)0)->response), "TRACE_FRAMES grande demais");
+_Static_assert(TRACE_AHT_SIZE == AHT20_RESULT_SIZE, "quadro do trace sem o resultado completo do AHT20");
+
+// Amostra em inteiros, nas unidades dos drivers; o texto decimal só é gerado na API
 typedef struct weather_data
 {
-    float temperature;
-    float humidity;
-    float pressure;
-    float altitude;
-    int minTemperature;
-    int maxTemperature;
-    float offsetTemperature;
+    int32_t temperature;       // Centésimos de °C (fusão dos dois sensores, sem o offset)
+    int32_t humidity;          // Centésimos de %
+    int32_t pressure;          // Pa
+    int32_t altitude;          // cm
+    int minTemperature;        // °C
+    int maxTemperature;        // °C
+    int32_t offsetTemperature; // Centésimos de °C
+    int32_t bmpTemperature;    // Temperatura do BMP280, em centésimos de °C
+    int32_t ahtTemperature;    // Temperatura do AHT20, em centésimos de °C
+    int32_t dewPoint;          // Ponto de orvalho, em centésimos de °C
+    int32_t heatIndex;         // Índice de calor, em centésimos de °C
+    int32_t absoluteHumidity;  // Umidade absoluta, em centésimos de g/m³
+    uint64_t timestampUs;      // Início da aquisição, em µs desde o boot
+    int64_t unixUs;            // Hora Unix da aquisição, em µs (0 sem sincronização do SNTP)
 } weather_data_t;
 
+// Texto decimal de um valor em centésimos (ou de Pa em hPa, de cm em m) sem ponto flutuante:
+// printf("%" ..., CENTI_ARGS(v)) com CENTI_FMT no lugar de %.2f. v é avaliado mais de uma vez.
+#define CENTI_FMT "%s%lu.%02lu"
+#define CENTI_ARGS(v) ((v) < 0 ? "-" : ""), (unsigned long)(centi_abs(v) / 100), (unsigned long)(centi_abs(v) % 100)
+
+static uint32_t centi_abs(int32_t value)
+{
+    return value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+}
+
+// Valor recebido na unidade exibida (°C, %, hPa) em centésimos, arredondado ao mais próximo
+static int32_t to_centi(float value)
+{
+    return (int32_t)(value * 100.0f + (value < 0 ? -0.5f : 0.5f));
+}
+
+// Amostra publicada para a pilha de rede: tudo que /api/weather mostra vem da mesma amostra
+typedef struct weather_snapshot
+{
+    weather_data_t data;
+    uint32_t seq;                 // Sequência da amostra no histórico (0 antes da primeira)
+    int32_t bmp_bias;             // Vieses da fusão, em centésimos de °C
+    int32_t aht_bias;
+    uint32_t sample_interval_ms;
+    sampler_reason_t sample_reason;
+} weather_snapshot_t;
+
+// Estado de uma regra de alerta publicado para GET /api/alerts
+typedef struct alert_view
+{
+    alert_rule_t rule;
+    uint8_t status;    // alert_status_t
+    uint8_t has_value;
+    int32_t value;
+    uint32_t fired;
+    uint32_t suppressed;
+    uint32_t fired_ms;
+} alert_view_t;
+
+typedef struct alerts_snapshot
+{
+    alert_view_t rules[ALERT_MAX_RULES];
+} alerts_snapshot_t;
+
+// Resumo das janelas de estatísticas publicado para GET /api/stats
+typedef struct stats_snapshot
+{
+    stats_window_summary_t windows[STATS_WINDOWS];
+} stats_snapshot_t;
+
+// Pedido de alteração dos limites de alerta (aplicado pelo laço principal)
+typedef enum
+{
+    LIMITS_REQUEST_NONE,
+    LIMITS_REQUEST_SET,   // Valores de pending_limits (POST /api/limits)
+    LIMITS_REQUEST_RESET, // Limites de fábrica (botão B)
+} limits_request_t;
+
+typedef enum
+{
+    TRACE_REQUEST_NONE,
+    TRACE_REQUEST_RECORD, // Grava as leituras brutas (POST /api/trace)
+    TRACE_REQUEST_REPLAY, // Reproduz o trace no lugar dos sensores
+    TRACE_REQUEST_STOP,
+} trace_request_t;
+
 // Prototipos
 void get_simulated_data(weather_data_t *data);
-double calculate_altitude(double pressure);
 void check_alerts();
 void check_climate_conditions();
 static err_t http_sent(void *arg, struct tcp_pcb *tpcb, u16_t len);
+static err_t http_poll(void *arg, struct tcp_pcb *tpcb);
+static void http_err(void *arg, err_t err);
 static err_t http_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err);
 static err_t connection_callback(void *arg, struct tcp_pcb *newpcb, err_t err);
 static void start_http_server(void);
 void gpio_irq_handler(uint gpio, uint32_t events);
-bool try_wifi_connect(void);
+static void on_sensor_transfer(i2c_bus_result_t result, void *user_data);
+static void apply_power_mode(power_mode_t mode);
+static void on_wifi_state(wifi_state_t state, void *context);
+static void config_snapshot(station_config_t *config);
+static bool network_init(void);
+static void apply_limits_request(void);
+static void publish_weather(void);
+static void publish_alerts(void);
+static void publish_stats(void);
+static void apply_trace_request(void);
+static uint32_t acquisition_lead_us(void);
+static uint64_t wait_sample_tick(void);
+static void start_sntp(void);
+static int64_t wall_clock_unix_us(uint64_t mono_us);
+static const char *unix_ms_str(int64_t unix_us, char *buf, size_t size);
 
 // Variáveis globais
-static weather_data_t weather_data = {0, 0, 0, 0, 10, 70}; // Dados do tempo
+static weather_data_t weather_data = {0, 0, 0, 0, 10, 70}; // Dados do tempo (escritos só pelo laço principal)
+static weather_snapshot_t weather_copies[2];               // Cópias da última amostra publicada
+static snapshot_t weather_snapshot;                        // Publicação da amostra para as interrupções
+static volatile limits_request_t limits_request = LIMITS_REQUEST_NONE; // Pedido de alteração dos limites
+static struct
+{
+    int min;
+    int max;
+    int32_t offset; // Centésimos de °C
+} pending_limits;                                           // Limites recebidos por POST /api/limits
+static alert_engine_t alert_engine;                        // Regras de alerta (limites e regras do usuário)
+static alerts_snapshot_t alerts_copies[2];
+static snapshot_t alerts_snapshot;                         // Estado das regras publicado para a API
+static alert_rule_t pending_alert_rule;                    // Regra recebida por POST /api/alerts
+static volatile int8_t pending_alert_index = -1;           // Índice da regra pendente (-1 = nenhuma)
+static stats_t stats;                                      // Estatísticas em janelas deslizantes
+static stats_snapshot_t stats_copies[2];
+static snapshot_t stats_snapshot;                          // Resumo das janelas publicado para a API
+static admission_t admission;                              // Limites de conexões e requisições HTTP (só a pilha de rede usa)
+static trace_t sensor_trace;                               // Gravação e reprodução das leituras brutas
+static struct bmp280_calib_param trace_calib_params;       // Calibração do BMP280 que gravou o trace em reprodução
+static volatile trace_request_t trace_request = TRACE_REQUEST_NONE;   // Pedido de gravação ou reprodução
+static trace_speed_t pending_trace_speed;                  // Velocidade da reprodução pedida
+static sample_clock_t sample_clock;                        // Grade de instantes das amostras (alarme de hardware)
+static wallclock_t wall_clock;                             // Hora Unix disciplinada pelo SNTP (escrita pela pilha de rede)
+static char ntp_server[64] = NTP_SERVER;                   // Servidor SNTP em uso
 static volatile int64_t last_button_a_press_time = 0;      // Tempo do último pressionamento de botão
 static volatile int64_t last_button_b_press_time = 0;      // Tempo do último pressionamento de botão B
 static volatile int64_t last_button_sw_press_time = 0;     // Tempo do último pressionamento do botão SW
 static volatile bool is_alert_active = true;               // Flag para indicar se o alerta está ativo
 static volatile bool is_simulated = false;                 // Flag para simulação de dados
-static volatile bool wifi_connected = false;
-static volatile bool server_started = false;
-static uint64_t last_wifi_check = 0;
+static volatile bmp280_profile_t pending_bmp_profile = BMP280_PROFILE_COUNT; // Perfil solicitado pela API
+static volatile int32_t pending_qnh_pa = 0;                // QNH solicitado pela API, em Pa (0 = nenhum)
+static i2c_bus_t i2c_bus0;                // Barramento do BMP280
+static i2c_bus_t i2c_bus1;                // Barramento do AHT20
+static bmp280_t bmp280;
+static aht20_t aht20;
+static volatile uint8_t pending_transfers = 0;             // Leituras assíncronas em andamento
+static volatile i2c_bus_result_t bmp_transfer_result;     // Resultado da leitura do BMP280
+static volatile i2c_bus_result_t aht_transfer_result;     // Resultado da leitura do AHT20
+static struct
+{
+    uint32_t ok;
+    uint32_t busy;
+    uint32_t crc_errors;
+    uint32_t bus_errors;
+    uint32_t retries;
+} aht_counters;                                            // Resultados das leituras do AHT20
+static temp_fusion_t temp_fusion;         // Fusão das temperaturas do BMP280 e do AHT20
+static psychro_state_t psychro_state;     // Estado das grandezas derivadas (orvalho, índice de calor...)
+static sampler_t sampler;                 // Intervalo adaptativo entre amostras
+static sampler_config_t pending_sampler_config;            // Configuração solicitada pela API
+static volatile bool sampler_config_pending = false;
+static volatile power_mode_t pending_power_mode = POWER_MODE_COUNT;     // Modo de energia solicitado pela API
+static bmp280_profile_t saved_bmp_profile = BMP280_PROFILE_COUNT;      // Perfil restaurado ao sair do baixo consumo
+static wifi_supervisor_t wifi;            // Conexão Wi-Fi sem bloqueio
+static sample_log_t sample_log;           // Amostras recentes para recuperação incremental
+static config_store_t config_store;       // Configuração persistente na flash
+static station_config_t default_config;   // Configuração de fábrica (restaurada pelo botão B)
+static bool network_started = false;      // CYW43 inicializado (após a primeira amostra)
+static bool network_attempted = false;    // Inicialização do CYW43 já tentada (falha não é repetida)
+
+// Marcos da inicialização, em µs desde o boot (0 = ainda não ocorreu)
+static struct
+{
+    uint64_t sensors_ready;
+    uint64_t first_sample;
+    uint64_t network_ready;
+    uint64_t ip_acquired;
+    uint64_t first_http_response;
+} boot_timing;
 
 
 int main()
 {
     stdio_init_all();
 
+    // Carrega a configuração persistente (os padrões de compilação valem para a flash vazia)
+    station_config_t config;
+    config_store_defaults(&default_config);
+    default_config.bmp_profile = BMP280_DEFAULT_PROFILE;
+    default_config.power_mode = POWER_DEFAULT_MODE;
+    if (!config_store_init(&config_store, &default_config, &config))
+    {
+        printf("Configuração não encontrada na flash, usando os padrões\n");
+    }
+    weather_data.minTemperature = config.min_temperature;
+    weather_data.maxTemperature = config.max_temperature;
+    weather_data.offsetTemperature = config.temp_offset;
+    is_alert_active = config.alerts_enabled;
+    altitude_set_qnh(config.qnh_pa);
+    weather_snapshot_t initial = {.data = weather_data};
+    snapshot_init(&weather_snapshot, &weather_copies[0], &weather_copies[1], sizeof(initial), &initial);
+
+    // Regras 0 e 1: limites de temperatura (limiares sincronizados com /api/limits a cada amostra)
+    alert_engine_init(&alert_engine);
+    alert_engine_set_rule(&alert_engine, 0, &(alert_rule_t){
+        .metric = ALERT_METRIC_TEMPERATURE, .condition = ALERT_CONDITION_ABOVE,
+        .action = ALERT_ACTION_BUZZER_A, .enabled = 1,
+        .threshold = weather_data.maxTemperature * 100, .hysteresis = 50, .cooldown_s = 60,
+    });
+    alert_engine_set_rule(&alert_engine, 1, &(alert_rule_t){
+        .metric = ALERT_METRIC_TEMPERATURE, .condition = ALERT_CONDITION_BELOW,
+        .action = ALERT_ACTION_BUZZER_B, .enabled = 1,
+        .threshold = weather_data.minTemperature * 100, .hysteresis = 50, .cooldown_s = 60,
+    });
+    for (int i = 0; i < ALERT_USER_RULES; i++)
+    {
+        if (!alert_engine_set_rule(&alert_engine, ALERT_USER_RULE_FIRST + i, &config.alert_rules[i]))
+        {
+            printf("Regra de alerta %d inválida na configuração, ignorada\n", ALERT_USER_RULE_FIRST + i);
+        }
+    }
+    snapshot_init(&alerts_snapshot, &alerts_copies[0], &alerts_copies[1], sizeof(alerts_copies[0]), NULL);
+    publish_alerts();
+
     init_btns();
     init_btn(BTN_SW_PIN);
     init_leds_pwm();
@@ -82,135 +320,333 @@ int main()
     init_buzzer(BUZZER_A_PIN, 4.0f); // Inicializa o buzzer A
     init_buzzer(BUZZER_B_PIN, 4.0f); // Inicializa o buzzer B
 
+#ifdef ALTITUDE_BENCHMARK
+    sleep_ms(2000);       // Aguarda a conexão do monitor serial
+    altitude_benchmark(); // Compara a altitude em ponto fixo com a versão em pow()
+#endif
+
     gpio_set_irq_enabled_with_callback(BTN_SW_PIN, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
     gpio_set_irq_enabled(BTN_A_PIN, GPIO_IRQ_EDGE_RISE, true);
     gpio_set_irq_enabled(BTN_B_PIN, GPIO_IRQ_EDGE_FALL, true);
 
-    // Inicializa o I2C para o SMP280
-    i2c_init(I2C0_PORT, 400 * 1000);
-    gpio_set_function(I2C0_SDA, GPIO_FUNC_I2C);
-    gpio_set_function(I2C0_SCL, GPIO_FUNC_I2C);
-    gpio_pull_up(I2C0_SDA);
-    gpio_pull_up(I2C0_SCL);
-
-    // Inicializa o I2C para o AHT20
-    i2c_init(I2C1_PORT, 400 * 1000);
-    gpio_set_function(I2C1_SDA, GPIO_FUNC_I2C);
-    gpio_set_function(I2C1_SCL, GPIO_FUNC_I2C);
-    gpio_pull_up(I2C1_SDA);
-    gpio_pull_up(I2C1_SCL);
+    // Inicializa os barramentos I2C (transações por DMA, um barramento por sensor)
+    i2c_bus_init(&i2c_bus0, I2C0_PORT, I2C0_SDA, I2C0_SCL, I2C_BAUDRATE);
+    i2c_bus_init(&i2c_bus1, I2C1_PORT, I2C1_SDA, I2C1_SCL, I2C_BAUDRATE);
 
     // Inicializa o BMP280
-    bmp280_init(I2C0_PORT);
-    struct bmp280_calib_param params;
-    bmp280_get_calib_params(I2C0_PORT, &params);
-
-    // Inicializa o AHT20
-    aht20_reset(I2C1_PORT);
-    aht20_init(I2C1_PORT);
-
-    if (cyw43_arch_init())
+    if (!bmp280_init(&bmp280, &i2c_bus0, BMP280_ADDR_PRIMARY))
     {
-        printf("Falha ao inicializar a arquitetura CYW43\n ");
-        set_led_red_pwm(); // LED vermelho para falha de inicialização
-        sleep_ms(2000);
-        return 1;
+        printf("BMP280 não encontrado no endereço 0x%02x\n", BMP280_ADDR_PRIMARY);
     }
+    bmp280_set_sleep(&bmp280, power_wait_until); // A espera pela conversão conta como sono no relatório
+    bmp280_set_profile(&bmp280, config.bmp_profile < BMP280_PROFILE_COUNT ? (bmp280_profile_t)config.bmp_profile
+                                                                          : BMP280_DEFAULT_PROFILE);
 
-    cyw43_arch_enable_sta_mode();
-
-    // Loop até conseguir conectar ao Wi-Fi pela primeira vez
-    while (!wifi_connected)
+    // Inicializa o AHT20 (uma única vez: só envia o comando de calibração se o sensor precisar)
+    if (!aht20_init(&aht20, &i2c_bus1, AHT20_I2C_ADDR))
     {
-        wifi_connected = try_wifi_connect();
-
-        if (!wifi_connected)
-        {
-            printf("Nova tentativa em 5 segundos...\n");
-            sleep_ms(5000);
-        }
+        printf("AHT20 não respondeu na inicialização\n");
     }
+    boot_timing.sensors_ready = time_us_64();
 
-    // Só inicia o servidor HTTP após conectar ao Wi-Fi
-    start_http_server();
-    server_started = true;
+    // A rede só é iniciada após a primeira amostra (cyw43_arch_init carrega o firmware do rádio);
+    // o modo de energia salvo é aplicado quando o CYW43 estiver pronto
+    wifi_supervisor_init(&wifi, WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, on_wifi_state, NULL);
+    if (config.power_mode == POWER_MODE_LOW_POWER)
+    {
+        pending_power_mode = POWER_MODE_LOW_POWER;
+    }
 
     // Estruturas para leitura de sensores
     AHT20_Data data;
     int32_t raw_temp_bmp;
     int32_t raw_pressure;
-    double altitude;
-    uint64_t current_time;
+    int32_t pressure_pa;
+    // Primeira amostra assim que a medição do AHT20 (disparada já na primeira iteração) terminar
+    if (!sample_clock_init(&sample_clock, time_us_64() + AHT20_MEASUREMENT_MS * 1000))
+    {
+        printf("Sem alarme de hardware livre: amostragem pelo tempo do sistema\n");
+    }
+    int32_t bmp_temp;
+    bool bmp_valid;
+    bool aht_valid;
+
+    temp_fusion_init(&temp_fusion);
+    psychro_init(&psychro_state);
+    sampler_config_t sampler_config;
+    sampler_default_config(&sampler_config);
+    sampler_config.min_interval_ms = config.sample_min_interval_ms;
+    sampler_config.max_interval_ms = config.sample_max_interval_ms;
+    sampler_config.temp_deadband = config.sample_temp_deadband;
+    sampler_config.humidity_deadband = config.sample_humidity_deadband;
+    sampler_config.pressure_deadband = config.sample_pressure_deadband;
+    sampler_init(&sampler, &sampler_config); // Configuração inválida mantém os padrões
+    sample_log_init(&sample_log);
+    stats_init(&stats, NULL);
+    snapshot_init(&stats_snapshot, &stats_copies[0], &stats_copies[1], sizeof(stats_copies[0]), NULL);
+    trace_init(&sensor_trace);
 
     // Loop principal
     while (true)
     {
-        cyw43_arch_poll(); // Mantém o Wi-Fi funcionando
+        // Acompanha a conexão Wi-Fi sem bloquear a aquisição
+        wifi_supervisor_poll(&wifi);
 
-        // Verifica periodicamente o status da conexão Wi-Fi (a cada 10 segundos)
-        current_time = to_ms_since_boot(get_absolute_time());
-        if (current_time - last_wifi_check > 10000)
+        // Reidentifica os sensores de barramentos que passaram por recuperação
+        i2c_bus_service(&i2c_bus0);
+        i2c_bus_service(&i2c_bus1);
+
+        // Aplica o perfil do BMP280 solicitado pela API (fora do contexto da pilha de rede)
+        if (pending_bmp_profile != BMP280_PROFILE_COUNT)
         {
-            last_wifi_check = current_time;
+            bmp280_set_profile(&bmp280, pending_bmp_profile);
+            pending_bmp_profile = BMP280_PROFILE_COUNT;
+            printf("Perfil do BMP280: %s (conversão de %lu us)\n",
+                   bmp280_get_profile_config(bmp280_get_profile(&bmp280))->name,
+                   (unsigned long)bmp280_measurement_time_typ_us(bmp280_get_profile(&bmp280)));
+        }
 
-            // Verifica o status do link Wi-Fi
-            if (cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA) != CYW43_LINK_UP)
-            {
-                printf("Conexão Wi-Fi perdida! Tentando reconectar...\n");
-                wifi_connected = false;
+        // Aplica o QNH solicitado pela API: os termos da altitude mudam juntos, fora de altitude_from_pressure
+        if (pending_qnh_pa != 0)
+        {
+            altitude_set_qnh(pending_qnh_pa);
+            pending_qnh_pa = 0;
+            printf("QNH: %ld Pa\n", (long)altitude_get_qnh());
+        }
 
-                // Tenta reconectar
-                while (!wifi_connected)
-                {
-                    wifi_connected = try_wifi_connect();
+        // Aplica o modo de energia solicitado pela API (ou o salvo, após o boot da rede)
+        if (pending_power_mode != POWER_MODE_COUNT && network_started)
+        {
+            apply_power_mode(pending_power_mode);
+            pending_power_mode = POWER_MODE_COUNT;
+        }
 
-                    if (!wifi_connected)
-                    {
-                        printf("Nova tentativa em 5 segundos...\n");
-                        sleep_ms(5000);
-                    }
-                }
+        // Aplica a configuração de amostragem solicitada pela API
+        if (sampler_config_pending)
+        {
+            sampler_set_config(&sampler, &pending_sampler_config);
+            sampler_config_pending = false;
+        }
 
-                // Reinicia o servidor HTTP se necessário
-                if (wifi_connected && !server_started)
-                {
-                    start_http_server();
-                    server_started = true;
-                }
-            }
+        // Aplica os limites de alerta pedidos pela API ou pelo botão B
+        if (limits_request != LIMITS_REQUEST_NONE)
+        {
+            apply_limits_request();
+            publish_weather();
+        }
+
+        // Aplica a regra de alerta recebida pela API (o estado da regra recomeça)
+        if (pending_alert_index >= 0)
+        {
+            alert_engine_set_rule(&alert_engine, pending_alert_index, &pending_alert_rule);
+            pending_alert_index = -1;
+            publish_alerts();
+        }
+
+        // Inicia ou interrompe a gravação ou a reprodução de trace pedida pela API
+        if (trace_request != TRACE_REQUEST_NONE)
+        {
+            apply_trace_request();
+        }
+
+        // Agrupa as alterações de configuração e grava na flash após um período sem mudanças
+        config_snapshot(&config);
+        config_store_update(&config_store, &config);
+        config_store_service(&config_store);
+
+        // Dorme até a próxima amostra (a pilha de rede segue atendendo por interrupção). Sem simulação,
+        // acorda antes para disparar o AHT20 e uma conversão do BMP280 que termine até o instante da
+        // amostra. Pedidos da API acordam o laço antes do prazo para serem aplicados sem esperar o
+        // intervalo.
+        bool replaying = sensor_trace.mode == TRACE_REPLAYING;
+        uint64_t tick_us = sample_clock_tick_us(&sample_clock);
+        uint32_t lead_us = is_simulated || replaying ? 0 : acquisition_lead_us();
+        absolute_time_t wake_time = from_us_since_boot(tick_us > lead_us ? tick_us - lead_us : 0);
+        absolute_time_t service_time = wifi_supervisor_next_event(&wifi);
+        absolute_time_t config_time = config_store_next_event(&config_store);
+        if (absolute_time_diff_us(service_time, config_time) < 0)
+        {
+            service_time = config_time;
+        }
+        if (absolute_time_diff_us(service_time, wake_time) > 0)
+        {
+            // O supervisor do Wi-Fi ou a gravação da configuração precisam rodar antes da amostra
+            power_sleep_until(service_time);
+            continue;
+        }
+        if (power_sleep_until(wake_time))
+        {
+            continue;
         }
 
-        if (is_simulated)
+        trace_frame_t frame;
+        uint64_t frame_start_us = 0;
+        uint64_t acquired_us; // Início da aquisição (ou do processamento do quadro reproduzido)
+        if (replaying)
+        {
+            // Quadro do trace no lugar dos sensores
+            if (!trace_next(&sensor_trace, &frame, time_us_64()))
+            {
+                // Fim do trace: volta aos sensores, com tempo para a medição do AHT20
+                printf("Reprodução concluída: %lu quadros em %.1f ms\n", (unsigned long)sensor_trace.replayed,
+                       (sensor_trace.finished_us - sensor_trace.started_us) / 1000.0);
+                sample_clock_restart(&sample_clock, time_us_64() + acquisition_lead_us());
+                continue;
+            }
+            frame_start_us = time_us_64();
+            acquired_us = frame_start_us;
+        }
+        else if (is_simulated)
         {
+            acquired_us = wait_sample_tick();
             get_simulated_data(&weather_data);
         }
         else
         {
-            // Leitura do BMP280
-            bmp280_read_raw(I2C0_PORT, &raw_temp_bmp, &raw_pressure);
+            aht20_trigger_async(&aht20, NULL, NULL);
+
+            // Dispara uma conversão do BMP280 que termina até o instante da amostra (a medição do AHT20
+            // segue em paralelo) e então aguarda o alarme do instante: a leitura começa na grade, com a
+            // conversão mais velha que ele no máximo a folga entre os tempos típico e máximo
+            bmp280_wait_conversion(&bmp280, from_us_since_boot(tick_us));
+            acquired_us = wait_sample_tick();
+
+            // Lê os dois sensores em paralelo, cada um em seu barramento, e dorme até o fim das transferências.
+            // O callback decrementa o contador na interrupção, então as submissões que falharem são
+            // descontadas de uma vez com as interrupções desabilitadas (o decremento não é atômico no M0+).
+            uint8_t failed_transfers = 0;
+            pending_transfers = 2;
+            bmp_transfer_result = I2C_BUS_ERR_ABORT;
+            aht_transfer_result = I2C_BUS_ERR_ABORT;
+            if (!bmp280_read_raw_async(&bmp280, on_sensor_transfer, (void *)&bmp_transfer_result))
+                failed_transfers++;
+            if (!aht20_fetch_async(&aht20, on_sensor_transfer, (void *)&aht_transfer_result))
+                failed_transfers++;
+            if (failed_transfers > 0)
+            {
+                uint32_t irq_status = save_and_disable_interrupts();
+                pending_transfers -= failed_transfers;
+                restore_interrupts(irq_status);
+            }
+            while (pending_transfers > 0)
+            {
+                power_wait_event();
+            }
+
+            // Resultado ocupado ou com CRC inválido: lê de novo uma vez (o sensor mantém a medição até o
+            // próximo disparo), esperando um pouco se a medição ainda não terminou
+            aht20_result_t aht_first = aht_transfer_result == I2C_BUS_OK ? aht20_parse(&aht20, &data) : AHT20_OK;
+            if (aht_first != AHT20_OK)
+            {
+                aht_counters.retries++;
+                if (aht_first == AHT20_BUSY)
+                {
+                    sleep_ms(AHT20_BUSY_RETRY_MS);
+                }
+                aht_transfer_result = aht20_fetch(&aht20) ? I2C_BUS_OK : I2C_BUS_ERR_ABORT;
+            }
+
+            // Leituras brutas, no formato do trace (gravadas se a gravação estiver ativa)
+            frame.time_ms = (uint32_t)(acquired_us / 1000);
+            frame.flags = 0;
+            if (!bmp280.ready || bmp_transfer_result != I2C_BUS_OK)
+            {
+                printf("Erro na leitura do BMP280: %s\n", i2c_bus_result_str(bmp_transfer_result));
+            }
+            else if (!bmp280_check_raw(&bmp280))
+            {
+                printf("Erro na leitura do BMP280: sensor reiniciado\n");
+            }
+            else
+            {
+                frame.flags |= TRACE_FRAME_BMP_VALID;
+            }
+            if (aht_transfer_result == I2C_BUS_OK)
+            {
+                frame.flags |= TRACE_FRAME_AHT_VALID;
+            }
+            memcpy(frame.bmp, bmp280.raw, sizeof(frame.bmp));
+            memcpy(frame.aht, aht20.buffer, sizeof(frame.aht));
+            trace_record(&sensor_trace, &frame);
+        }
 
-            weather_data.temperature = bmp280_convert_temp(raw_temp_bmp, &params);
-            weather_data.temperature /= 100.0; // Converte para Celsius
+        if (replaying || !is_simulated)
+        {
+            // Compensação das leituras brutas, lidas agora ou reproduzidas com a calibração de quem gravou
+            struct bmp280_calib_param *calib = replaying ? &trace_calib_params : &bmp280.calib;
 
-            weather_data.pressure = bmp280_convert_pressure(raw_pressure, raw_temp_bmp, &params);
-            weather_data.pressure /= 100.0; // Converte para hPa
-            weather_data.altitude = calculate_altitude(weather_data.pressure * 100.0); // Converte hPa para Pa
+            // Leitura do BMP280; em caso de falha mantém a última pressão válida
+            bmp_valid = frame.flags & TRACE_FRAME_BMP_VALID;
+            if (bmp_valid)
+            {
+                bmp280_decode_raw(frame.bmp, &raw_temp_bmp, &raw_pressure);
+                bmp_temp = bmp280_convert_temp(raw_temp_bmp, calib); // Centésimos de °C
+                weather_data.bmpTemperature = bmp_temp;
 
-            /* printf("Dados BMP280: Temp=%.2f°C, Press=%.2f hPa, Alt=%.2f m\n",
-                   weather_data.temperature, weather_data.pressure, weather_data.altitude); */
+                pressure_pa = bmp280_convert_pressure(raw_pressure, raw_temp_bmp, calib);
+                weather_data.pressure = pressure_pa;
+                weather_data.altitude = altitude_from_pressure(pressure_pa); // cm
+            }
+            else
+            {
+                bmp_temp = 0;
+            }
 
-            // Leitura do AHT20
-            if (aht20_read(I2C1_PORT, &data))
+            // Leitura do AHT20; ocupado, CRC inválido ou falha no barramento mantêm a última umidade boa
+            // (a fusão usa só o BMP280 nessa amostra)
+            aht20_result_t aht_result = frame.flags & TRACE_FRAME_AHT_VALID ? aht20_decode(frame.aht, &data)
+                                                                            : AHT20_BUS_ERROR;
+            aht_valid = aht_result == AHT20_OK;
+            if (aht_valid)
             {
+                aht_counters.ok++;
                 weather_data.humidity = data.humidity;
-                /* printf("Dados AHT20: Temp=%.2f°C, Hum=%.2f%%\n",
-                       data.temperature, data.humidity); */
+                weather_data.ahtTemperature = data.temperature;
             }
             else
             {
-                printf("Erro na leitura do AHT20!\n");
-                weather_data.humidity = 0.0; // Valor padrão em caso de erro
+                if (aht_result == AHT20_BUSY)
+                    aht_counters.busy++;
+                else if (aht_result == AHT20_CRC_ERROR)
+                    aht_counters.crc_errors++;
+                else
+                    aht_counters.bus_errors++;
+                printf("Erro na leitura do AHT20: %s\n", aht20_result_str(aht_result));
             }
+
+            // Funde as temperaturas dos dois sensores, descontando o viés estimado de cada um
+            weather_data.temperature = temp_fusion_update(&temp_fusion, bmp_temp, bmp_valid,
+                                                          weather_data.ahtTemperature, aht_valid);
+        }
+
+        // Atualiza as grandezas derivadas de temperatura e umidade
+        const psychro_metrics_t *metrics = psychro_update(&psychro_state, weather_data.temperature,
+                                                          weather_data.humidity);
+        weather_data.dewPoint = metrics->dew_point;
+        weather_data.heatIndex = metrics->heat_index;
+        weather_data.absoluteHumidity = metrics->absolute_humidity;
+
+        // Instantes da aquisição: monotônico e, se o SNTP já sincronizou, hora Unix
+        weather_data.timestampUs = acquired_us;
+        weather_data.unixUs = wall_clock_unix_us(acquired_us);
+
+        power_note_sample();
+
+        // Guarda a amostra para os coletores (inclusive durante quedas do Wi-Fi)
+        sample_record_t record = {
+            .time_ms = (uint32_t)(acquired_us / 1000),
+            .temperature = (int16_t)weather_data.temperature,
+            .humidity = (uint16_t)weather_data.humidity,
+            .pressure = (uint32_t)weather_data.pressure,
+        };
+        sample_log_append(&sample_log, &record);
+        stats_add(&stats, record.time_ms, (const int32_t[STATS_METRICS]){record.temperature, record.humidity,
+                                                                         (int32_t)record.pressure});
+        publish_stats();
+        if (!boot_timing.first_sample)
+        {
+            boot_timing.first_sample = time_us_64();
+            printf("Primeira amostra em %.1f ms\n", boot_timing.first_sample / 1000.0);
         }
 
         // Verifica os alertas
@@ -219,48 +655,92 @@ int main()
         // Verifica as condições climáticas
         check_climate_conditions();
 
-        sleep_ms(1000);
+        // Ajusta o intervalo à variação das leituras e à proximidade dos limites de alerta
+        uint32_t interval_ms = sampler_update(&sampler,
+                                              weather_data.temperature, weather_data.humidity, weather_data.pressure,
+                                              weather_data.minTemperature * 100 - weather_data.offsetTemperature,
+                                              weather_data.maxTemperature * 100 - weather_data.offsetTemperature);
+
+        // Publica a amostra completa para a pilha de rede
+        publish_weather();
+
+        // Na reprodução, o intervalo vem do trace (zero na velocidade máxima)
+        if (replaying)
+        {
+            trace_note_processed(&sensor_trace, (uint32_t)(time_us_64() - frame_start_us));
+            interval_ms = trace_next_interval_ms(&sensor_trace);
+        }
+
+        // Inicia a rede depois da primeira amostra; a associação segue em segundo plano
+        if (!network_attempted)
+        {
+            network_attempted = true;
+            network_started = network_init();
+        }
+
+        // Agenda a próxima amostra na grade; se o laço atrasou (ex.: reconexão), pula os instantes perdidos
+        if (replaying)
+        {
+            // Na reprodução o ritmo é o do trace, a partir de agora se o processamento atrasou
+            uint64_t next_us = sample_clock_tick_us(&sample_clock) + interval_ms * 1000ull;
+            uint64_t now_us = time_us_64();
+            sample_clock_restart(&sample_clock, next_us > now_us ? next_us : now_us);
+        }
+        else
+        {
+            sample_clock_advance(&sample_clock, interval_ms * 1000ull, time_us_64());
+        }
     }
     cyw43_arch_deinit(); // Esperamos que nunca chegue aqui
 }
 
-// Função para calcular a altitude a partir da pressão atmosférica
-double calculate_altitude(double pressure)
-{
-    return 44330.0 * (1.0 - pow(pressure / SEA_LEVEL_PRESSURE, 0.1903));
-}
-
-// Função para verificar os alertas de temperatura
+// Avalia as regras de alerta com a amostra atual e executa as ações das regras disparadas
 void check_alerts()
 {
-    if (is_alert_active)
+    alert_engine_set_threshold(&alert_engine, 0, weather_data.maxTemperature * 100);
+    alert_engine_set_threshold(&alert_engine, 1, weather_data.minTemperature * 100);
+
+    int32_t values[ALERT_METRIC_COUNT] = {
+        [ALERT_METRIC_TEMPERATURE] = weather_data.temperature + weather_data.offsetTemperature,
+        [ALERT_METRIC_HUMIDITY] = weather_data.humidity,
+        [ALERT_METRIC_PRESSURE] = weather_data.pressure,
+        [ALERT_METRIC_DEW_POINT] = weather_data.dewPoint,
+        [ALERT_METRIC_HEAT_INDEX] = weather_data.heatIndex,
+    };
+    uint32_t fired = alert_engine_update(&alert_engine, values, to_ms_since_boot(get_absolute_time()));
+
+    for (int i = 0; fired; i++, fired >>= 1)
     {
-        if (weather_data.temperature + weather_data.offsetTemperature > weather_data.maxTemperature)
-        {
-            printf("Alerta: Temperatura acima do limite!\n");
-            play_tone(BUZZER_A_PIN, 700); // Toca o buzzer A
-            sleep_ms(250);                //
-            stop_tone(BUZZER_A_PIN);      // Para o buzzer A
-        }
-        else if (weather_data.temperature + weather_data.offsetTemperature < weather_data.minTemperature)
-        {
-            printf("Alerta: Temperatura abaixo do limite!\n");
-            play_tone(BUZZER_B_PIN, 400); // Toca o buzzer B
-            sleep_ms(250);                //
-            stop_tone(BUZZER_B_PIN);      // Para o buzzer B
-        }
+        if (!(fired & 1))
+            continue;
+
+        const alert_rule_t *rule = &alert_engine.rules[i];
+        printf("Alerta %d: %s %s " CENTI_FMT " (valor " CENTI_FMT ")\n", i,
+               alert_metric_name(rule->metric), alert_condition_name(rule->condition),
+               CENTI_ARGS(rule->threshold), CENTI_ARGS(alert_engine.state[i].value));
+
+        // O botão A silencia os buzzers; as regras continuam sendo avaliadas
+        if (!is_alert_active || rule->action == ALERT_ACTION_NONE)
+            continue;
+
+        uint buzzer = rule->action == ALERT_ACTION_BUZZER_A ? BUZZER_A_PIN : BUZZER_B_PIN;
+        play_tone(buzzer, rule->action == ALERT_ACTION_BUZZER_A ? 700 : 400);
+        sleep_ms(250);
+        stop_tone(buzzer);
     }
+
+    publish_alerts();
 }
 
 // Função para verificar as condições climáticas
 void check_climate_conditions()
 {
-    bool is_hot = weather_data.temperature > 30;
-    bool is_very_hot = weather_data.temperature > 50;
-    bool is_cold = weather_data.temperature < 15;
-    bool is_very_cold = weather_data.temperature < 5;
-    bool is_humid = weather_data.humidity > 80;
-    bool is_dry = weather_data.humidity < 20;
+    bool is_hot = weather_data.temperature > 3000;
+    bool is_very_hot = weather_data.temperature > 5000;
+    bool is_cold = weather_data.temperature < 1500;
+    bool is_very_cold = weather_data.temperature < 500;
+    bool is_humid = weather_data.humidity > 8000;
+    bool is_dry = weather_data.humidity < 2000;
 
     ws2812b_clear(); // Limpa os LEDs
 
@@ -315,161 +795,1404 @@ void check_climate_conditions()
 void get_simulated_data(weather_data_t *data)
 {
     // Simula dados de temperatura e umidade
-    data->temperature = get_joystick_y() / 4095.0 * 100.0; // Temperatura entre 0.0 e 60.0 C
-    data->humidity = get_joystick_x() / 4095.0 * 100.0;    // Umidade entre 0.0 e 100.0
-
-    //printf("Dados simulados: Temperatura: %.2f C, Umidade: %.2f %%\n", data->temperature, data->humidity);
+    data->temperature = get_joystick_y() * 10000 / 4095; // Temperatura entre 0,00 e 100,00 °C
+    data->humidity = get_joystick_x() * 10000 / 4095;    // Umidade entre 0,00 e 100,00 %
 }
 
-// Função de callback para enviar dados HTTP
-static err_t http_sent(void *arg, struct tcp_pcb *tpcb, u16_t len)
+// Inicializa o CYW43, o servidor HTTP e a conexão Wi-Fi em segundo plano
+static bool network_init(void)
 {
-    struct http_state *hs = (struct http_state *)arg;
-    hs->sent += len;
-    if (hs->sent >= hs->len)
+    if (cyw43_arch_init())
     {
-        tcp_close(tpcb);
-        free(hs);
+        printf("Falha ao inicializar a arquitetura CYW43\n");
+        set_led_red_pwm(); // LED vermelho para falha de inicialização
+        return false;
     }
-    return ERR_OK;
+
+    cyw43_arch_enable_sta_mode();
+
+    // O servidor HTTP é iniciado uma única vez: ligado a IP_ADDR_ANY, passa a atender
+    // assim que o Wi-Fi obtiver um IP e continua válido após reconexões
+    start_http_server();
+
+    // Hora pelo SNTP: as consultas começam quando houver IP e se repetem a cada SNTP_UPDATE_DELAY
+    cyw43_arch_lwip_begin();
+    start_sntp();
+    cyw43_arch_lwip_end();
+
+    // Configura o power-save do Wi-Fi e o relatório de energia
+    power_init(POWER_MODE_PERFORMANCE);
+
+    wifi_supervisor_start(&wifi);
+    boot_timing.network_ready = time_us_64();
+    return true;
 }
 
-// Função de recebimento HTTP
-static err_t http_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err)
+// Aplica o pedido de alteração dos limites. O pedido é consumido antes da cópia: se um novo
+// POST chegar durante a cópia, ele volta a ser marcado e é reaplicado na próxima iteração.
+static void apply_limits_request(void)
 {
-    if (!p)
+    limits_request_t request = limits_request;
+    limits_request = LIMITS_REQUEST_NONE;
+
+    if (request == LIMITS_REQUEST_RESET)
     {
-        tcp_close(tpcb);
-        return ERR_OK;
+        weather_data.minTemperature = default_config.min_temperature;
+        weather_data.maxTemperature = default_config.max_temperature;
     }
-
-    char *req = (char *)p->payload;
-    struct http_state *hs = malloc(sizeof(struct http_state));
-    if (!hs)
+    else
     {
-        pbuf_free(p);
-        tcp_close(tpcb);
-        return ERR_MEM;
+        weather_data.minTemperature = pending_limits.min;
+        weather_data.maxTemperature = pending_limits.max;
+        weather_data.offsetTemperature = pending_limits.offset;
     }
-    hs->sent = 0;
 
-    if (strstr(req, "POST /api/limits"))
-    {
-        char *body = strstr(req, "\r\n\r\n");
-        if (body)
-        {
-            body += 4;
-            int max_val, min_val;
-            float offset_val = 0.0f;
-            if (sscanf(body, "{\"min\":%d,\"max\":%d,\"offset\":%f", &min_val, &max_val, &offset_val) == 3)
-            {
-                // **DEBUG: Mostra os limites recebidos**
-                printf("Limites recebidos: Max=%d, Min=%d, Offset=%f\n", max_val, min_val, offset_val);
-                if (max_val >= 0 && max_val <= 100 && min_val >= -50 && min_val <= 50)
-                {
-                    weather_data.maxTemperature = max_val;
-                    weather_data.minTemperature = min_val;
-                    weather_data.offsetTemperature = offset_val; // Atualiza o offset de temperatura
-                }
-            }
-        }
+    printf("Novos limites: Max=%d, Min=%d, Offset=" CENTI_FMT "\n",
+           weather_data.maxTemperature,
+           weather_data.minTemperature,
+           CENTI_ARGS(weather_data.offsetTemperature));
+}
 
-        printf("Novos limites: Max=%d, Min=%d, Offset=%f\n",
-               weather_data.maxTemperature,
-               weather_data.minTemperature,
-               weather_data.offsetTemperature);
+// Aplica o pedido de trace da API. A reprodução começa na hora, com a calibração gravada no trace.
+static void apply_trace_request(void)
+{
+    trace_request_t request = trace_request;
+    trace_request = TRACE_REQUEST_NONE;
 
-        const char *txt = "Limites atualizados";
-        hs->len = snprintf(hs->response, sizeof(hs->response),
-                           "HTTP/1.1 200 OK\r\n"
-                           "Content-Type: text/plain\r\n"
-                           "Access-Control-Allow-Origin: *\r\n"
-                           "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
-                           "Access-Control-Allow-Headers: Content-Type\r\n"
-                           "Content-Length: %d\r\n"
-                           "\r\n"
-                           "%s",
-                           (int)strlen(txt), txt);
+    if (request == TRACE_REQUEST_RECORD)
+    {
+        trace_start_record(&sensor_trace, bmp280.calib_raw, to_ms_since_boot(get_absolute_time()));
+        printf("Gravação de trace iniciada (até %d quadros)\n", TRACE_FRAMES);
     }
-    else if (strstr(req, "GET /api/weather"))
+    else if (request == TRACE_REQUEST_REPLAY)
     {
-        char json_data[2048];
-        snprintf(json_data, sizeof(json_data),
-                 "{\"temperature\":%.2f,\"humidity\":%.2f,\"pressure\":%.2f,\"altitude\":%.2f,\"minTemperature\":%d,\"maxTemperature\":%d,\"tempOffset\":%.2f}",
-                 weather_data.temperature, weather_data.humidity,
-                 weather_data.pressure, weather_data.altitude,
-                 weather_data.minTemperature, weather_data.maxTemperature, weather_data.offsetTemperature);
-
-        hs->len = snprintf(hs->response, sizeof(hs->response),
-                           "HTTP/1.1 200 OK\r\n"
-                           "Content-Type: application/json\r\n"
-                           "Access-Control-Allow-Origin: *\r\n"
-                           "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
-                           "Access-Control-Allow-Headers: Content-Type\r\n"
-                           "Content-Length: %d\r\n"
-                           "\r\n"
-                           "%s",
-                           (int)strlen(json_data), json_data);
-
-        //printf("JSON enviado: %s\n", json_data);
+        // Parar, ler a calibração e começar sem interrupções: um upload (trace_import, na pilha de rede)
+        // passaria pelo modo ocioso e reescreveria o cabeçalho ou os quadros no meio da preparação
+        uint32_t status = save_and_disable_interrupts();
+        trace_stop(&sensor_trace, time_us_64());
+        bool calib_ok = bmp280_parse_calib(trace_calib(&sensor_trace), &trace_calib_params);
+        bool started = calib_ok && trace_start_replay(&sensor_trace, pending_trace_speed, time_us_64());
+        restore_interrupts(status);
+
+        if (!calib_ok)
+        {
+            printf("Trace sem calibração válida do BMP280, reprodução ignorada\n");
+        }
+        else if (started)
+        {
+            printf("Reproduzindo %u quadros (%s)\n", sensor_trace.count,
+                   pending_trace_speed == TRACE_SPEED_MAX ? "velocidade máxima" : "tempo real");
+            sample_clock_restart(&sample_clock, time_us_64());
+        }
     }
     else
     {
-        // **HTML principal**
-        hs->len = snprintf(hs->response, sizeof(hs->response),
-                           "HTTP/1.1 200 OK\r\n"
-                           "Content-Type: text/html\r\n"
-                           "Content-Length: %d\r\n"
-                           "Connection: close\r\n"
-                           "\r\n"
-                           "%s",
-                           (int)strlen(html_data), html_data);
+        if (sensor_trace.mode == TRACE_REPLAYING)
+        {
+            // De volta aos sensores, com tempo para as medições antes do primeiro instante
+            sample_clock_restart(&sample_clock, time_us_64() + acquisition_lead_us());
+        }
+        trace_stop(&sensor_trace, time_us_64());
     }
-
-    tcp_arg(tpcb, hs);
-    tcp_sent(tpcb, http_sent);
-    tcp_write(tpcb, hs->response, hs->len, TCP_WRITE_FLAG_COPY);
-    tcp_output(tpcb);
-    pbuf_free(p);
-    return ERR_OK;
 }
 
-// Função de callback para aceitar conexões TCP
-static err_t connection_callback(void *arg, struct tcp_pcb *newpcb, err_t err)
+// Antecedência com que o laço acorda antes do instante da amostra: a medição do AHT20 ou a do BMP280
+// no tempo máximo, a que for maior, para que as duas terminem até o instante
+static uint32_t acquisition_lead_us(void)
 {
-    tcp_recv(newpcb, http_recv);
-    return ERR_OK;
+    uint32_t bmp_lead = bmp280_measurement_time_max_us(bmp280_get_profile(&bmp280));
+    uint32_t aht_lead = AHT20_MEASUREMENT_MS * 1000;
+    return bmp_lead > aht_lead ? bmp_lead : aht_lead;
 }
 
-// Função para iniciar o servidor HTTP
-static void start_http_server(void)
+// Aguarda o alarme do instante da amostra e registra o atraso da aquisição em relação à grade
+static uint64_t wait_sample_tick(void)
 {
-    struct tcp_pcb *pcb = tcp_new();
-    if (!pcb)
-    {
-        printf("Erro ao criar PCB TCP\n");
-        return;
-    }
-    if (tcp_bind(pcb, IP_ADDR_ANY, 80) != ERR_OK)
+    absolute_time_t tick = from_us_since_boot(sample_clock_tick_us(&sample_clock));
+    while (!sample_clock_fired(&sample_clock))
     {
-        printf("Erro ao ligar o servidor na porta 80\n");
-        return;
+        power_sleep_until(tick);
     }
-    pcb = tcp_listen(pcb);
-    tcp_accept(pcb, connection_callback);
-    printf("Servidor HTTP rodando na porta 80...\n");
+    uint64_t acquired_us = time_us_64();
+    sample_clock_note(&sample_clock, acquired_us);
+    return acquired_us;
 }
 
-// Função de interrupção para os botões
-// Reinicia o dispositivo para o modo de boot USB ou alterna o estado do alerta
-void gpio_irq_handler(uint gpio, uint32_t events)
+// Hora Unix (µs) no instante monotônico mono_us; 0 antes da primeira sincronização. O relógio é
+// escrito pela pilha de rede, então a leitura fica com as interrupções desabilitadas.
+static int64_t wall_clock_unix_us(uint64_t mono_us)
 {
-    int current_time = to_ms_since_boot(get_absolute_time());
-
-    if (gpio == BTN_SW_PIN && (current_time - last_button_sw_press_time > 300))
-    {
-        // Atualiza o tempo do último pressionamento do botão SW
-        last_button_sw_press_time = current_time;
+    uint32_t status = save_and_disable_interrupts();
+    int64_t unix_us = wallclock_unix_us(&wall_clock, mono_us);
+    restore_interrupts(status);
+    return unix_us;
+}
+
+// Hora Unix em ms para o JSON da API, ou null sem sincronização
+static const char *unix_ms_str(int64_t unix_us, char *buf, size_t size)
+{
+    if (unix_us <= 0)
+        return "null";
+    snprintf(buf, size, "%lld", (long long)(unix_us / 1000));
+    return buf;
+}
+
+// Hora recebida pelo SNTP (SNTP_SET_SYSTEM_TIME_US em config/lwipopts.h), com o atraso da rede
+// descontado; roda na pilha de rede
+void station_sntp_set_time(uint32_t sec, uint32_t us)
+{
+    wallclock_sync(&wall_clock, time_us_64(), (int64_t)sec * 1000000 + us);
+}
+
+// Hora atual para o SNTP (SNTP_GET_SYSTEM_TIME), usada para medir o atraso de ida e volta. Antes da
+// primeira sincronização vai o tempo desde o boot: a diferença de décadas faz o lwIP pular a
+// compensação nessa resposta.
+void station_sntp_get_time(uint32_t *sec, uint32_t *us)
+{
+    uint64_t mono_us = time_us_64();
+    int64_t unix_us = wallclock_unix_us(&wall_clock, mono_us);
+    uint64_t now_us = unix_us > 0 ? (uint64_t)unix_us : mono_us;
+    *sec = (uint32_t)(now_us / 1000000);
+    *us = (uint32_t)(now_us % 1000000);
+}
+
+// (Re)inicia o SNTP com o servidor atual; chamada na pilha de rede
+static void start_sntp(void)
+{
+    sntp_stop();
+    sntp_setoperatingmode(SNTP_OPMODE_POLL);
+    sntp_setservername(0, ntp_server);
+    sntp_init();
+}
+
+// Publica o estado atual; leitores em interrupção ou no outro núcleo veem sempre uma amostra inteira
+static void publish_weather(void)
+{
+    weather_snapshot_t snapshot = {
+        .data = weather_data,
+        .seq = sample_log_last_seq(&sample_log),
+        .bmp_bias = temp_fusion_bias_bmp(&temp_fusion),
+        .aht_bias = temp_fusion_bias_aht(&temp_fusion),
+        .sample_interval_ms = sampler_interval_ms(&sampler),
+        .sample_reason = sampler_reason(&sampler),
+    };
+    snapshot_publish(&weather_snapshot, &snapshot);
+}
+
+// Publica regras e estados das regras de alerta para a pilha de rede
+static void publish_alerts(void)
+{
+    alerts_snapshot_t snapshot;
+    for (int i = 0; i < ALERT_MAX_RULES; i++)
+    {
+        const alert_state_t *state = &alert_engine.state[i];
+        snapshot.rules[i] = (alert_view_t){
+            .rule = alert_engine.rules[i],
+            .status = state->status,
+            .has_value = state->has_value,
+            .value = state->value,
+            .fired = state->fired,
+            .suppressed = state->suppressed,
+            .fired_ms = state->has_fired ? state->fired_ms : 0,
+        };
+    }
+    snapshot_publish(&alerts_snapshot, &snapshot);
+}
+
+// Publica o resumo das janelas de estatísticas (calculado aqui, uma vez por amostra)
+static void publish_stats(void)
+{
+    stats_snapshot_t snapshot;
+    for (int w = 0; w < STATS_WINDOWS; w++)
+    {
+        stats_summary(&stats, w, &snapshot.windows[w]);
+    }
+    snapshot_publish(&stats_snapshot, &snapshot);
+}
+
+// Reúne a configuração atual da estação no registro persistente
+static void config_snapshot(station_config_t *config)
+{
+    const sampler_config_t *sampler_config = &sampler.config;
+
+    memset(config, 0, sizeof(*config));
+    config->min_temperature = (int16_t)weather_data.minTemperature;
+    config->max_temperature = (int16_t)weather_data.maxTemperature;
+    config->temp_offset = weather_data.offsetTemperature;
+    config->qnh_pa = altitude_get_qnh();
+    config->alerts_enabled = is_alert_active;
+    // No baixo consumo o perfil em uso é imposto pelo modo; guarda o escolhido pelo usuário
+    config->bmp_profile = saved_bmp_profile != BMP280_PROFILE_COUNT ? saved_bmp_profile : bmp280_get_profile(&bmp280);
+    config->power_mode = pending_power_mode != POWER_MODE_COUNT ? pending_power_mode : power_get_mode();
+    config->sample_min_interval_ms = sampler_config->min_interval_ms;
+    config->sample_max_interval_ms = sampler_config->max_interval_ms;
+    config->sample_temp_deadband = sampler_config->temp_deadband;
+    config->sample_humidity_deadband = sampler_config->humidity_deadband;
+    config->sample_pressure_deadband = sampler_config->pressure_deadband;
+    memcpy(config->alert_rules, &alert_engine.rules[ALERT_USER_RULE_FIRST], sizeof(config->alert_rules));
+}
+
+// Troca o modo de energia; no baixo consumo o BMP280 passa ao modo forçado (uma conversão por amostra)
+static void apply_power_mode(power_mode_t mode)
+{
+    if (!power_set_mode(mode))
+    {
+        printf("Falha ao configurar o modo de energia %s\n", power_mode_name(mode));
+        return;
+    }
+
+    if (mode == POWER_MODE_LOW_POWER)
+    {
+        if (saved_bmp_profile == BMP280_PROFILE_COUNT)
+        {
+            saved_bmp_profile = bmp280_get_profile(&bmp280);
+        }
+        bmp280_set_profile(&bmp280, BMP280_PROFILE_ULTRA_LOW_POWER);
+    }
+    else if (saved_bmp_profile != BMP280_PROFILE_COUNT)
+    {
+        bmp280_set_profile(&bmp280, saved_bmp_profile);
+        saved_bmp_profile = BMP280_PROFILE_COUNT;
+    }
+
+    printf("Modo de energia: %s (BMP280 %s)\n", power_mode_name(mode),
+           bmp280_get_profile_config(bmp280_get_profile(&bmp280))->name);
+}
+
+// Callback das leituras assíncronas dos sensores (contexto da interrupção do barramento)
+static void on_sensor_transfer(i2c_bus_result_t result, void *user_data)
+{
+    *(volatile i2c_bus_result_t *)user_data = result;
+    pending_transfers--;
+}
+
+// Encerra uma conexão aceita: desfaz os callbacks, libera a resposta e as vagas da admissão.
+// Com abort (ou se o fechamento falhar) a conexão é abortada; o retorno vai para o lwIP.
+static err_t http_close(struct tcp_pcb *tpcb, struct http_state *hs, bool abort)
+{
+    tcp_arg(tpcb, NULL);
+    tcp_recv(tpcb, NULL);
+    tcp_sent(tpcb, NULL);
+    tcp_err(tpcb, NULL);
+    tcp_poll(tpcb, NULL, 0);
+    if (hs)
+    {
+        if (hs->sent < hs->queued)
+        {
+            abort = true; // Dados sem confirmação ainda apontam para hs->response
+        }
+        free(hs);
+        admission_release(&admission);
+    }
+    admission_disconnect(&admission);
+
+    if (!abort && tcp_close(tpcb) == ERR_OK)
+    {
+        return ERR_OK;
+    }
+    tcp_abort(tpcb);
+    return ERR_ABRT;
+}
+
+// Resposta 503 montada em um buffer estático e copiada pelo lwIP: recusar não aloca http_state.
+// counted indica se a conexão ocupa uma vaga de admission_connect.
+static err_t http_reject(struct tcp_pcb *tpcb, uint32_t retry_after_s, bool counted)
+{
+    static char reject[224];
+    int len = snprintf(reject, sizeof(reject),
+                       "HTTP/1.1 503 Service Unavailable\r\n"
+                       "Retry-After: %lu\r\n"
+                       "Content-Type: text/plain\r\n"
+                       "Access-Control-Allow-Origin: *\r\n"
+                       "Content-Length: 8\r\n"
+                       "Connection: close\r\n"
+                       "\r\n"
+                       "Ocupado\n",
+                       (unsigned long)retry_after_s);
+    tcp_write(tpcb, reject, len, TCP_WRITE_FLAG_COPY);
+    tcp_output(tpcb);
+
+    if (counted)
+    {
+        return http_close(tpcb, NULL, false);
+    }
+    if (tcp_close(tpcb) != ERR_OK)
+    {
+        tcp_abort(tpcb);
+        return ERR_ABRT;
+    }
+    return ERR_OK;
+}
+
+// Entrega ao lwIP o quanto couber da resposta. A resposta (até 20 KB) é maior que o buffer de
+// envio do TCP; o restante segue em http_sent. Sem cópia: hs->response fica alocado até o fim.
+static void http_send_more(struct tcp_pcb *tpcb, struct http_state *hs)
+{
+    size_t room = tcp_sndbuf(tpcb);
+    size_t chunk = hs->len - hs->queued;
+    if (chunk > room)
+    {
+        chunk = room;
+    }
+    if (chunk && tcp_write(tpcb, hs->response + hs->queued, chunk, 0) == ERR_OK)
+    {
+        hs->queued += chunk;
+    }
+    tcp_output(tpcb);
+}
+
+// Função de callback para enviar dados HTTP
+static err_t http_sent(void *arg, struct tcp_pcb *tpcb, u16_t len)
+{
+    struct http_state *hs = (struct http_state *)arg;
+    hs->sent += len;
+    hs->polls = 0;
+    if (hs->sent >= hs->len)
+    {
+        if (!boot_timing.first_http_response)
+        {
+            boot_timing.first_http_response = time_us_64();
+        }
+        return http_close(tpcb, hs, false);
+    }
+    http_send_more(tpcb, hs);
+    return ERR_OK;
+}
+
+// Chamada pelo lwIP a cada HTTP_POLL_INTERVAL. Conexão sem requisição até aqui (arg NULL) é
+// fechada, para não prender uma vaga; resposta parada por HTTP_STALL_POLLS é abortada.
+static err_t http_poll(void *arg, struct tcp_pcb *tpcb)
+{
+    struct http_state *hs = (struct http_state *)arg;
+    if (!hs)
+    {
+        return http_close(tpcb, NULL, false);
+    }
+    if (++hs->polls >= HTTP_STALL_POLLS)
+    {
+        return http_close(tpcb, hs, true);
+    }
+    http_send_more(tpcb, hs); // Tenta de novo se o último tcp_write falhou por falta de memória
+    return ERR_OK;
+}
+
+// Erro fatal da conexão: o lwIP já liberou o PCB, resta liberar a resposta e as vagas
+static void http_err(void *arg, err_t err)
+{
+    struct http_state *hs = (struct http_state *)arg;
+    if (hs)
+    {
+        free(hs);
+        admission_release(&admission);
+    }
+    admission_disconnect(&admission);
+}
+
+// Saída de /api/history: cada balde vira uma linha JSON escrita direto na resposta
+typedef struct
+{
+    char *json;
+    size_t room;
+    size_t len;
+    uint32_t rows;
+} history_writer_t;
+
+static void write_history_bucket(const downsample_bucket_t *bucket, void *user_data)
+{
+    history_writer_t *writer = (history_writer_t *)user_data;
+    if (writer->len >= writer->room)
+    {
+        return;
+    }
+    writer->len += snprintf(writer->json + writer->len, writer->room - writer->len,
+                            "%s[%lu,%lu," CENTI_FMT "," CENTI_FMT "," CENTI_FMT "," CENTI_FMT "," CENTI_FMT "," CENTI_FMT "]",
+                            writer->rows ? "," : "",
+                            (unsigned long)bucket->time_ms, (unsigned long)bucket->count,
+                            CENTI_ARGS(bucket->min[0]), CENTI_ARGS(bucket->max[0]),
+                            CENTI_ARGS(bucket->min[1]), CENTI_ARGS(bucket->max[1]),
+                            CENTI_ARGS(bucket->min[2]), CENTI_ARGS(bucket->max[2]));
+    writer->rows++;
+}
+
+#ifdef HTML_DATA_GZ_LEN
+// Indica se o navegador aceita a resposta comprimida com gzip (cabeçalho Accept-Encoding)
+static bool accepts_gzip(const char *req)
+{
+    const char *header = strstr(req, "Accept-Encoding:");
+    if (!header)
+    {
+        return false;
+    }
+    const char *end = strstr(header, "\r\n");
+    const char *gzip = strstr(header, "gzip");
+    return gzip && (!end || gzip < end);
+}
+#endif
+
+// Importa o corpo de upload juntado em hs->response e monta a resposta no lugar dele
+static void http_trace_upload_reply(struct http_state *hs)
+{
+    bool accepted = hs->upload &&
+                    trace_import(&sensor_trace, hs->upload_offset, (const uint8_t *)hs->response, hs->upload_len);
+
+    char json_data[96];
+    snprintf(json_data, sizeof(json_data), "{\"accepted\":%s,\"received\":%lu,\"frames\":%u}",
+             accepted ? "true" : "false", (unsigned long)sensor_trace.imported, sensor_trace.count);
+    hs->len = snprintf(hs->response, sizeof(hs->response),
+                       "HTTP/1.1 %s\r\n"
+                       "Content-Type: application/json\r\n"
+                       "Access-Control-Allow-Origin: *\r\n"
+                       "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                       "Access-Control-Allow-Headers: Content-Type\r\n"
+                       "Content-Length: %d\r\n"
+                       "\r\n"
+                       "%s",
+                       accepted ? "200 OK" : "400 Bad Request",
+                       (int)strlen(json_data), json_data);
+}
+
+// Função de recebimento HTTP
+static err_t http_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err)
+{
+    if (!p)
+    {
+        return http_close(tpcb, (struct http_state *)arg, false);
+    }
+    tcp_recved(tpcb, p->tot_len);
+    if (arg)
+    {
+        struct http_state *hs = (struct http_state *)arg;
+        if (hs->upload_received < hs->upload_len)
+        {
+            // Resto do corpo de um upload: a resposta só sai com o corpo completo
+            hs->upload_received += pbuf_copy_partial(p, hs->response + hs->upload_received,
+                                                     hs->upload_len - hs->upload_received, 0);
+            hs->polls = 0;
+            if (hs->upload_received == hs->upload_len)
+            {
+                http_trace_upload_reply(hs);
+                http_send_more(tpcb, hs);
+            }
+        }
+        // Uma resposta por conexão (Connection: close): o que chegar depois é descartado
+        pbuf_free(p);
+        return ERR_OK;
+    }
+
+    char *req = (char *)p->payload;
+
+    // Admissão antes de alocar: rotas /api/ são leves e têm vaga reservada; a página e o download
+    // do trace (~17 KB cada) entram na classe pesada
+    const char *path = strchr(req, ' ');
+    admission_class_t cls = path && strncmp(path + 1, "/api/", 5) == 0 && strncmp(path + 1, "/api/trace ", 11) != 0
+                                ? ADMISSION_CLASS_API
+                                : ADMISSION_CLASS_PAGE;
+    uint32_t retry_after_s;
+    if (admission_request(&admission, ip4_addr_get_u32(ip_2_ip4(&tpcb->remote_ip)), cls,
+                          to_ms_since_boot(get_absolute_time()), &retry_after_s) != ADMISSION_ACCEPT)
+    {
+        pbuf_free(p);
+        return http_reject(tpcb, retry_after_s, true);
+    }
+
+    struct http_state *hs = malloc(sizeof(struct http_state));
+    if (!hs)
+    {
+        admission_release(&admission);
+        pbuf_free(p);
+        return http_reject(tpcb, 1, true);
+    }
+    hs->queued = 0;
+    hs->sent = 0;
+    hs->polls = 0;
+    hs->upload = false;
+    hs->upload_len = 0;
+    hs->upload_received = 0;
+
+    if (strstr(req, "POST /api/limits"))
+    {
+        char *body = strstr(req, "\r\n\r\n");
+        if (body)
+        {
+            body += 4;
+            int max_val, min_val;
+            float offset_val = 0.0f;
+            if (sscanf(body, "{\"min\":%d,\"max\":%d,\"offset\":%f", &min_val, &max_val, &offset_val) == 3)
+            {
+                // **DEBUG: Mostra os limites recebidos**
+                printf("Limites recebidos: Max=%d, Min=%d, Offset=%f\n", max_val, min_val, offset_val);
+                if (max_val >= 0 && max_val <= 100 && min_val >= -50 && min_val <= 50)
+                {
+                    // Aplicados (e gravados na flash) pelo laço principal, único escritor de weather_data
+                    pending_limits.max = max_val;
+                    pending_limits.min = min_val;
+                    // Entrada em °C: convertida uma única vez, aqui, para centésimos
+                    pending_limits.offset = to_centi(offset_val);
+                    limits_request = LIMITS_REQUEST_SET;
+                    power_request_wake();
+                }
+            }
+        }
+
+        const char *txt = "Limites atualizados";
+        hs->len = snprintf(hs->response, sizeof(hs->response),
+                           "HTTP/1.1 200 OK\r\n"
+                           "Content-Type: text/plain\r\n"
+                           "Access-Control-Allow-Origin: *\r\n"
+                           "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                           "Access-Control-Allow-Headers: Content-Type\r\n"
+                           "Content-Length: %d\r\n"
+                           "\r\n"
+                           "%s",
+                           (int)strlen(txt), txt);
+    }
+    else if (strstr(req, "POST /api/qnh"))
+    {
+        char *body = strstr(req, "\r\n\r\n");
+        bool updated = false;
+        if (body)
+        {
+            body += 4;
+            float qnh_hpa;
+            if (sscanf(body, "{\"qnh\":%f", &qnh_hpa) == 1)
+            {
+                int32_t qnh_pa = (int32_t)(qnh_hpa * 100.0f + 0.5f); // Converte hPa para Pa
+                updated = qnh_pa >= ALTITUDE_QNH_MIN_PA && qnh_pa <= ALTITUDE_QNH_MAX_PA;
+                if (updated)
+                {
+                    pending_qnh_pa = qnh_pa; // Aplicado (e gravado na flash) pelo laço principal
+                    power_request_wake();
+                }
+            }
+        }
+
+        const char *txt = updated ? "QNH atualizado" : "QNH invalido";
+        hs->len = snprintf(hs->response, sizeof(hs->response),
+                           "HTTP/1.1 %s\r\n"
+                           "Content-Type: text/plain\r\n"
+                           "Access-Control-Allow-Origin: *\r\n"
+                           "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                           "Access-Control-Allow-Headers: Content-Type\r\n"
+                           "Content-Length: %d\r\n"
+                           "\r\n"
+                           "%s",
+                           updated ? "200 OK" : "400 Bad Request",
+                           (int)strlen(txt), txt);
+    }
+    else if (strstr(req, "POST /api/bmp280"))
+    {
+        char *body = strstr(req, "\r\n\r\n");
+        bool updated = false;
+        if (body)
+        {
+            body += 4;
+            char name[24];
+            bmp280_profile_t profile;
+            if (sscanf(body, "{\"profile\":\"%23[^\"]\"", name) == 1 && bmp280_profile_from_name(name, &profile))
+            {
+                pending_bmp_profile = profile; // Aplicado pelo laço principal
+                power_request_wake();
+                updated = true;
+            }
+        }
+
+        const char *txt = updated ? "Perfil atualizado" : "Perfil invalido";
+        hs->len = snprintf(hs->response, sizeof(hs->response),
+                           "HTTP/1.1 %s\r\n"
+                           "Content-Type: text/plain\r\n"
+                           "Access-Control-Allow-Origin: *\r\n"
+                           "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                           "Access-Control-Allow-Headers: Content-Type\r\n"
+                           "Content-Length: %d\r\n"
+                           "\r\n"
+                           "%s",
+                           updated ? "200 OK" : "400 Bad Request",
+                           (int)strlen(txt), txt);
+    }
+    else if (strstr(req, "POST /api/sampler"))
+    {
+        char *body = strstr(req, "\r\n\r\n");
+        bool updated = false;
+        if (body && !sampler_config_pending)
+        {
+            body += 4;
+            unsigned long min_ms, max_ms;
+            float temp_db, humidity_db, pressure_db;
+            if (sscanf(body, "{\"minInterval\":%lu,\"maxInterval\":%lu,\"tempDeadband\":%f,\"humidityDeadband\":%f,\"pressureDeadband\":%f",
+                       &min_ms, &max_ms, &temp_db, &humidity_db, &pressure_db) == 5)
+            {
+                sampler_config_t config = sampler.config;
+                config.min_interval_ms = min_ms;
+                config.max_interval_ms = max_ms;
+                config.temp_deadband = to_centi(temp_db);         // °C para centésimos
+                config.humidity_deadband = to_centi(humidity_db); // % para centésimos
+                config.pressure_deadband = to_centi(pressure_db); // hPa para Pa
+
+                // Validada aqui para responder à requisição; aplicada pelo laço principal
+                sampler_t check;
+                sampler_init(&check, NULL);
+                if (sampler_set_config(&check, &config))
+                {
+                    pending_sampler_config = config;
+                    sampler_config_pending = true;
+                    power_request_wake();
+                    updated = true;
+                }
+            }
+        }
+
+        const char *txt = updated ? "Amostragem atualizada" : "Amostragem invalida";
+        hs->len = snprintf(hs->response, sizeof(hs->response),
+                           "HTTP/1.1 %s\r\n"
+                           "Content-Type: text/plain\r\n"
+                           "Access-Control-Allow-Origin: *\r\n"
+                           "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                           "Access-Control-Allow-Headers: Content-Type\r\n"
+                           "Content-Length: %d\r\n"
+                           "\r\n"
+                           "%s",
+                           updated ? "200 OK" : "400 Bad Request",
+                           (int)strlen(txt), txt);
+    }
+    else if (strstr(req, "POST /api/power"))
+    {
+        char *body = strstr(req, "\r\n\r\n");
+        bool updated = false;
+        if (body)
+        {
+            body += 4;
+            char name[24];
+            power_mode_t mode;
+            if (sscanf(body, "{\"mode\":\"%23[^\"]\"", name) == 1 && power_mode_from_name(name, &mode))
+            {
+                pending_power_mode = mode; // Aplicado pelo laço principal
+                power_request_wake();
+                updated = true;
+            }
+        }
+
+        const char *txt = updated ? "Modo de energia atualizado" : "Modo de energia invalido";
+        hs->len = snprintf(hs->response, sizeof(hs->response),
+                           "HTTP/1.1 %s\r\n"
+                           "Content-Type: text/plain\r\n"
+                           "Access-Control-Allow-Origin: *\r\n"
+                           "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                           "Access-Control-Allow-Headers: Content-Type\r\n"
+                           "Content-Length: %d\r\n"
+                           "\r\n"
+                           "%s",
+                           updated ? "200 OK" : "400 Bad Request",
+                           (int)strlen(txt), txt);
+    }
+    else if (strstr(req, "GET /api/power"))
+    {
+        power_report_t report;
+        power_get_report(&report);
+
+        char json_data[512];
+        snprintf(json_data, sizeof(json_data),
+                 "{\"mode\":\"%s\",\"elapsedMs\":%lu,\"awakeMs\":%lu,\"sleepMs\":%lu,\"dutyCycle\":%.1f,"
+                 "\"wakeups\":%lu,\"samples\":%lu,\"avgCurrentMa\":%.2f,\"chargeMah\":%.3f,\"chargePerSampleUc\":%lu,"
+                 "\"sampleIntervalMs\":%lu,\"bmpProfile\":\"%s\"}",
+                 power_mode_name(report.mode),
+                 (unsigned long)report.elapsed_ms, (unsigned long)report.awake_ms, (unsigned long)report.sleep_ms,
+                 report.duty_permille / 10.0f,
+                 (unsigned long)report.wakeups, (unsigned long)report.samples,
+                 report.avg_current_ua / 1000.0f, report.charge_uah / 1000.0f,
+                 (unsigned long)report.charge_per_sample_uc,
+                 (unsigned long)sampler_interval_ms(&sampler),
+                 bmp280_get_profile_config(bmp280_get_profile(&bmp280))->name);
+
+        hs->len = snprintf(hs->response, sizeof(hs->response),
+                           "HTTP/1.1 200 OK\r\n"
+                           "Content-Type: application/json\r\n"
+                           "Access-Control-Allow-Origin: *\r\n"
+                           "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                           "Access-Control-Allow-Headers: Content-Type\r\n"
+                           "Content-Length: %d\r\n"
+                           "\r\n"
+                           "%s",
+                           (int)strlen(json_data), json_data);
+    }
+    else if (strstr(req, "POST /api/time"))
+    {
+        // Troca o servidor SNTP (nome ou IP, ex.: um servidor NTP local para testes); não é gravado na flash
+        char *body = strstr(req, "\r\n\r\n");
+        bool updated = false;
+        if (body)
+        {
+            body += 4;
+            char server[sizeof(ntp_server)];
+            if (sscanf(body, "{\"server\":\"%63[^\"]\"", server) == 1)
+            {
+                strcpy(ntp_server, server);
+                start_sntp(); // Já na pilha de rede; consulta o novo servidor na hora
+                updated = true;
+            }
+        }
+
+        const char *txt = updated ? "Servidor SNTP atualizado" : "Servidor SNTP invalido";
+        hs->len = snprintf(hs->response, sizeof(hs->response),
+                           "HTTP/1.1 %s\r\n"
+                           "Content-Type: text/plain\r\n"
+                           "Access-Control-Allow-Origin: *\r\n"
+                           "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                           "Access-Control-Allow-Headers: Content-Type\r\n"
+                           "Content-Length: %d\r\n"
+                           "\r\n"
+                           "%s",
+                           updated ? "200 OK" : "400 Bad Request",
+                           (int)strlen(txt), txt);
+    }
+    else if (strstr(req, "GET /api/time"))
+    {
+        uint64_t now_us = time_us_64();
+        char unix_ms[24];
+        sample_clock_report_t clock;
+        sample_clock_get_report(&sample_clock, &clock);
+
+        char json_data[1024];
+        int json_len = snprintf(json_data, sizeof(json_data),
+                                "{\"uptimeMs\":%lu,\"unixMs\":%s,"
+                                "\"sntp\":{\"server\":\"%s\",\"synced\":%s,\"syncs\":%lu,\"steps\":%lu,"
+                                "\"lastOffsetUs\":%lld,\"freqPpb\":%ld,\"lastSyncAgoMs\":%lu},"
+                                "\"sampleClock\":{\"hardwareAlarm\":%s,\"nextTickUs\":%llu,\"samples\":%lu,\"missed\":%lu,"
+                                "\"meanJitterUs\":%lu,\"maxJitterUs\":%lu,\"maxIrqLatencyUs\":%lu,\"jitterHistogram\":[",
+                                (unsigned long)(now_us / 1000), unix_ms_str(wallclock_unix_us(&wall_clock, now_us), unix_ms, sizeof(unix_ms)),
+                                ntp_server, wall_clock.synced ? "true" : "false",
+                                (unsigned long)wall_clock.syncs, (unsigned long)wall_clock.steps,
+                                (long long)wall_clock.last_offset_us, (long)wall_clock.freq_ppb,
+                                wall_clock.synced ? (unsigned long)((now_us - wall_clock.base_mono_us) / 1000) : 0ul,
+                                sample_clock.alarm >= 0 ? "true" : "false",
+                                (unsigned long long)sample_clock_tick_us(&sample_clock),
+                                (unsigned long)clock.ticks, (unsigned long)clock.missed,
+                                clock.ticks ? (unsigned long)(clock.jitter_sum_us / clock.ticks) : 0ul,
+                                (unsigned long)clock.max_jitter_us, (unsigned long)clock.max_irq_latency_us);
+        for (int i = 0; i < SAMPLE_CLOCK_BUCKETS; i++)
+        {
+            json_len += snprintf(json_data + json_len, sizeof(json_data) - json_len, "%s%lu", i ? "," : "",
+                                 (unsigned long)clock.histogram[i]);
+        }
+        snprintf(json_data + json_len, sizeof(json_data) - json_len, "]}}");
+
+        hs->len = snprintf(hs->response, sizeof(hs->response),
+                           "HTTP/1.1 200 OK\r\n"
+                           "Content-Type: application/json\r\n"
+                           "Access-Control-Allow-Origin: *\r\n"
+                           "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                           "Access-Control-Allow-Headers: Content-Type\r\n"
+                           "Content-Length: %d\r\n"
+                           "\r\n"
+                           "%s",
+                           (int)strlen(json_data), json_data);
+    }
+    else if (strstr(req, "POST /api/alerts"))
+    {
+        // Regras de usuário (índices 2 a 7); as regras 0 e 1 seguem /api/limits
+        char *body = strstr(req, "\r\n\r\n");
+        bool updated = false;
+        if (body && pending_alert_index < 0)
+        {
+            body += 4;
+            int index;
+            char metric_name[16], condition_name[16], action_name[16], enabled[6];
+            float threshold, hysteresis;
+            unsigned long window_s, duration_s, cooldown_s;
+            alert_metric_t metric;
+            alert_condition_t condition;
+            alert_action_t action;
+            if (sscanf(body, "{\"index\":%d,\"metric\":\"%15[^\"]\",\"condition\":\"%15[^\"]\",\"threshold\":%f,\"hysteresis\":%f,"
+                             "\"window\":%lu,\"duration\":%lu,\"cooldown\":%lu,\"action\":\"%15[^\"]\",\"enabled\":%5[a-z]",
+                       &index, metric_name, condition_name, &threshold, &hysteresis,
+                       &window_s, &duration_s, &cooldown_s, action_name, enabled) == 10 &&
+                index >= ALERT_USER_RULE_FIRST && index < ALERT_MAX_RULES &&
+                alert_metric_from_name(metric_name, &metric) &&
+                alert_condition_from_name(condition_name, &condition) &&
+                alert_action_from_name(action_name, &action))
+            {
+                alert_rule_t rule = {
+                    .metric = metric,
+                    .condition = condition,
+                    .action = action,
+                    .enabled = strcmp(enabled, "true") == 0,
+                    .threshold = to_centi(threshold),   // Unidade exibida para centésimos
+                    .hysteresis = to_centi(hysteresis),
+                    .window_s = window_s,
+                    .duration_s = duration_s,
+                    .cooldown_s = cooldown_s,
+                };
+
+                // Validada aqui para responder à requisição; aplicada pelo laço principal
+                if (alert_rule_valid(&rule))
+                {
+                    pending_alert_rule = rule;
+                    pending_alert_index = (int8_t)index;
+                    power_request_wake();
+                    updated = true;
+                }
+            }
+        }
+
+        const char *txt = updated ? "Regra de alerta atualizada" : "Regra de alerta invalida";
+        hs->len = snprintf(hs->response, sizeof(hs->response),
+                           "HTTP/1.1 %s\r\n"
+                           "Content-Type: text/plain\r\n"
+                           "Access-Control-Allow-Origin: *\r\n"
+                           "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                           "Access-Control-Allow-Headers: Content-Type\r\n"
+                           "Content-Length: %d\r\n"
+                           "\r\n"
+                           "%s",
+                           updated ? "200 OK" : "400 Bad Request",
+                           (int)strlen(txt), txt);
+    }
+    else if (strstr(req, "GET /api/alerts"))
+    {
+        alerts_snapshot_t snapshot;
+        snapshot_read(&alerts_snapshot, &snapshot);
+
+        // Monta o corpo diretamente no buffer de resposta, após um espaço reservado para o cabeçalho
+        const size_t header_room = 256;
+        char *json_data = hs->response + header_room;
+        size_t room = sizeof(hs->response) - header_room;
+        int json_len = snprintf(json_data, room, "{\"buzzers\":%s,\"rules\":[", is_alert_active ? "true" : "false");
+        for (int i = 0; i < ALERT_MAX_RULES; i++)
+        {
+            const alert_view_t *view = &snapshot.rules[i];
+            char value[16] = "null";
+            if (view->has_value)
+                snprintf(value, sizeof(value), CENTI_FMT, CENTI_ARGS(view->value));
+            json_len += snprintf(json_data + json_len, room - json_len,
+                                 "%s{\"index\":%d,\"metric\":\"%s\",\"condition\":\"%s\",\"threshold\":" CENTI_FMT ",\"hysteresis\":" CENTI_FMT ","
+                                 "\"window\":%lu,\"duration\":%lu,\"cooldown\":%lu,\"action\":\"%s\",\"enabled\":%s,"
+                                 "\"status\":\"%s\",\"value\":%s,\"fired\":%lu,\"suppressed\":%lu,\"lastFiredMs\":%lu}",
+                                 i ? "," : "", i,
+                                 alert_metric_name(view->rule.metric), alert_condition_name(view->rule.condition),
+                                 CENTI_ARGS(view->rule.threshold), CENTI_ARGS(view->rule.hysteresis),
+                                 (unsigned long)view->rule.window_s, (unsigned long)view->rule.duration_s,
+                                 (unsigned long)view->rule.cooldown_s, alert_action_name(view->rule.action),
+                                 view->rule.enabled ? "true" : "false",
+                                 alert_status_str(view->status), value,
+                                 (unsigned long)view->fired, (unsigned long)view->suppressed,
+                                 (unsigned long)view->fired_ms);
+        }
+        json_len += snprintf(json_data + json_len, room - json_len, "]}");
+
+        char header[256];
+        int header_len = snprintf(header, sizeof(header),
+                                  "HTTP/1.1 200 OK\r\n"
+                                  "Content-Type: application/json\r\n"
+                                  "Access-Control-Allow-Origin: *\r\n"
+                                  "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                                  "Access-Control-Allow-Headers: Content-Type\r\n"
+                                  "Content-Length: %d\r\n"
+                                  "\r\n",
+                                  json_len);
+        memmove(hs->response + header_len, json_data, json_len);
+        memcpy(hs->response, header, header_len);
+        hs->len = header_len + json_len;
+    }
+    else if (strstr(req, "POST /api/trace/upload"))
+    {
+        // Parte de um trace exportado (corpo binário). O corpo é juntado na resposta, ainda vazia, até
+        // Content-Length; se não chegar todo neste segmento, o restante vem nas próximas chamadas.
+        char *query = strstr(req, "offset=");
+        char *length = strstr(req, "Content-Length:");
+        unsigned long offset, expected;
+        u16_t header_end = pbuf_memfind(p, "\r\n\r\n", 4, 0);
+        if (query && sscanf(query, "offset=%lu", &offset) == 1 && header_end != 0xFFFF &&
+            length && sscanf(length, "Content-Length: %lu", &expected) == 1 && expected <= sizeof(hs->response))
+        {
+            hs->upload = true;
+            hs->upload_offset = offset;
+            hs->upload_len = expected;
+            hs->upload_received = pbuf_copy_partial(p, hs->response, expected, header_end + 4);
+        }
+        if (hs->upload_received == hs->upload_len)
+        {
+            http_trace_upload_reply(hs);
+        }
+    }
+    else if (strstr(req, "POST /api/trace"))
+    {
+        char *body = strstr(req, "\r\n\r\n");
+        bool updated = false;
+        if (body)
+        {
+            body += 4;
+            char mode[16];
+            if (sscanf(body, "{\"mode\":\"%15[^\"]\"", mode) == 1)
+            {
+                // Aplicado pelo laço principal
+                updated = true;
+                if (strcmp(mode, "record") == 0)
+                {
+                    trace_request = TRACE_REQUEST_RECORD;
+                }
+                else if (strcmp(mode, "replay") == 0)
+                {
+                    pending_trace_speed = strstr(body, "\"speed\":\"max\"") ? TRACE_SPEED_MAX : TRACE_SPEED_REALTIME;
+                    trace_request = TRACE_REQUEST_REPLAY;
+                }
+                else if (strcmp(mode, "stop") == 0)
+                {
+                    trace_request = TRACE_REQUEST_STOP;
+                }
+                else
+                {
+                    updated = false;
+                }
+                if (updated)
+                {
+                    power_request_wake();
+                }
+            }
+        }
+
+        const char *txt = updated ? "Trace atualizado" : "Modo de trace invalido";
+        hs->len = snprintf(hs->response, sizeof(hs->response),
+                           "HTTP/1.1 %s\r\n"
+                           "Content-Type: text/plain\r\n"
+                           "Access-Control-Allow-Origin: *\r\n"
+                           "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                           "Access-Control-Allow-Headers: Content-Type\r\n"
+                           "Content-Length: %d\r\n"
+                           "\r\n"
+                           "%s",
+                           updated ? "200 OK" : "400 Bad Request",
+                           (int)strlen(txt), txt);
+    }
+    else if (strstr(req, "GET /api/trace/status"))
+    {
+        static const char *const mode_names[] = {"idle", "recording", "replaying"};
+        uint64_t now_us = time_us_64();
+        uint64_t elapsed_us = 0;
+        if (sensor_trace.started_us)
+        {
+            elapsed_us = (sensor_trace.finished_us ? sensor_trace.finished_us : now_us) - sensor_trace.started_us;
+        }
+        uint32_t replayed = sensor_trace.replayed;
+
+        char json_data[384];
+        snprintf(json_data, sizeof(json_data),
+                 "{\"mode\":\"%s\",\"frames\":%u,\"capacity\":%d,\"dropped\":%lu,\"received\":%lu,"
+                 "\"replay\":{\"speed\":\"%s\",\"position\":%u,\"frames\":%lu,\"elapsedMs\":%.1f,"
+                 "\"framesPerSecond\":%.1f,\"avgFrameUs\":%lu,\"maxFrameUs\":%lu}}",
+                 mode_names[sensor_trace.mode], sensor_trace.count, TRACE_FRAMES,
+                 (unsigned long)sensor_trace.dropped, (unsigned long)sensor_trace.imported,
+                 sensor_trace.speed == TRACE_SPEED_MAX ? "max" : "1x", sensor_trace.cursor,
+                 (unsigned long)replayed, elapsed_us / 1000.0,
+                 elapsed_us ? replayed * 1e6 / elapsed_us : 0.0,
+                 (unsigned long)(replayed ? sensor_trace.busy_us / replayed : 0),
+                 (unsigned long)sensor_trace.max_frame_us);
+
+        hs->len = snprintf(hs->response, sizeof(hs->response),
+                           "HTTP/1.1 200 OK\r\n"
+                           "Content-Type: application/json\r\n"
+                           "Access-Control-Allow-Origin: *\r\n"
+                           "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                           "Access-Control-Allow-Headers: Content-Type\r\n"
+                           "Content-Length: %d\r\n"
+                           "\r\n"
+                           "%s",
+                           (int)strlen(json_data), json_data);
+    }
+    else if (strstr(req, "GET /api/trace"))
+    {
+        // Trace binário (formato em lib/trace/trace.h), montado depois do espaço do cabeçalho
+        uint8_t *trace_data = (uint8_t *)hs->response + 256;
+        size_t trace_len = trace_export(&sensor_trace, trace_data, sizeof(hs->response) - 256);
+
+        int header_len = snprintf(hs->response, 256,
+                                  "HTTP/1.1 200 OK\r\n"
+                                  "Content-Type: application/octet-stream\r\n"
+                                  "Content-Disposition: attachment; filename=\"trace.wxt\"\r\n"
+                                  "Access-Control-Allow-Origin: *\r\n"
+                                  "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                                  "Access-Control-Allow-Headers: Content-Type\r\n"
+                                  "Content-Length: %d\r\n"
+                                  "\r\n",
+                                  (int)trace_len);
+        memmove(hs->response + header_len, trace_data, trace_len);
+        hs->len = header_len + trace_len;
+    }
+    else if (strstr(req, "GET /api/stats"))
+    {
+        static const char *const metric_names[STATS_METRICS] = {"temperature", "humidity", "pressure"};
+        stats_snapshot_t snapshot;
+        snapshot_read(&stats_snapshot, &snapshot);
+
+        // Monta o corpo diretamente no buffer de resposta, após um espaço reservado para o cabeçalho
+        const size_t header_room = 256;
+        char *json_data = hs->response + header_room;
+        size_t room = sizeof(hs->response) - header_room;
+        int json_len = snprintf(json_data, room, "{\"windows\":[");
+        for (int w = 0; w < STATS_WINDOWS; w++)
+        {
+            const stats_window_summary_t *window = &snapshot.windows[w];
+            json_len += snprintf(json_data + json_len, room - json_len, "%s{\"windowS\":%lu,\"samples\":%lu",
+                                 w ? "," : "", (unsigned long)window->window_s, (unsigned long)window->count);
+            for (int m = 0; m < STATS_METRICS; m++)
+            {
+                // Centésimos de °C e de %, e Pa: todos convertidos com /100 (a pressão para hPa)
+                const stats_metric_summary_t *metric = &window->metrics[m];
+                json_len += snprintf(json_data + json_len, room - json_len,
+                                     ",\"%s\":{\"min\":" CENTI_FMT ",\"max\":" CENTI_FMT
+                                     ",\"mean\":%.2f,\"stddev\":%.2f,\"slopePerHour\":%.3f}",
+                                     metric_names[m], CENTI_ARGS(metric->min), CENTI_ARGS(metric->max),
+                                     metric->mean / 100.0f, metric->stddev / 100.0f, metric->slope_per_hour / 100.0f);
+            }
+            json_len += snprintf(json_data + json_len, room - json_len, "}");
+        }
+        json_len += snprintf(json_data + json_len, room - json_len, "]}");
+
+        char header[256];
+        int header_len = snprintf(header, sizeof(header),
+                                  "HTTP/1.1 200 OK\r\n"
+                                  "Content-Type: application/json\r\n"
+                                  "Access-Control-Allow-Origin: *\r\n"
+                                  "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                                  "Access-Control-Allow-Headers: Content-Type\r\n"
+                                  "Content-Length: %d\r\n"
+                                  "\r\n",
+                                  json_len);
+        memmove(hs->response + header_len, json_data, json_len);
+        memcpy(hs->response, header, header_len);
+        hs->len = header_len + json_len;
+    }
+    else if (strstr(req, "GET /api/history"))
+    {
+        // GET /api/history?points=<n>&window=<s>: últimos window segundos (padrão: todo o registro)
+        // reduzidos a até n baldes com mínimo e máximo, em uma única passada pelo registro
+        unsigned long points = HISTORY_POINTS_DEFAULT, window_s = 0;
+        char *query = strstr(req, "points=");
+        if (query)
+            sscanf(query, "points=%lu", &points);
+        query = strstr(req, "window=");
+        if (query)
+            sscanf(query, "window=%lu", &window_s);
+        if (points == 0 || points > HISTORY_POINTS_MAX)
+            points = HISTORY_POINTS_MAX;
+
+        const size_t header_room = 256;
+        history_writer_t writer = {
+            .json = hs->response + header_room,
+            .room = sizeof(hs->response) - header_room,
+        };
+
+        uint32_t first_ms, last_ms;
+        uint32_t from_ms = 0, to_ms = 0;
+        bool has_samples = sample_log_time_range(&sample_log, &first_ms, &last_ms);
+        if (has_samples)
+        {
+            from_ms = first_ms;
+            // Em 64 bits: uma janela acima de ~49 dias em ms não cabe em 32 e deve cobrir o registro todo
+            if (window_s && last_ms - first_ms > (uint64_t)window_s * 1000)
+                from_ms = last_ms - window_s * 1000;
+            to_ms = last_ms;
+        }
+
+        downsample_t ds;
+        downsample_init(&ds, from_ms, to_ms, points, write_history_bucket, &writer);
+        uint64_t now_us = time_us_64();
+        char unix_ms[24];
+        writer.len = snprintf(writer.json, writer.room,
+                              "{\"uptimeMs\":%lu,\"unixMs\":%s,\"from\":%lu,\"to\":%lu,\"bucketMs\":%lu,"
+                              "\"fields\":[\"timeMs\",\"count\",\"temperatureMin\",\"temperatureMax\","
+                              "\"humidityMin\",\"humidityMax\",\"pressureMin\",\"pressureMax\"],\"buckets\":[",
+                              (unsigned long)(now_us / 1000), unix_ms_str(wall_clock_unix_us(now_us), unix_ms, sizeof(unix_ms)),
+                              (unsigned long)from_ms,
+                              (unsigned long)to_ms, (unsigned long)downsample_width_ms(&ds));
+
+        if (has_samples)
+        {
+            sample_log_cursor_t cursor;
+            sample_record_t record;
+            sample_log_seek(&sample_log, &cursor, sample_log_seq_at(&sample_log, from_ms) - 1);
+            while (sample_log_next(&cursor, &record))
+            {
+                downsample_add(&ds, record.time_ms,
+                               (const int32_t[DOWNSAMPLE_CHANNELS]){record.temperature, record.humidity,
+                                                                    (int32_t)record.pressure});
+            }
+            downsample_finish(&ds);
+        }
+        if (writer.len < writer.room)
+            writer.len += snprintf(writer.json + writer.len, writer.room - writer.len, "]}");
+
+        int json_len = (int)(writer.len < writer.room ? writer.len : writer.room - 1);
+        char header[256];
+        int header_len = snprintf(header, sizeof(header),
+                                  "HTTP/1.1 200 OK\r\n"
+                                  "Content-Type: application/json\r\n"
+                                  "Access-Control-Allow-Origin: *\r\n"
+                                  "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                                  "Access-Control-Allow-Headers: Content-Type\r\n"
+                                  "Content-Length: %d\r\n"
+                                  "\r\n",
+                                  json_len);
+        memmove(hs->response + header_len, writer.json, json_len);
+        memcpy(hs->response, header, header_len);
+        hs->len = header_len + json_len;
+    }
+    else if (strstr(req, "GET /api/samples"))
+    {
+        // GET /api/samples?since=<seq>&limit=<n>: amostras com seq > since, em páginas limitadas
+        unsigned long since = 0, limit = SAMPLES_PAGE_MAX;
+        char *query = strstr(req, "since=");
+        if (query)
+            sscanf(query, "since=%lu", &since);
+        query = strstr(req, "limit=");
+        if (query)
+            sscanf(query, "limit=%lu", &limit);
+        if (limit == 0 || limit > SAMPLES_PAGE_MAX)
+            limit = SAMPLES_PAGE_MAX;
+
+        uint32_t first = sample_log_first_seq(&sample_log);
+        uint32_t last = sample_log_last_seq(&sample_log);
+
+        // since além da última amostra indica que a estação reiniciou: recomeça do início
+        bool reset = since > last;
+        if (reset)
+            since = 0;
+
+        // Monta o corpo diretamente no buffer de resposta (a pilha é pequena), após um espaço
+        // reservado para o cabeçalho
+        const size_t header_room = 256;
+        char *json_data = hs->response + header_room;
+        size_t room = sizeof(hs->response) - header_room;
+        uint64_t now_us = time_us_64();
+        char unix_ms[24];
+        int json_len = snprintf(json_data, room,
+                                "{\"uptimeMs\":%lu,\"unixMs\":%s,\"first\":%lu,\"last\":%lu,\"reset\":%s,\"gap\":%s,"
+                                "\"fields\":[\"seq\",\"timeMs\",\"temperature\",\"humidity\",\"pressure\"],\"samples\":[",
+                                (unsigned long)(now_us / 1000), unix_ms_str(wall_clock_unix_us(now_us), unix_ms, sizeof(unix_ms)),
+                                (unsigned long)first, (unsigned long)last, reset ? "true" : "false",
+                                since < last && since + 1 < first ? "true" : "false");
+
+        sample_log_cursor_t cursor;
+        sample_record_t record;
+        uint32_t next = since;
+        sample_log_seek(&sample_log, &cursor, since);
+        for (unsigned long i = 0; i < limit && sample_log_next(&cursor, &record); i++)
+        {
+            json_len += snprintf(json_data + json_len, room - json_len,
+                                 "%s[%lu,%lu," CENTI_FMT "," CENTI_FMT "," CENTI_FMT "]", i ? "," : "",
+                                 (unsigned long)record.seq, (unsigned long)record.time_ms,
+                                 CENTI_ARGS((int32_t)record.temperature), CENTI_ARGS((int32_t)record.humidity),
+                                 CENTI_ARGS((int32_t)record.pressure));
+            next = record.seq;
+        }
+        json_len += snprintf(json_data + json_len, room - json_len, "],\"next\":%lu,\"more\":%s}",
+                             (unsigned long)next, next < last ? "true" : "false");
+
+        char header[256];
+        int header_len = snprintf(header, sizeof(header),
+                                  "HTTP/1.1 200 OK\r\n"
+                                  "Content-Type: application/json\r\n"
+                                  "Access-Control-Allow-Origin: *\r\n"
+                                  "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                                  "Access-Control-Allow-Headers: Content-Type\r\n"
+                                  "Content-Length: %d\r\n"
+                                  "\r\n",
+                                  json_len);
+        memmove(hs->response + header_len, json_data, json_len);
+        memcpy(hs->response, header, header_len);
+        hs->len = header_len + json_len;
+    }
+    else if (strstr(req, "GET /api/weather"))
+    {
+        weather_snapshot_t snapshot;
+        snapshot_read(&weather_snapshot, &snapshot);
+        const weather_data_t *weather = &snapshot.data;
+        char unix_ms[24];
+
+        char json_data[2048];
+        snprintf(json_data, sizeof(json_data),
+                 "{\"seq\":%lu,\"timestampUs\":%llu,\"unixMs\":%s,\"temperature\":" CENTI_FMT ",\"humidity\":" CENTI_FMT ",\"pressure\":" CENTI_FMT
+                 ",\"altitude\":" CENTI_FMT ",\"minTemperature\":%d,\"maxTemperature\":%d,\"tempOffset\":" CENTI_FMT
+                 ",\"qnh\":" CENTI_FMT ",\"bmpProfile\":\"%s\",\"bmpMeasurementUs\":%lu,"
+                 "\"bmpTemperature\":" CENTI_FMT ",\"ahtTemperature\":" CENTI_FMT ",\"bmpBias\":" CENTI_FMT
+                 ",\"ahtBias\":" CENTI_FMT ",\"dewPoint\":" CENTI_FMT ",\"heatIndex\":" CENTI_FMT
+                 ",\"absoluteHumidity\":" CENTI_FMT ",\"sampleIntervalMs\":%lu,\"sampleReason\":\"%s\"}",
+                 (unsigned long)snapshot.seq, (unsigned long long)weather->timestampUs,
+                 unix_ms_str(weather->unixUs, unix_ms, sizeof(unix_ms)),
+                 CENTI_ARGS(weather->temperature), CENTI_ARGS(weather->humidity),
+                 CENTI_ARGS(weather->pressure), CENTI_ARGS(weather->altitude), // Pa em hPa, cm em m
+                 weather->minTemperature, weather->maxTemperature, CENTI_ARGS(weather->offsetTemperature),
+                 CENTI_ARGS(altitude_get_qnh()),
+                 bmp280_get_profile_config(bmp280_get_profile(&bmp280))->name,
+                 (unsigned long)bmp280_measurement_time_typ_us(bmp280_get_profile(&bmp280)),
+                 CENTI_ARGS(weather->bmpTemperature), CENTI_ARGS(weather->ahtTemperature),
+                 CENTI_ARGS(snapshot.bmp_bias), CENTI_ARGS(snapshot.aht_bias),
+                 CENTI_ARGS(weather->dewPoint), CENTI_ARGS(weather->heatIndex), CENTI_ARGS(weather->absoluteHumidity),
+                 (unsigned long)snapshot.sample_interval_ms, sampler_reason_str(snapshot.sample_reason));
+
+        hs->len = snprintf(hs->response, sizeof(hs->response),
+                           "HTTP/1.1 200 OK\r\n"
+                           "Content-Type: application/json\r\n"
+                           "Access-Control-Allow-Origin: *\r\n"
+                           "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                           "Access-Control-Allow-Headers: Content-Type\r\n"
+                           "Content-Length: %d\r\n"
+                           "\r\n"
+                           "%s",
+                           (int)strlen(json_data), json_data);
+
+        //printf("JSON enviado: %s\n", json_data);
+    }
+    else if (strstr(req, "GET /api/status"))
+    {
+        uint64_t now_us = time_us_64();
+        char unix_ms[24];
+        char json_data[1536];
+        int json_len = snprintf(json_data, sizeof(json_data),
+                                "{\"uptimeMs\":%lu,\"unixMs\":%s,"
+                                "\"boot\":{\"sensorsReadyMs\":%.1f,\"firstSampleMs\":%.1f,\"networkReadyMs\":%.1f,\"ipAcquiredMs\":%.1f,\"firstHttpResponseMs\":%.1f},"
+                                "\"wifi\":{\"state\":\"%s\",\"linkStatus\":%d,\"failures\":%lu,"
+                                "\"connects\":%lu,\"disconnects\":%lu},"
+                                "\"config\":{\"generation\":%lu,\"version\":%u,\"pending\":%s,\"commits\":%lu,\"coalesced\":%lu,\"failures\":%lu},"
+                                "\"history\":{\"first\":%lu,\"last\":%lu,\"bytes\":%lu},"
+                                "\"http\":{\"connections\":%u,\"active\":%u,\"accepted\":%lu,\"busy\":%lu,\"limited\":%lu,\"refused\":%lu},"
+                                "\"bmp280\":%s,"
+                                "\"aht20\":{\"ok\":%lu,\"busy\":%lu,\"crcErrors\":%lu,\"busErrors\":%lu,\"retries\":%lu},"
+                                "\"i2c\":[",
+                                (unsigned long)(now_us / 1000), unix_ms_str(wall_clock_unix_us(now_us), unix_ms, sizeof(unix_ms)),
+                                boot_timing.sensors_ready / 1000.0, boot_timing.first_sample / 1000.0,
+                                boot_timing.network_ready / 1000.0, boot_timing.ip_acquired / 1000.0,
+                                boot_timing.first_http_response / 1000.0,
+                                wifi_supervisor_state_str(wifi.state), wifi.last_status,
+                                (unsigned long)wifi.failures, (unsigned long)wifi.connects,
+                                (unsigned long)wifi.disconnects,
+                                (unsigned long)config_store.generation, (unsigned)config_store.loaded_version,
+                                config_store.dirty ? "true" : "false", (unsigned long)config_store.commits,
+                                (unsigned long)config_store.coalesced, (unsigned long)config_store.failures,
+                                (unsigned long)sample_log_first_seq(&sample_log),
+                                (unsigned long)sample_log_last_seq(&sample_log),
+                                (unsigned long)sample_log_bytes_used(&sample_log),
+                                (unsigned)admission.connections, (unsigned)admission.active,
+                                (unsigned long)admission.accepted, (unsigned long)admission.rejected_busy,
+                                (unsigned long)admission.rejected_rate, (unsigned long)admission.refused,
+                                bmp280.ready ? "true" : "false",
+                                (unsigned long)aht_counters.ok, (unsigned long)aht_counters.busy,
+                                (unsigned long)aht_counters.crc_errors, (unsigned long)aht_counters.bus_errors,
+                                (unsigned long)aht_counters.retries);
+        const i2c_bus_t *buses[] = {&i2c_bus0, &i2c_bus1};
+        for (int i = 0; i < 2; i++)
+        {
+            i2c_bus_stats_t stats;
+            i2c_bus_get_stats(buses[i], &stats);
+            json_len += snprintf(json_data + json_len, sizeof(json_data) - json_len,
+                                 "%s{\"transfers\":%lu,\"naks\":%lu,\"aborts\":%lu,\"timeouts\":%lu,\"queueFull\":%lu,"
+                                 "\"recoveries\":%lu,\"reprobes\":%lu,\"lastLatencyUs\":%lu,\"maxLatencyUs\":%lu,\"lastRecoveryMs\":%lu}",
+                                 i ? "," : "",
+                                 (unsigned long)stats.transfers, (unsigned long)stats.naks, (unsigned long)stats.aborts,
+                                 (unsigned long)stats.timeouts, (unsigned long)stats.queue_full,
+                                 (unsigned long)stats.recoveries, (unsigned long)stats.reprobes,
+                                 (unsigned long)stats.last_latency_us, (unsigned long)stats.max_latency_us,
+                                 (unsigned long)stats.last_recovery_ms);
+        }
+        snprintf(json_data + json_len, sizeof(json_data) - json_len, "]}");
+
+        hs->len = snprintf(hs->response, sizeof(hs->response),
+                           "HTTP/1.1 200 OK\r\n"
+                           "Content-Type: application/json\r\n"
+                           "Access-Control-Allow-Origin: *\r\n"
+                           "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                           "Access-Control-Allow-Headers: Content-Type\r\n"
+                           "Content-Length: %d\r\n"
+                           "\r\n"
+                           "%s",
+                           (int)strlen(json_data), json_data);
+    }
+    else
+    {
+        // **HTML principal** (comprimido quando o navegador aceita gzip)
+        const char *page = html_data;
+        size_t page_len = HTML_DATA_LEN;
+        const char *encoding = "";
+#ifdef HTML_DATA_GZ_LEN
+        if (accepts_gzip(req))
+        {
+            page = (const char *)html_data_gz;
+            page_len = HTML_DATA_GZ_LEN;
+            encoding = "Content-Encoding: gzip\r\n";
+        }
+#endif
+        hs->len = snprintf(hs->response, sizeof(hs->response),
+                           "HTTP/1.1 200 OK\r\n"
+                           "Content-Type: text/html\r\n"
+                           "%s"
+                           "Vary: Accept-Encoding\r\n"
+                           "Content-Length: %d\r\n"
+                           "Connection: close\r\n"
+                           "\r\n",
+                           encoding, (int)page_len);
+        memcpy(hs->response + hs->len, page, page_len);
+        hs->len += page_len;
+    }
+
+    tcp_arg(tpcb, hs);
+    tcp_sent(tpcb, http_sent);
+    http_send_more(tpcb, hs);
+    pbuf_free(p);
+    return ERR_OK;
+}
+
+// Função de callback para aceitar conexões TCP
+static err_t connection_callback(void *arg, struct tcp_pcb *newpcb, err_t err)
+{
+    if (err != ERR_OK || !newpcb)
+    {
+        return ERR_VAL;
+    }
+    if (!admission_connect(&admission))
+    {
+        // Acima do limite de conexões: 503 imediato, sem esperar a requisição
+        return http_reject(newpcb, 1, false);
+    }
+    tcp_arg(newpcb, NULL);
+    tcp_recv(newpcb, http_recv);
+    tcp_err(newpcb, http_err);
+    tcp_poll(newpcb, http_poll, HTTP_POLL_INTERVAL);
+    return ERR_OK;
+}
+
+// Função para iniciar o servidor HTTP
+static void start_http_server(void)
+{
+    cyw43_arch_lwip_begin(); // A pilha de rede roda em interrupção
+    admission_init(&admission);
+    struct tcp_pcb *pcb = tcp_new();
+    if (!pcb)
+    {
+        cyw43_arch_lwip_end();
+        printf("Erro ao criar PCB TCP\n");
+        return;
+    }
+    if (tcp_bind(pcb, IP_ADDR_ANY, 80) != ERR_OK)
+    {
+        tcp_close(pcb);
+        cyw43_arch_lwip_end();
+        printf("Erro ao ligar o servidor na porta 80\n");
+        return;
+    }
+    pcb = tcp_listen(pcb);
+    tcp_accept(pcb, connection_callback);
+    cyw43_arch_lwip_end();
+    printf("Servidor HTTP rodando na porta 80...\n");
+}
+
+// Função de interrupção para os botões
+// Reinicia o dispositivo para o modo de boot USB ou alterna o estado do alerta
+void gpio_irq_handler(uint gpio, uint32_t events)
+{
+    int current_time = to_ms_since_boot(get_absolute_time());
+
+    if (gpio == BTN_SW_PIN && (current_time - last_button_sw_press_time > 300))
+    {
+        // Atualiza o tempo do último pressionamento do botão SW
+        last_button_sw_press_time = current_time;
 
         is_simulated = !is_simulated; // Alterna o estado de simulação
     }
@@ -480,36 +2203,53 @@ void gpio_irq_handler(uint gpio, uint32_t events)
 
         // Alterna o estado do alerta
         is_alert_active = !is_alert_active;
+        power_request_wake(); // Agenda a gravação na flash
     }
     else if (gpio == BTN_B_PIN && (current_time - last_button_b_press_time > 300))
     {
         // Atualiza o tempo do último pressionamento do botão B
         last_button_b_press_time = current_time;
 
-        weather_data.minTemperature = 10;  // Reseta o limite mínimo de temperatura
-        weather_data.maxTemperature = 70; // Reseta o limite máximo de temperatura
+        // Restaura os limites de fábrica (aplicados e gravados na flash pelo laço principal)
+        limits_request = LIMITS_REQUEST_RESET;
+        power_request_wake();
     }
 }
 
-// Função para tentar conectar ao Wi-Fi
-// Retorna true se a conexão for bem-sucedida, false caso contrário
-bool try_wifi_connect()
+// Sinaliza o estado da conexão Wi-Fi no LED RGB e no terminal
+static void on_wifi_state(wifi_state_t state, void *context)
 {
-    printf("Tentando conectar ao Wi-Fi '%s'...\n", WIFI_SSID);
-
-    set_led_blue_pwm(); // LED azul para indicar tentativa de conexão
+    switch (state)
+    {
+    case WIFI_STATE_CONNECTING:
+        printf("Tentando conectar ao Wi-Fi '%s'...\n", WIFI_SSID);
+        set_led_blue_pwm(); // LED azul para indicar tentativa de conexão
+        break;
 
-    // Tenta conectar com timeout de 10 segundos
-    if (cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, 10000))
+    case WIFI_STATE_CONNECTED:
     {
-        printf("Falha ao conectar ao Wi-Fi\n");
-        set_led_red_pwm(); // LED vermelho para falha
-        return false;
+        if (!boot_timing.ip_acquired)
+        {
+            boot_timing.ip_acquired = time_us_64();
+        }
+        uint8_t *ip = (uint8_t *)&(cyw43_state.netif[0].ip_addr.addr);
+        printf("Wi-Fi conectado! IP: %d.%d.%d.%d\n", ip[0], ip[1], ip[2], ip[3]);
+        set_led_green_pwm(); // LED verde para conexão bem-sucedida
+
+        // Consulta o SNTP na hora, sem esperar o recuo das tentativas feitas sem rede
+        cyw43_arch_lwip_begin();
+        start_sntp();
+        cyw43_arch_lwip_end();
+        break;
     }
 
-    // Conexão bem-sucedida
-    uint8_t *ip = (uint8_t *)&(cyw43_state.netif[0].ip_addr.addr);
-    printf("Wi-Fi conectado! IP: %d.%d.%d.%d\n", ip[0], ip[1], ip[2], ip[3]);
-    set_led_green_pwm(); // LED verde para conexão bem-sucedida
-    return true;
+    case WIFI_STATE_BACKOFF:
+        printf("Falha ao conectar ao Wi-Fi (status %d), nova tentativa em %lld ms\n", wifi.last_status,
+               (long long)(absolute_time_diff_us(get_absolute_time(), wifi.deadline) / 1000));
+        set_led_red_pwm(); // LED vermelho para falha
+        break;
+
+    default:
+        break;
+    }
 }
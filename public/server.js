@@ -118,25 +118,36 @@ app.get('/api/status', (req, res) => {
     });
 });
 
-// API - Histórico de dados (para expansão futura)
+// API - Histórico reduzido, no formato da estação: até `points` baldes com mínimo e máximo
+// das amostras (simuladas a cada 5 s) nos últimos `window` segundos
 app.get('/api/history', (req, res) => {
-    const hours = parseInt(req.query.hours) || 24;
-
-    // Simula dados históricos (substituir por dados reais do banco)
-    const history = [];
-    const now = new Date();
-
-    for (let i = hours; i >= 0; i--) {
-        const timestamp = new Date(now.getTime() - (i * 60 * 60 * 1000));
-        history.push({
-            timestamp: timestamp.toISOString(),
-            temperature: 25 + Math.sin(i / 4) * 5 + (Math.random() - 0.5) * 2,
-            humidity: 65 + Math.cos(i / 3) * 15 + (Math.random() - 0.5) * 5,
-            pressure: 1013 + Math.sin(i / 6) * 10 + (Math.random() - 0.5) * 2
-        });
+    const points = Math.min(240, parseInt(req.query.points) || 200);
+    const windowMs = (parseInt(req.query.window) || 3 * 3600) * 1000;
+    const uptimeMs = Math.round(process.uptime() * 1000) + 6 * 3600 * 1000; // "Boot" simulado há 6 h
+    const from = uptimeMs - windowMs;
+    const bucketMs = Math.ceil(windowMs / points);
+    const value = (t, base, amp, period) => base + Math.sin(t / period) * amp + (Math.random() - 0.5) * amp / 5;
+
+    const buckets = [];
+    for (let start = from; start < uptimeMs; start += bucketMs) {
+        const row = [start, 0, Infinity, -Infinity, Infinity, -Infinity, Infinity, -Infinity];
+        for (let t = start; t < Math.min(start + bucketMs, uptimeMs); t += 5000) {
+            const v = [value(t, 25, 5, 3.6e6), value(t, 65, 15, 2.7e6), value(t, 1013, 3, 7.2e6)];
+            v.forEach((x, k) => {
+                row[2 + 2 * k] = Math.min(row[2 + 2 * k], x);
+                row[3 + 2 * k] = Math.max(row[3 + 2 * k], x);
+            });
+            row[1]++;
+        }
+        if (row[1])
+            buckets.push(row.map((x, k) => k < 2 ? x : parseFloat(x.toFixed(2))));
     }
 
-    res.json(history);
+    res.json({
+        uptimeMs, from, to: uptimeMs, bucketMs,
+        fields: ['timeMs', 'count', 'temperatureMin', 'temperatureMax', 'humidityMin', 'humidityMax', 'pressureMin', 'pressureMax'],
+        buckets
+    });
 });
 
 // Função para salvar configurações em arquivo
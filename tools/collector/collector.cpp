@@ -0,0 +1,649 @@
+#include "collector.h"
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include "net.h"
+
+namespace wx
+{
+
+int64_t unix_now_ms()
+{
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// Nomes viram nomes de arquivo: apenas letras, dígitos, '-', '_' e '.' (sem começar por '.')
+static bool valid_name(const std::string &name)
+{
+    if (name.empty() || name.size() > 64 || name[0] == '.')
+        return false;
+    for (char c : name)
+    {
+        if (!isalnum((unsigned char)c) && c != '-' && c != '_' && c != '.')
+            return false;
+    }
+    return true;
+}
+
+collector::collector(event_loop &loop, const collector_config &config) : loop_(loop), config_(config)
+{
+}
+
+collector::station *collector::create_station(const std::string &name)
+{
+    if (!valid_name(name) || by_name_.count(name))
+        return nullptr;
+
+    auto st = std::make_unique<station>();
+    st->name = name;
+    if (!st->file.open(config_.data_dir + "/" + name + ".wxs"))
+    {
+        fprintf(stderr, "%s: não foi possível abrir o arquivo: %s\n", name.c_str(), strerror(errno));
+        return nullptr;
+    }
+
+    // Retoma da última sequência gravada (se a estação reiniciou, ela responde com reset)
+    if (st->file.last(st->latest))
+        st->last_seq = st->latest.seq;
+
+    station *raw = st.get();
+    by_name_[name] = raw;
+    stations_.push_back(std::move(st));
+    return raw;
+}
+
+bool collector::add_station(const std::string &name, const std::string &address)
+{
+    sockaddr_in addr;
+    if (!resolve(address, 80, addr))
+    {
+        fprintf(stderr, "%s: endereço inválido '%s'\n", name.c_str(), address.c_str());
+        return false;
+    }
+    station *st = create_station(name);
+    if (!st)
+        return false;
+    st->polled = true;
+    st->addr = addr;
+    return true;
+}
+
+bool collector::start()
+{
+    listen_fd_ = listen_tcp(config_.listen_addr);
+    if (listen_fd_ < 0)
+    {
+        fprintf(stderr, "Erro ao escutar em %s: %s\n", to_string(config_.listen_addr).c_str(), strerror(errno));
+        return false;
+    }
+    loop_.add(listen_fd_, EPOLLIN, [this](uint32_t) { on_accept(); });
+
+    // Espalha a primeira rodada ao longo do intervalo para não sincronizar a frota
+    size_t polled = 0;
+    for (auto &st : stations_)
+    {
+        if (st->polled)
+            polled++;
+    }
+    size_t i = 0;
+    for (auto &st : stations_)
+    {
+        if (st->polled)
+            schedule_poll(st.get(), polled ? config_.poll_interval_ms * i++ / polled : 0);
+    }
+
+    period_start_ms_ = event_loop::now_ms();
+    loop_.add_timer(config_.report_interval_ms, [this] { report(); });
+    fprintf(stderr, "Coletor em %s: %zu estações consultadas a cada %llu ms, dados em %s\n",
+            to_string(config_.listen_addr).c_str(), polled, (unsigned long long)config_.poll_interval_ms,
+            config_.data_dir.c_str());
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Consultas às estações
+
+void collector::schedule_poll(station *st, uint64_t delay_ms)
+{
+    loop_.add_timer(delay_ms, [this, st] { start_poll(st); });
+}
+
+void collector::start_poll(station *st)
+{
+    if (inflight_ >= config_.max_inflight)
+    {
+        waiting_.push_back(st);
+        return;
+    }
+
+    st->fd = connect_tcp(st->addr);
+    if (st->fd < 0)
+    {
+        st->polls++;
+        polls_++;
+        inflight_++;
+        finish_poll(st, false, false, strerror(errno));
+        return;
+    }
+
+    inflight_++;
+    st->polls++;
+    polls_++;
+    st->connecting = true;
+    st->written = 0;
+    st->buffer.clear();
+    st->started_us = event_loop::now_us();
+    st->request = "GET /api/samples?since=" + std::to_string(st->last_seq) +
+                  "&limit=" + std::to_string(config_.page_limit) +
+                  " HTTP/1.1\r\nHost: " + to_string(st->addr) + "\r\nConnection: close\r\n\r\n";
+
+    loop_.add(st->fd, EPOLLOUT, [this, st](uint32_t events) { on_poll_event(st, events); });
+    st->timeout = loop_.add_timer(config_.timeout_ms, [this, st] {
+        st->timeout = 0;
+        st->timeouts++;
+        finish_poll(st, false, false, "timeout");
+    });
+}
+
+void collector::on_poll_event(station *st, uint32_t events)
+{
+    if (st->connecting)
+    {
+        int err = connect_result(st->fd);
+        if (err)
+        {
+            finish_poll(st, false, false, strerror(err));
+            return;
+        }
+        st->connecting = false;
+    }
+
+    if (st->written < st->request.size())
+    {
+        if (!write_available(st->fd, st->request, st->written))
+        {
+            finish_poll(st, false, false, strerror(errno));
+            return;
+        }
+        if (st->written == st->request.size())
+            loop_.modify(st->fd, EPOLLIN | EPOLLRDHUP);
+        return;
+    }
+
+    if (!(events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)))
+        return;
+
+    bool closed;
+    bool ok = read_available(st->fd, st->buffer, closed);
+    if (!ok && !closed)
+    {
+        finish_poll(st, false, false, strerror(errno));
+        return;
+    }
+
+    http_response response;
+    size_t consumed;
+    switch (parse_response(st->buffer, closed, response, consumed))
+    {
+    case parse_status::incomplete:
+        return;
+    case parse_status::error:
+        finish_poll(st, false, false, "resposta inválida");
+        return;
+    case parse_status::complete:
+        break;
+    }
+
+    if (response.status != 200)
+    {
+        finish_poll(st, false, false, "status HTTP diferente de 200");
+        return;
+    }
+
+    bool more = false;
+    if (!ingest(st, response.body, unix_now_ms(), more))
+    {
+        finish_poll(st, false, false, "JSON inválido");
+        return;
+    }
+    finish_poll(st, true, more, nullptr);
+}
+
+void collector::finish_poll(station *st, bool ok, bool more, const char *error)
+{
+    if (st->fd >= 0)
+    {
+        loop_.remove(st->fd);
+        close(st->fd);
+        st->fd = -1;
+    }
+    if (st->timeout)
+    {
+        loop_.cancel_timer(st->timeout);
+        st->timeout = 0;
+    }
+    inflight_--;
+
+    if (ok)
+    {
+        period_latency_us_.push_back((uint32_t)std::min<uint64_t>(event_loop::now_us() - st->started_us, UINT32_MAX));
+        period_polls_++;
+    }
+    else
+    {
+        st->errors++;
+        errors_++;
+        st->last_error = error ? error : "erro";
+    }
+
+    // Páginas pendentes são buscadas em seguida; senão, espera o intervalo
+    schedule_poll(st, ok && more ? 0 : config_.poll_interval_ms);
+
+    while (inflight_ < config_.max_inflight && !waiting_.empty())
+    {
+        station *next = waiting_.front();
+        waiting_.pop_front();
+        start_poll(next);
+    }
+}
+
+// Lê a próxima lista [a,b,c,...] de números em p
+static bool parse_row(const char *&p, double *values, int count)
+{
+    while (*p == ' ')
+        p++;
+    if (*p != '[')
+        return false;
+    p++;
+    for (int i = 0; i < count; i++)
+    {
+        char *end;
+        values[i] = strtod(p, &end);
+        if (end == p)
+            return false;
+        p = end;
+        while (*p == ' ')
+            p++;
+        if (*p != (i + 1 < count ? ',' : ']'))
+            return false;
+        p++;
+    }
+    return true;
+}
+
+// Interpreta uma página de /api/samples (ou um envio de /api/push) e grava as amostras.
+// O instante de cada amostra vem do relógio da estação (ms desde o boot): com uptimeMs na resposta,
+// amostra = referência - (uptimeMs - timeMs); sem ele, a última amostra é tomada como o instante atual.
+// A referência é a hora Unix da estação (unixMs, disciplinada pelo SNTP) quando ela já sincronizou,
+// o que dispensa o atraso da rede e alinha estações diferentes; senão, o instante do recebimento.
+bool collector::ingest(station *st, const std::string &json, int64_t received_ms, bool &more)
+{
+    size_t pos = json.find("\"samples\":[");
+    if (pos == std::string::npos)
+        return false;
+
+    std::vector<double> rows;
+    const char *p = json.c_str() + pos + 11;
+    while (*p != ']')
+    {
+        double row[5];
+        if (!parse_row(p, row, 5))
+            return false;
+        rows.insert(rows.end(), row, row + 5);
+        while (*p == ' ')
+            p++;
+        if (*p == ',')
+            p++;
+        else if (*p != ']')
+            return false;
+    }
+
+    double uptime = 0, next = 0, station_unix = 0;
+    bool has_uptime = json_number(json, "uptimeMs", uptime);
+    int64_t reference_ms = received_ms;
+    if (has_uptime && json_number(json, "unixMs", station_unix))
+        reference_ms = (int64_t)station_unix;
+    bool reset = false;
+    json_bool(json, "reset", reset);
+    more = false;
+    json_bool(json, "more", more);
+    if (!has_uptime && !rows.empty())
+        uptime = rows[rows.size() - 4]; // timeMs da última amostra
+
+    std::vector<stored_sample> samples;
+    samples.reserve(rows.size() / 5);
+    for (size_t i = 0; i < rows.size(); i += 5)
+    {
+        stored_sample sample;
+        sample.seq = (uint32_t)rows[i];
+        sample.unix_ms = reference_ms - (int64_t)(uptime - rows[i + 1]);
+        sample.temperature = (int32_t)lround(rows[i + 2] * 100.0);
+        sample.humidity = (int32_t)lround(rows[i + 3] * 100.0);
+        sample.pressure = (int32_t)lround(rows[i + 4] * 100.0);
+        samples.push_back(sample);
+    }
+
+    if (!st->file.append(samples))
+    {
+        fprintf(stderr, "%s: falha ao gravar: %s\n", st->name.c_str(), strerror(errno));
+        return false;
+    }
+    if (reset)
+        st->resets++;
+    if (!samples.empty())
+    {
+        st->latest = samples.back();
+        st->last_seq = samples.back().seq;
+    }
+    if (json_number(json, "next", next))
+        st->last_seq = (uint32_t)next;
+    st->samples += samples.size();
+    samples_ += samples.size();
+    period_samples_ += samples.size();
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Servidor HTTP
+
+void collector::on_accept()
+{
+    for (;;)
+    {
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+            return; // EAGAIN ou falha transitória (ex.: EMFILE): tenta no próximo evento
+
+        auto c = std::make_unique<client>();
+        c->fd = fd;
+        client *raw = c.get();
+        clients_[fd] = std::move(c);
+        loop_.add(fd, EPOLLIN | EPOLLRDHUP, [this, raw](uint32_t events) { on_client_event(raw, events); });
+    }
+}
+
+void collector::close_client(client *c)
+{
+    int fd = c->fd;
+    loop_.remove(fd);
+    close(fd);
+    clients_.erase(fd); // Libera c
+}
+
+void collector::on_client_event(client *c, uint32_t events)
+{
+    if (events & EPOLLIN)
+    {
+        bool closed;
+        if (!read_available(c->fd, c->in, closed) && !closed)
+        {
+            close_client(c);
+            return;
+        }
+
+        // Atende as requisições completas (inclusive em sequência na mesma conexão)
+        for (;;)
+        {
+            http_request request;
+            size_t consumed;
+            parse_status status = parse_request(c->in, request, consumed);
+            if (status == parse_status::incomplete)
+            {
+                if (closed && c->out.size() == c->written)
+                {
+                    close_client(c);
+                    return;
+                }
+                break;
+            }
+            if (status == parse_status::error)
+            {
+                c->out += make_response(400, "text/plain", "requisição inválida", false);
+                c->close_after = true;
+                c->in.clear();
+                break;
+            }
+
+            c->in.erase(0, consumed);
+            int code = 200;
+            std::string body = handle(request, code);
+            c->out += make_response(code, "application/json", body, request.keep_alive);
+            if (!request.keep_alive)
+            {
+                c->close_after = true;
+                break;
+            }
+        }
+    }
+    else if (events & (EPOLLHUP | EPOLLERR))
+    {
+        close_client(c);
+        return;
+    }
+
+    if (!write_available(c->fd, c->out, c->written))
+    {
+        close_client(c);
+        return;
+    }
+    if (c->written == c->out.size())
+    {
+        c->out.clear();
+        c->written = 0;
+        if (c->close_after)
+        {
+            close_client(c);
+            return;
+        }
+        loop_.modify(c->fd, EPOLLIN | EPOLLRDHUP);
+    }
+    else
+    {
+        loop_.modify(c->fd, EPOLLIN | EPOLLOUT | EPOLLRDHUP);
+    }
+}
+
+std::string collector::handle(const http_request &request, int &status)
+{
+    if (request.method == "GET" && request.path == "/api/stations")
+        return handle_stations();
+    if (request.method == "GET" && request.path == "/api/history")
+        return handle_history(request.query, status);
+    if (request.method == "GET" && request.path == "/api/collector")
+        return handle_status();
+    if (request.method == "POST" && request.path == "/api/push")
+        return handle_push(request.query, request.body, status);
+
+    status = 404;
+    return "{\"error\":\"not found\"}";
+}
+
+std::string collector::handle_stations()
+{
+    std::string out = "{\"stations\":[";
+    char buf[512];
+    bool first = true;
+    for (auto &st : stations_)
+    {
+        out += first ? "{\"name\":" : ",{\"name\":";
+        first = false;
+        json_escape(out, st->name);
+        snprintf(buf, sizeof(buf),
+                 ",\"mode\":\"%s\",\"address\":\"%s\",\"lastSeq\":%u,\"stored\":%llu,\"samples\":%llu,"
+                 "\"polls\":%llu,\"errors\":%llu,\"timeouts\":%llu,\"resets\":%llu,\"lastError\":",
+                 st->polled ? "poll" : "push", st->polled ? to_string(st->addr).c_str() : "",
+                 st->last_seq, (unsigned long long)st->file.count(), (unsigned long long)st->samples,
+                 (unsigned long long)st->polls, (unsigned long long)st->errors,
+                 (unsigned long long)st->timeouts, (unsigned long long)st->resets);
+        out += buf;
+        json_escape(out, st->last_error);
+        if (st->file.count())
+        {
+            snprintf(buf, sizeof(buf), ",\"latest\":{\"timeMs\":%lld,\"temperature\":%.2f,\"humidity\":%.2f,\"pressure\":%.2f}}",
+                     (long long)st->latest.unix_ms, st->latest.temperature / 100.0, st->latest.humidity / 100.0,
+                     st->latest.pressure / 100.0);
+            out += buf;
+        }
+        else
+        {
+            out += ",\"latest\":null}";
+        }
+    }
+    out += "]}";
+    return out;
+}
+
+// GET /api/history?station=<nome>&from=<unix ms>&to=<unix ms>&step=<ms>
+// Médias por passo de tempo, lidas do arquivo em uma passada (memória constante)
+std::string collector::handle_history(const std::string &query, int &status)
+{
+    std::string name, value;
+    query_param(query, "station", name);
+    auto it = by_name_.find(name);
+    if (it == by_name_.end())
+    {
+        status = 404;
+        return "{\"error\":\"unknown station\"}";
+    }
+
+    int64_t to = unix_now_ms();
+    int64_t from = to - 24 * 3600 * 1000LL;
+    if (query_param(query, "to", value))
+        to = atoll(value.c_str());
+    if (query_param(query, "from", value))
+        from = atoll(value.c_str());
+    int64_t step = (to - from) / 500; // Até ~500 pontos por padrão
+    if (query_param(query, "step", value))
+        step = atoll(value.c_str());
+    if (step < 1000)
+        step = 1000;
+    if (to <= from || (to - from) / step > 100000)
+    {
+        status = 400;
+        return "{\"error\":\"invalid range\"}";
+    }
+
+    std::string out;
+    char buf[256];
+    snprintf(buf, sizeof(buf),
+             "{\"station\":\"%s\",\"from\":%lld,\"to\":%lld,\"step\":%lld,"
+             "\"fields\":[\"timeMs\",\"count\",\"temperature\",\"humidity\",\"pressure\"],\"points\":[",
+             name.c_str(), (long long)from, (long long)to, (long long)step);
+    out += buf;
+
+    struct
+    {
+        int64_t start = -1;
+        uint32_t count = 0;
+        int64_t temperature = 0, humidity = 0, pressure = 0;
+    } bucket;
+    bool first = true;
+    auto flush = [&] {
+        if (!bucket.count)
+            return;
+        snprintf(buf, sizeof(buf), "%s[%lld,%u,%.2f,%.2f,%.2f]", first ? "" : ",", (long long)bucket.start,
+                 bucket.count, bucket.temperature / 100.0 / bucket.count, bucket.humidity / 100.0 / bucket.count,
+                 bucket.pressure / 100.0 / bucket.count);
+        out += buf;
+        first = false;
+    };
+
+    it->second->file.scan(from, to, [&](const stored_sample &sample) {
+        int64_t start = from + (sample.unix_ms - from) / step * step;
+        if (start != bucket.start)
+        {
+            flush();
+            bucket = {};
+            bucket.start = start;
+        }
+        bucket.count++;
+        bucket.temperature += sample.temperature;
+        bucket.humidity += sample.humidity;
+        bucket.pressure += sample.pressure;
+    });
+    flush();
+    out += "]}";
+    return out;
+}
+
+// POST /api/push?station=<nome>: corpo no formato de /api/samples (estações que enviam em vez de
+// serem consultadas; a estação é criada no primeiro envio)
+std::string collector::handle_push(const std::string &query, const std::string &body, int &status)
+{
+    std::string name;
+    query_param(query, "station", name);
+    auto it = by_name_.find(name);
+    station *st = it != by_name_.end() ? it->second : create_station(name);
+    if (!st)
+    {
+        status = 400;
+        return "{\"error\":\"invalid station\"}";
+    }
+
+    bool more;
+    uint64_t before = st->samples;
+    if (!ingest(st, body, unix_now_ms(), more))
+    {
+        status = 400;
+        return "{\"error\":\"invalid samples\"}";
+    }
+    pushes_++;
+    return "{\"stored\":" + std::to_string(st->samples - before) + ",\"lastSeq\":" + std::to_string(st->last_seq) + "}";
+}
+
+std::string collector::handle_status()
+{
+    char buf[512];
+    snprintf(buf, sizeof(buf),
+             "{\"stations\":%zu,\"inflight\":%zu,\"waiting\":%zu,\"clients\":%zu,\"polls\":%llu,\"errors\":%llu,"
+             "\"samples\":%llu,\"pushes\":%llu,\"pollsPerSec\":%.1f,\"samplesPerSec\":%.1f,"
+             "\"pollLatencyP50Us\":%u,\"pollLatencyP99Us\":%u,\"maxTimerLagMs\":%llu}",
+             stations_.size(), inflight_, waiting_.size(), clients_.size(), (unsigned long long)polls_,
+             (unsigned long long)errors_, (unsigned long long)samples_, (unsigned long long)pushes_,
+             polls_per_s_, samples_per_s_, p50_us_, p99_us_, (unsigned long long)loop_.max_timer_lag_ms());
+    return buf;
+}
+
+// Resumo periódico no terminal (e nos campos *PerSec e de latência de /api/collector)
+void collector::report()
+{
+    uint64_t now = event_loop::now_ms();
+    double seconds = (now - period_start_ms_) / 1000.0;
+    polls_per_s_ = period_polls_ / seconds;
+    samples_per_s_ = period_samples_ / seconds;
+
+    p50_us_ = p99_us_ = 0;
+    if (!period_latency_us_.empty())
+    {
+        auto &v = period_latency_us_;
+        std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+        p50_us_ = v[v.size() / 2];
+        std::nth_element(v.begin(), v.begin() + v.size() * 99 / 100, v.end());
+        p99_us_ = v[v.size() * 99 / 100];
+    }
+
+    fprintf(stderr, "consultas/s %.1f  amostras/s %.1f  latência p50 %.1f ms p99 %.1f ms  em andamento %zu  "
+                    "fila %zu  erros %llu  atraso máx. %llu ms\n",
+            polls_per_s_, samples_per_s_, p50_us_ / 1000.0, p99_us_ / 1000.0, inflight_, waiting_.size(),
+            (unsigned long long)errors_, (unsigned long long)loop_.max_timer_lag_ms());
+
+    period_polls_ = period_samples_ = 0;
+    period_latency_us_.clear();
+    period_start_ms_ = now;
+    loop_.reset_timer_lag();
+    loop_.add_timer(config_.report_interval_ms, [this] { report(); });
+}
+
+} // namespace wx
@@ -0,0 +1,123 @@
+#ifndef WX_COLLECTOR_H
+#define WX_COLLECTOR_H
+
+#include <netinet/in.h>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "event_loop.h"
+#include "http.h"
+#include "store.h"
+
+namespace wx
+{
+
+struct collector_config
+{
+    sockaddr_in listen_addr{};
+    std::string data_dir = ".";
+    uint64_t poll_interval_ms = 5000; // Intervalo entre consultas de cada estação
+    uint64_t timeout_ms = 3000;       // Prazo de uma consulta
+    size_t max_inflight = 512;        // Consultas simultâneas
+    uint32_t page_limit = 64;         // Amostras por página de /api/samples
+    uint64_t report_interval_ms = 10000;
+};
+
+// Coletor da frota: consulta /api/samples de cada estação (retomando da última sequência
+// recebida), aceita amostras enviadas por POST /api/push, grava um arquivo por estação e atende
+// /api/stations, /api/history e /api/collector. Tudo em um único laço de eventos.
+class collector
+{
+public:
+    collector(event_loop &loop, const collector_config &config);
+
+    // Registra uma estação consultada em address ("host:porta"). Retorna false se o nome ou o
+    // endereço forem inválidos ou o arquivo não puder ser aberto.
+    bool add_station(const std::string &name, const std::string &address);
+
+    // Inicia o servidor HTTP e as consultas (espalhadas ao longo do primeiro intervalo)
+    bool start();
+
+private:
+    struct station
+    {
+        std::string name;
+        bool polled = false;
+        sockaddr_in addr{};
+        station_file file;
+        uint32_t last_seq = 0;
+        stored_sample latest{};
+
+        // Consulta em andamento
+        int fd = -1;
+        bool connecting = false;
+        std::string request;
+        size_t written = 0;
+        std::string buffer;
+        uint64_t started_us = 0;
+        event_loop::timer_id timeout = 0;
+
+        // Contadores
+        uint64_t polls = 0;
+        uint64_t errors = 0;
+        uint64_t timeouts = 0;
+        uint64_t samples = 0;
+        uint64_t resets = 0;
+        std::string last_error;
+    };
+
+    struct client
+    {
+        int fd;
+        std::string in;
+        std::string out;
+        size_t written = 0;
+        bool close_after = false;
+    };
+
+    station *create_station(const std::string &name);
+    void schedule_poll(station *st, uint64_t delay_ms);
+    void start_poll(station *st);
+    void on_poll_event(station *st, uint32_t events);
+    void finish_poll(station *st, bool ok, bool more, const char *error);
+    bool ingest(station *st, const std::string &json, int64_t received_ms, bool &more);
+
+    void on_accept();
+    void on_client_event(client *c, uint32_t events);
+    void close_client(client *c);
+    std::string handle(const http_request &request, int &status);
+    std::string handle_stations();
+    std::string handle_history(const std::string &query, int &status);
+    std::string handle_push(const std::string &query, const std::string &body, int &status);
+    std::string handle_status();
+
+    void report();
+
+    event_loop &loop_;
+    collector_config config_;
+    int listen_fd_ = -1;
+    std::vector<std::unique_ptr<station>> stations_;
+    std::unordered_map<std::string, station *> by_name_;
+    std::deque<station *> waiting_; // Consultas aguardando vaga em max_inflight
+    size_t inflight_ = 0;
+    std::unordered_map<int, std::unique_ptr<client>> clients_;
+
+    // Contadores globais e do período de relatório
+    uint64_t polls_ = 0, errors_ = 0, samples_ = 0, pushes_ = 0;
+    uint64_t period_polls_ = 0, period_samples_ = 0, period_start_ms_ = 0;
+    std::vector<uint32_t> period_latency_us_;
+    uint32_t p50_us_ = 0, p99_us_ = 0;
+    double polls_per_s_ = 0, samples_per_s_ = 0;
+};
+
+// Relógio de parede em ms desde a época Unix
+int64_t unix_now_ms();
+
+} // namespace wx
+
+#endif // WX_COLLECTOR_H
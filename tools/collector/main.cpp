@@ -0,0 +1,106 @@
+// Coletor da frota de estações meteorológicas.
+//
+//   collector --stations stations.txt [--listen 0.0.0.0:8080] [--data DIR] [--interval MS]
+//             [--timeout MS] [--max-inflight N]
+//
+// stations.txt: uma estação por linha, "nome host[:porta]" (linhas vazias e '#' são ignoradas).
+
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "collector.h"
+#include "net.h"
+
+static void usage()
+{
+    fprintf(stderr, "uso: collector --stations ARQUIVO [--listen HOST:PORTA] [--data DIR] [--interval MS]\n"
+                    "                 [--timeout MS] [--max-inflight N]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    wx::collector_config config;
+    std::string stations_path;
+    std::string listen = "0.0.0.0:8080";
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+            usage();
+        const char *value = argv[++i];
+        if (arg == "--stations")
+            stations_path = value;
+        else if (arg == "--listen")
+            listen = value;
+        else if (arg == "--data")
+            config.data_dir = value;
+        else if (arg == "--interval")
+            config.poll_interval_ms = strtoull(value, nullptr, 10);
+        else if (arg == "--timeout")
+            config.timeout_ms = strtoull(value, nullptr, 10);
+        else if (arg == "--max-inflight")
+            config.max_inflight = strtoull(value, nullptr, 10);
+        else
+            usage();
+    }
+    if (!wx::resolve(listen, 8080, config.listen_addr) || config.poll_interval_ms == 0 || config.max_inflight == 0)
+        usage();
+
+    signal(SIGPIPE, SIG_IGN);
+    uint64_t fd_limit = wx::raise_fd_limit();
+    if (mkdir(config.data_dir.c_str(), 0755) < 0 && errno != EEXIST)
+    {
+        fprintf(stderr, "Erro ao criar %s: %s\n", config.data_dir.c_str(), strerror(errno));
+        return 1;
+    }
+
+    wx::event_loop loop;
+    wx::collector collector(loop, config);
+
+    size_t count = 0;
+    if (!stations_path.empty())
+    {
+        std::ifstream file(stations_path);
+        if (!file)
+        {
+            fprintf(stderr, "Erro ao abrir %s\n", stations_path.c_str());
+            return 1;
+        }
+        std::string line;
+        while (std::getline(file, line))
+        {
+            std::istringstream fields(line);
+            std::string name, address;
+            if (!(fields >> name) || name[0] == '#')
+                continue;
+            if (!(fields >> address) || !collector.add_station(name, address))
+            {
+                fprintf(stderr, "Linha ignorada: %s\n", line.c_str());
+                continue;
+            }
+            count++;
+        }
+    }
+
+    // Cada estação usa um arquivo e, durante a consulta, um socket
+    if (fd_limit && count * 2 + config.max_inflight + 64 > fd_limit)
+    {
+        fprintf(stderr, "Aviso: limite de %llu descritores pode ser insuficiente para %zu estações\n",
+                (unsigned long long)fd_limit, count);
+    }
+
+    if (!collector.start())
+        return 1;
+    loop.run();
+    return 0;
+}
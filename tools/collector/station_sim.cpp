@@ -0,0 +1,278 @@
+// Simulador de estações para medir o coletor: N estações em portas consecutivas de um único
+// processo, respondendo /api/samples e /api/weather no formato do firmware (uma resposta por
+// conexão, seguida do fechamento, como o servidor da placa).
+//
+//   station_sim --count 1000 [--host 127.0.0.1] [--base-port 9000] [--sample-ms 1000]
+//               [--stations-file stations.txt]
+//
+// Cada estação gera uma amostra a cada --sample-ms a partir de um "boot" aleatório na última
+// hora; os valores são funções determinísticas da estação e da sequência, então nada é guardado.
+
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "event_loop.h"
+#include "http.h"
+#include "net.h"
+
+namespace
+{
+
+const uint32_t history_samples = 19000; // Aproximadamente o que cabe no histórico comprimido da placa
+const uint32_t page_max = 64;
+
+struct sim_station
+{
+    uint16_t port;
+    uint64_t boot_ms; // Relógio monotônico do simulador no "boot" da estação
+    uint32_t index;
+};
+
+struct connection
+{
+    int fd;
+    sim_station *station;
+    std::string in;
+    std::string out;
+    size_t written = 0;
+};
+
+uint32_t sample_ms = 1000;
+wx::event_loop *loop;
+std::unordered_map<int, std::unique_ptr<connection>> connections;
+uint64_t requests = 0;
+
+uint32_t hash32(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352d;
+    x ^= x >> 15;
+    x *= 0x846ca68b;
+    x ^= x >> 16;
+    return x;
+}
+
+// Amostra seq da estação: ciclo diário suave com ruído, em centésimos (pressão em Pa)
+void sample_values(const sim_station &st, uint32_t seq, int32_t &temperature, int32_t &humidity, int32_t &pressure)
+{
+    double t = seq * (double)sample_ms / 86400000.0 * 2 * M_PI + st.index;
+    uint32_t noise = hash32(st.index * 2654435761u ^ seq);
+    temperature = 2200 + (int32_t)(500 * sin(t)) + (int32_t)(noise % 21) - 10;
+    humidity = 6000 - (int32_t)(1500 * sin(t)) + (int32_t)((noise >> 8) % 41) - 20;
+    pressure = 101300 + (int32_t)(150 * sin(t / 3)) + (int32_t)((noise >> 16) % 11) - 5;
+}
+
+std::string samples_body(const sim_station &st, const std::string &query)
+{
+    uint64_t uptime = wx::event_loop::now_ms() - st.boot_ms;
+    uint32_t last = (uint32_t)(uptime / sample_ms);
+    uint32_t first = last > history_samples ? last - history_samples + 1 : 1;
+
+    std::string value;
+    unsigned long since = 0, limit = page_max;
+    if (wx::query_param(query, "since", value))
+        since = strtoul(value.c_str(), nullptr, 10);
+    if (wx::query_param(query, "limit", value))
+        limit = strtoul(value.c_str(), nullptr, 10);
+    if (limit == 0 || limit > page_max)
+        limit = page_max;
+    bool reset = since > last;
+    if (reset)
+        since = 0;
+
+    char buf[256];
+    snprintf(buf, sizeof(buf),
+             "{\"uptimeMs\":%llu,\"first\":%u,\"last\":%u,\"reset\":%s,\"gap\":%s,"
+             "\"fields\":[\"seq\",\"timeMs\",\"temperature\",\"humidity\",\"pressure\"],\"samples\":[",
+             (unsigned long long)uptime, first, last, reset ? "true" : "false",
+             since < last && since + 1 < first ? "true" : "false");
+    std::string body = buf;
+
+    uint32_t seq = since + 1 < first ? first : (uint32_t)since + 1;
+    uint32_t next = (uint32_t)since;
+    for (unsigned long i = 0; i < limit && seq <= last; i++, seq++)
+    {
+        int32_t t, h, p;
+        sample_values(st, seq, t, h, p);
+        snprintf(buf, sizeof(buf), "%s[%u,%llu,%.2f,%.2f,%.2f]", i ? "," : "", seq,
+                 (unsigned long long)seq * sample_ms, t / 100.0, h / 100.0, p / 100.0);
+        body += buf;
+        next = seq;
+    }
+    snprintf(buf, sizeof(buf), "],\"next\":%u,\"more\":%s}", next, next < last ? "true" : "false");
+    body += buf;
+    return body;
+}
+
+std::string weather_body(const sim_station &st)
+{
+    uint32_t last = (uint32_t)((wx::event_loop::now_ms() - st.boot_ms) / sample_ms);
+    int32_t t, h, p;
+    sample_values(st, last, t, h, p);
+    char buf[256];
+    snprintf(buf, sizeof(buf), "{\"seq\":%u,\"temperature\":%.2f,\"humidity\":%.2f,\"pressure\":%.2f}", last,
+             t / 100.0, h / 100.0, p / 100.0);
+    return buf;
+}
+
+void close_connection(connection *c)
+{
+    int fd = c->fd;
+    loop->remove(fd);
+    close(fd);
+    connections.erase(fd);
+}
+
+void on_connection(connection *c, uint32_t events)
+{
+    if (c->out.empty())
+    {
+        bool closed;
+        if (!wx::read_available(c->fd, c->in, closed) && !closed)
+        {
+            close_connection(c);
+            return;
+        }
+
+        wx::http_request request;
+        size_t consumed;
+        wx::parse_status status = wx::parse_request(c->in, request, consumed);
+        if (status == wx::parse_status::incomplete && !closed)
+            return;
+        if (status != wx::parse_status::complete)
+        {
+            close_connection(c);
+            return;
+        }
+
+        requests++;
+        if (request.path == "/api/samples")
+            c->out = wx::make_response(200, "application/json", samples_body(*c->station, request.query), false);
+        else if (request.path == "/api/weather")
+            c->out = wx::make_response(200, "application/json", weather_body(*c->station), false);
+        else
+            c->out = wx::make_response(404, "text/plain", "not found", false);
+    }
+    else if (!(events & EPOLLOUT))
+    {
+        return;
+    }
+
+    if (!wx::write_available(c->fd, c->out, c->written) || c->written == c->out.size())
+    {
+        close_connection(c);
+        return;
+    }
+    loop->modify(c->fd, EPOLLOUT);
+}
+
+void on_accept(int listen_fd, sim_station *st)
+{
+    for (;;)
+    {
+        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+            return;
+        auto c = std::make_unique<connection>();
+        c->fd = fd;
+        c->station = st;
+        connection *raw = c.get();
+        connections[fd] = std::move(c);
+        loop->add(fd, EPOLLIN | EPOLLRDHUP, [raw](uint32_t events) { on_connection(raw, events); });
+    }
+}
+
+void usage()
+{
+    fprintf(stderr, "uso: station_sim --count N [--host IP] [--base-port PORTA] [--sample-ms MS]\n"
+                    "                 [--stations-file ARQUIVO]\n");
+    exit(2);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    uint32_t count = 0;
+    std::string host = "127.0.0.1";
+    unsigned base_port = 9000;
+    std::string stations_file;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+            usage();
+        const char *value = argv[++i];
+        if (arg == "--count")
+            count = (uint32_t)strtoul(value, nullptr, 10);
+        else if (arg == "--host")
+            host = value;
+        else if (arg == "--base-port")
+            base_port = (unsigned)strtoul(value, nullptr, 10);
+        else if (arg == "--sample-ms")
+            sample_ms = (uint32_t)strtoul(value, nullptr, 10);
+        else if (arg == "--stations-file")
+            stations_file = value;
+        else
+            usage();
+    }
+    if (count == 0 || sample_ms == 0 || base_port + count > 65536)
+        usage();
+
+    signal(SIGPIPE, SIG_IGN);
+    wx::raise_fd_limit();
+    wx::event_loop event_loop;
+    loop = &event_loop;
+
+    std::mt19937 rng(42);
+    std::vector<sim_station> stations(count);
+    FILE *list = stations_file.empty() ? nullptr : fopen(stations_file.c_str(), "w");
+    uint64_t now = wx::event_loop::now_ms();
+    for (uint32_t i = 0; i < count; i++)
+    {
+        sim_station &st = stations[i];
+        st.index = i;
+        st.port = (uint16_t)(base_port + i);
+        st.boot_ms = now - rng() % 3600000u;
+
+        sockaddr_in addr;
+        if (!wx::resolve(host + ":" + std::to_string(st.port), st.port, addr))
+            usage();
+        int fd = wx::listen_tcp(addr);
+        if (fd < 0)
+        {
+            fprintf(stderr, "Erro ao escutar na porta %u: %s\n", st.port, strerror(errno));
+            return 1;
+        }
+        event_loop.add(fd, EPOLLIN, [fd, &st](uint32_t) { on_accept(fd, &st); });
+        if (list)
+            fprintf(list, "sim%04u %s:%u\n", i, host.c_str(), st.port);
+    }
+    if (list)
+        fclose(list);
+
+    std::function<void()> report = [&] {
+        fprintf(stderr, "station_sim: %u estações, %llu requisições, %zu conexões abertas\n", count,
+                (unsigned long long)requests, connections.size());
+        event_loop.add_timer(10000, report);
+    };
+    event_loop.add_timer(10000, report);
+    fprintf(stderr, "station_sim: %u estações em %s:%u-%u\n", count, host.c_str(), base_port, base_port + count - 1);
+    event_loop.run();
+    return 0;
+}
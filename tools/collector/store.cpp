@@ -0,0 +1,95 @@
+#include "store.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace wx
+{
+
+station_file::~station_file()
+{
+    if (fd_ >= 0)
+        close(fd_);
+}
+
+bool station_file::open(const std::string &path)
+{
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0)
+        return false;
+
+    // Um registro incompleto no fim (queda durante a gravação) é descartado
+    struct stat st;
+    if (fstat(fd_, &st) < 0)
+        return false;
+    count_ = (uint64_t)st.st_size / sizeof(stored_sample);
+    if ((uint64_t)st.st_size != count_ * sizeof(stored_sample))
+        return ftruncate(fd_, (off_t)(count_ * sizeof(stored_sample))) == 0;
+    return true;
+}
+
+bool station_file::append(const std::vector<stored_sample> &samples)
+{
+    if (samples.empty())
+        return true;
+    size_t bytes = samples.size() * sizeof(stored_sample);
+    ssize_t n = write(fd_, samples.data(), bytes);
+    if (n != (ssize_t)bytes)
+    {
+        // Mantém o arquivo alinhado aos registros
+        if (n > 0)
+        {
+            if (ftruncate(fd_, (off_t)(count_ * sizeof(stored_sample))) != 0)
+                return false;
+        }
+        return false;
+    }
+    count_ += samples.size();
+    return true;
+}
+
+bool station_file::read_at(uint64_t index, stored_sample *out, size_t n) const
+{
+    size_t bytes = n * sizeof(stored_sample);
+    return pread(fd_, out, bytes, (off_t)(index * sizeof(stored_sample))) == (ssize_t)bytes;
+}
+
+bool station_file::last(stored_sample &sample) const
+{
+    return count_ > 0 && read_at(count_ - 1, &sample, 1);
+}
+
+void station_file::scan(int64_t from_ms, int64_t to_ms, const std::function<void(const stored_sample &)> &visit) const
+{
+    // Primeiro registro com unix_ms >= from_ms
+    uint64_t lo = 0, hi = count_;
+    while (lo < hi)
+    {
+        uint64_t mid = lo + (hi - lo) / 2;
+        stored_sample sample;
+        if (!read_at(mid, &sample, 1))
+            return;
+        if (sample.unix_ms < from_ms)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    std::vector<stored_sample> chunk(4096);
+    for (uint64_t index = lo; index < count_;)
+    {
+        size_t n = count_ - index < chunk.size() ? (size_t)(count_ - index) : chunk.size();
+        if (!read_at(index, chunk.data(), n))
+            return;
+        for (size_t i = 0; i < n; i++)
+        {
+            if (chunk[i].unix_ms >= to_ms)
+                return;
+            visit(chunk[i]);
+        }
+        index += n;
+    }
+}
+
+} // namespace wx
@@ -0,0 +1,51 @@
+#ifndef WX_STORE_H
+#define WX_STORE_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace wx
+{
+
+// Registro gravado por amostra (24 bytes, ordem de chegada). Valores em centésimos de °C e de %
+// e em Pa, como no firmware; o instante é convertido para o relógio do coletor.
+struct stored_sample
+{
+    int64_t unix_ms;
+    uint32_t seq;
+    int32_t temperature;
+    int32_t humidity;
+    int32_t pressure;
+};
+static_assert(sizeof(stored_sample) == 24, "registro de tamanho fixo");
+
+// Arquivo de uma estação: registros de tamanho fixo apenas acrescentados. As amostras chegam em
+// ordem de tempo, então uma consulta por intervalo localiza o início por busca binária.
+class station_file
+{
+public:
+    station_file() = default;
+    ~station_file();
+    station_file(const station_file &) = delete;
+    station_file &operator=(const station_file &) = delete;
+
+    bool open(const std::string &path);
+    bool append(const std::vector<stored_sample> &samples);
+    uint64_t count() const { return count_; }
+    bool last(stored_sample &sample) const;
+
+    // Chama visit para cada registro com unix_ms em [from_ms, to_ms), em ordem
+    void scan(int64_t from_ms, int64_t to_ms, const std::function<void(const stored_sample &)> &visit) const;
+
+private:
+    bool read_at(uint64_t index, stored_sample *out, size_t n) const;
+
+    int fd_ = -1;
+    uint64_t count_ = 0;
+};
+
+} // namespace wx
+
+#endif // WX_STORE_H
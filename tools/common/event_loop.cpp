@@ -0,0 +1,147 @@
+#include "event_loop.h"
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <ctime>
+#include <system_error>
+
+namespace wx
+{
+
+event_loop::event_loop() : epoll_fd_(epoll_create1(EPOLL_CLOEXEC))
+{
+    if (epoll_fd_ < 0)
+        throw std::system_error(errno, std::generic_category(), "epoll_create1");
+}
+
+event_loop::~event_loop()
+{
+    close(epoll_fd_);
+}
+
+static uint64_t pack(int fd, uint32_t generation)
+{
+    return (uint64_t)generation << 32 | (uint32_t)fd;
+}
+
+void event_loop::add(int fd, uint32_t events, fd_handler handler)
+{
+    registration reg{next_generation_++, std::make_shared<fd_handler>(std::move(handler))};
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.u64 = pack(fd, reg.generation);
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) < 0)
+        throw std::system_error(errno, std::generic_category(), "epoll_ctl(ADD)");
+    fds_[fd] = std::move(reg);
+}
+
+void event_loop::modify(int fd, uint32_t events)
+{
+    auto it = fds_.find(fd);
+    if (it == fds_.end())
+        return;
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.u64 = pack(fd, it->second.generation);
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev);
+}
+
+void event_loop::remove(int fd)
+{
+    if (fds_.erase(fd))
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+event_loop::timer_id event_loop::add_timer(uint64_t delay_ms, timer_handler handler)
+{
+    timer_id id = next_timer_++;
+    timer_heap_.push({now_ms() + delay_ms, id});
+    timers_.emplace(id, std::move(handler));
+    return id;
+}
+
+void event_loop::cancel_timer(timer_id id)
+{
+    timers_.erase(id);
+}
+
+uint64_t event_loop::now_us()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+uint64_t event_loop::now_ms()
+{
+    return now_us() / 1000u;
+}
+
+// Executa os temporizadores vencidos e retorna o tempo até o próximo (-1 se nenhum)
+int event_loop::run_timers()
+{
+    uint64_t now = now_ms();
+    while (!timer_heap_.empty())
+    {
+        timer_entry top = timer_heap_.top();
+        auto it = timers_.find(top.id);
+        if (it == timers_.end())
+        {
+            timer_heap_.pop(); // Cancelado
+            continue;
+        }
+        if (top.deadline_ms > now)
+            return (int)(top.deadline_ms - now);
+
+        timer_heap_.pop();
+        timer_handler handler = std::move(it->second);
+        timers_.erase(it);
+        if (now - top.deadline_ms > max_lag_ms_)
+            max_lag_ms_ = now - top.deadline_ms;
+        handler();
+        now = now_ms();
+    }
+    return -1;
+}
+
+void event_loop::run()
+{
+    running_ = true;
+    epoll_event events[256];
+    while (running_)
+    {
+        int timeout = run_timers();
+        if (!running_)
+            break;
+
+        int n = epoll_wait(epoll_fd_, events, 256, timeout);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::generic_category(), "epoll_wait");
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            int fd = (int)(uint32_t)events[i].data.u64;
+            uint32_t generation = (uint32_t)(events[i].data.u64 >> 32);
+            auto it = fds_.find(fd);
+            if (it == fds_.end() || it->second.generation != generation)
+                continue; // Descritor removido por um tratador anterior nesta iteração
+
+            // Cópia do ponteiro: o tratador pode remover o próprio registro
+            std::shared_ptr<fd_handler> handler = it->second.handler;
+            (*handler)(events[i].events);
+        }
+    }
+}
+
+void event_loop::stop()
+{
+    running_ = false;
+}
+
+} // namespace wx
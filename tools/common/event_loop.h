@@ -0,0 +1,80 @@
+#ifndef WX_EVENT_LOOP_H
+#define WX_EVENT_LOOP_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace wx
+{
+
+// Laço de eventos de uma thread sobre epoll, com temporizadores em heap.
+// Cada descritor registrado recebe um número de geração: eventos já coletados de um descritor
+// fechado (e talvez reaproveitado) durante a mesma iteração são descartados.
+class event_loop
+{
+public:
+    using fd_handler = std::function<void(uint32_t events)>;
+    using timer_handler = std::function<void()>;
+    using timer_id = uint64_t;
+
+    event_loop();
+    ~event_loop();
+    event_loop(const event_loop &) = delete;
+    event_loop &operator=(const event_loop &) = delete;
+
+    // Registra fd para os eventos EPOLL* informados
+    void add(int fd, uint32_t events, fd_handler handler);
+    void modify(int fd, uint32_t events);
+    // Remove o registro (não fecha o descritor)
+    void remove(int fd);
+
+    timer_id add_timer(uint64_t delay_ms, timer_handler handler);
+    void cancel_timer(timer_id id);
+
+    void run();
+    void stop();
+
+    // Relógio monotônico em ms e µs
+    static uint64_t now_ms();
+    static uint64_t now_us();
+
+    // Atraso máximo observado entre o prazo de um temporizador e sua execução
+    uint64_t max_timer_lag_ms() const { return max_lag_ms_; }
+    void reset_timer_lag() { max_lag_ms_ = 0; }
+
+private:
+    struct registration
+    {
+        uint32_t generation;
+        std::shared_ptr<fd_handler> handler;
+    };
+
+    struct timer_entry
+    {
+        uint64_t deadline_ms;
+        timer_id id;
+        bool operator>(const timer_entry &other) const
+        {
+            return deadline_ms != other.deadline_ms ? deadline_ms > other.deadline_ms : id > other.id;
+        }
+    };
+
+    int run_timers();
+
+    int epoll_fd_;
+    bool running_ = false;
+    uint32_t next_generation_ = 1;
+    timer_id next_timer_ = 1;
+    uint64_t max_lag_ms_ = 0;
+    std::unordered_map<int, registration> fds_;
+    std::priority_queue<timer_entry, std::vector<timer_entry>, std::greater<timer_entry>> timer_heap_;
+    std::unordered_map<timer_id, timer_handler> timers_; // Cancelados saem daqui (remoção preguiçosa do heap)
+};
+
+} // namespace wx
+
+#endif // WX_EVENT_LOOP_H
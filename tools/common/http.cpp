@@ -0,0 +1,227 @@
+#include "http.h"
+
+#include <strings.h>
+
+#include <cstdlib>
+#include <cstring>
+
+namespace wx
+{
+
+static const size_t max_header_bytes = 16384;
+
+// Procura um cabeçalho (sem diferenciar maiúsculas) entre o início das linhas de cabeçalho e o fim
+static bool header_value(const std::string &buffer, size_t start, size_t end, const char *name, std::string &value)
+{
+    size_t name_len = strlen(name);
+    size_t pos = start;
+    while (pos < end)
+    {
+        size_t eol = buffer.find("\r\n", pos);
+        if (eol == std::string::npos || eol > end)
+            eol = end;
+        if (eol - pos > name_len && buffer[pos + name_len] == ':' &&
+            strncasecmp(buffer.data() + pos, name, name_len) == 0)
+        {
+            size_t v = pos + name_len + 1;
+            while (v < eol && buffer[v] == ' ')
+                v++;
+            value.assign(buffer, v, eol - v);
+            return true;
+        }
+        pos = eol + 2;
+    }
+    return false;
+}
+
+// Content-Length da mensagem; -1 se ausente, -2 se inválido
+static long content_length(const std::string &buffer, size_t start, size_t end)
+{
+    std::string value;
+    if (!header_value(buffer, start, end, "Content-Length", value))
+        return -1;
+    char *stop;
+    long length = strtol(value.c_str(), &stop, 10);
+    return *stop || length < 0 ? -2 : length;
+}
+
+static bool connection_close(const std::string &buffer, size_t start, size_t end)
+{
+    std::string value;
+    return header_value(buffer, start, end, "Connection", value) && strcasecmp(value.c_str(), "close") == 0;
+}
+
+parse_status parse_request(const std::string &buffer, http_request &request, size_t &consumed)
+{
+    size_t header_end = buffer.find("\r\n\r\n");
+    if (header_end == std::string::npos)
+        return buffer.size() > max_header_bytes ? parse_status::error : parse_status::incomplete;
+
+    size_t line_end = buffer.find("\r\n");
+    size_t sp1 = buffer.find(' ');
+    size_t sp2 = sp1 == std::string::npos ? std::string::npos : buffer.find(' ', sp1 + 1);
+    if (sp2 == std::string::npos || sp2 > line_end)
+        return parse_status::error;
+
+    long length = content_length(buffer, line_end + 2, header_end);
+    if (length == -2)
+        return parse_status::error;
+    size_t body_len = length < 0 ? 0 : (size_t)length;
+    if (buffer.size() < header_end + 4 + body_len)
+        return parse_status::incomplete;
+
+    request.method.assign(buffer, 0, sp1);
+    request.target.assign(buffer, sp1 + 1, sp2 - sp1 - 1);
+    size_t q = request.target.find('?');
+    request.path = request.target.substr(0, q);
+    request.query = q == std::string::npos ? std::string() : request.target.substr(q + 1);
+    request.body.assign(buffer, header_end + 4, body_len);
+    request.keep_alive = buffer.compare(sp2 + 1, 8, "HTTP/1.1") == 0 && !connection_close(buffer, line_end + 2, header_end);
+    consumed = header_end + 4 + body_len;
+    return parse_status::complete;
+}
+
+parse_status parse_response(const std::string &buffer, bool closed, http_response &response, size_t &consumed)
+{
+    size_t header_end = buffer.find("\r\n\r\n");
+    if (header_end == std::string::npos)
+    {
+        if (closed || buffer.size() > max_header_bytes)
+            return parse_status::error;
+        return parse_status::incomplete;
+    }
+
+    if (buffer.compare(0, 5, "HTTP/") != 0)
+        return parse_status::error;
+    size_t sp = buffer.find(' ');
+    if (sp == std::string::npos || sp > header_end)
+        return parse_status::error;
+    response.status = atoi(buffer.c_str() + sp + 1);
+
+    size_t line_end = buffer.find("\r\n");
+    long length = content_length(buffer, line_end + 2, header_end);
+    if (length == -2)
+        return parse_status::error;
+
+    size_t body_start = header_end + 4;
+    if (length < 0)
+    {
+        // Sem Content-Length: o corpo vai até o fechamento
+        if (!closed)
+            return parse_status::incomplete;
+        response.body.assign(buffer, body_start, std::string::npos);
+        response.keep_alive = false;
+        consumed = buffer.size();
+        return parse_status::complete;
+    }
+
+    if (buffer.size() < body_start + (size_t)length)
+        return closed ? parse_status::error : parse_status::incomplete;
+    response.body.assign(buffer, body_start, (size_t)length);
+    response.keep_alive = !connection_close(buffer, line_end + 2, header_end);
+    consumed = body_start + (size_t)length;
+    return parse_status::complete;
+}
+
+static const char *reason(int status)
+{
+    switch (status)
+    {
+    case 200:
+        return "OK";
+    case 400:
+        return "Bad Request";
+    case 404:
+        return "Not Found";
+    case 405:
+        return "Method Not Allowed";
+    case 503:
+        return "Service Unavailable";
+    default:
+        return "Error";
+    }
+}
+
+std::string make_response(int status, const char *content_type, const std::string &body, bool keep_alive)
+{
+    std::string out;
+    out.reserve(body.size() + 192);
+    out += "HTTP/1.1 ";
+    out += std::to_string(status);
+    out += ' ';
+    out += reason(status);
+    out += "\r\nContent-Type: ";
+    out += content_type;
+    out += "\r\nAccess-Control-Allow-Origin: *\r\nContent-Length: ";
+    out += std::to_string(body.size());
+    out += keep_alive ? "\r\nConnection: keep-alive\r\n\r\n" : "\r\nConnection: close\r\n\r\n";
+    out += body;
+    return out;
+}
+
+bool query_param(const std::string &query, const char *name, std::string &value)
+{
+    size_t name_len = strlen(name);
+    size_t pos = 0;
+    while (pos <= query.size())
+    {
+        size_t end = query.find('&', pos);
+        if (end == std::string::npos)
+            end = query.size();
+        if (end - pos > name_len && query.compare(pos, name_len, name) == 0 && query[pos + name_len] == '=')
+        {
+            value.assign(query, pos + name_len + 1, end - pos - name_len - 1);
+            return true;
+        }
+        pos = end + 1;
+    }
+    return false;
+}
+
+static const char *json_value(const std::string &json, const char *key)
+{
+    std::string pattern = "\"";
+    pattern += key;
+    pattern += "\":";
+    size_t pos = json.find(pattern);
+    return pos == std::string::npos ? nullptr : json.c_str() + pos + pattern.size();
+}
+
+bool json_number(const std::string &json, const char *key, double &value)
+{
+    const char *p = json_value(json, key);
+    if (!p)
+        return false;
+    char *end;
+    value = strtod(p, &end);
+    return end != p;
+}
+
+bool json_bool(const std::string &json, const char *key, bool &value)
+{
+    const char *p = json_value(json, key);
+    if (!p)
+        return false;
+    if (strncmp(p, "true", 4) == 0)
+        value = true;
+    else if (strncmp(p, "false", 5) == 0)
+        value = false;
+    else
+        return false;
+    return true;
+}
+
+void json_escape(std::string &out, const std::string &s)
+{
+    out += '"';
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        if ((unsigned char)c >= 0x20)
+            out += c;
+    }
+    out += '"';
+}
+
+} // namespace wx
@@ -0,0 +1,59 @@
+#ifndef WX_HTTP_H
+#define WX_HTTP_H
+
+#include <cstddef>
+#include <string>
+
+namespace wx
+{
+
+// HTTP/1.1 mínimo para as ferramentas: mensagens com Content-Length (sem chunked), como as do
+// firmware. Respostas sem Content-Length terminam no fechamento da conexão.
+
+enum class parse_status
+{
+    incomplete, // Faltam bytes
+    complete,
+    error,
+};
+
+struct http_request
+{
+    std::string method;
+    std::string target; // Caminho com a query
+    std::string path;   // Caminho sem a query
+    std::string query;
+    std::string body;
+    bool keep_alive = true;
+};
+
+struct http_response
+{
+    int status = 0;
+    std::string body;
+    bool keep_alive = true;
+};
+
+// Interpreta uma requisição no início de buffer; consumed recebe o tamanho da mensagem
+parse_status parse_request(const std::string &buffer, http_request &request, size_t &consumed);
+
+// Interpreta uma resposta no início de buffer. closed indica que a conexão já foi fechada, o que
+// completa uma resposta sem Content-Length.
+parse_status parse_response(const std::string &buffer, bool closed, http_response &response, size_t &consumed);
+
+// Monta uma resposta completa
+std::string make_response(int status, const char *content_type, const std::string &body, bool keep_alive);
+
+// Valor de um parâmetro da query (sem decodificação de %XX; os valores usados são simples)
+bool query_param(const std::string &query, const char *name, std::string &value);
+
+// Número associado a "key" em um JSON plano (busca textual, suficiente para as respostas do firmware)
+bool json_number(const std::string &json, const char *key, double &value);
+bool json_bool(const std::string &json, const char *key, bool &value);
+
+// Acrescenta s a out com as aspas e barras escapadas
+void json_escape(std::string &out, const std::string &s);
+
+} // namespace wx
+
+#endif // WX_HTTP_H
@@ -0,0 +1,151 @@
+#include "net.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/tcp.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace wx
+{
+
+bool resolve(const std::string &address, uint16_t default_port, sockaddr_in &out)
+{
+    std::string host = address;
+    uint16_t port = default_port;
+    size_t colon = address.rfind(':');
+    if (colon != std::string::npos)
+    {
+        host = address.substr(0, colon);
+        char *end;
+        unsigned long value = strtoul(address.c_str() + colon + 1, &end, 10);
+        if (*end || value == 0 || value > 65535)
+            return false;
+        port = (uint16_t)value;
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *result = nullptr;
+    if (getaddrinfo(host.empty() ? "0.0.0.0" : host.c_str(), nullptr, &hints, &result) != 0 || !result)
+        return false;
+
+    out = *(const sockaddr_in *)result->ai_addr;
+    out.sin_port = htons(port);
+    freeaddrinfo(result);
+    return true;
+}
+
+std::string to_string(const sockaddr_in &addr)
+{
+    char ip[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &addr.sin_addr, ip, sizeof(ip));
+    return std::string(ip) + ":" + std::to_string(ntohs(addr.sin_port));
+}
+
+int listen_tcp(const sockaddr_in &addr, int backlog)
+{
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return -1;
+
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(fd, (const sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, backlog) < 0)
+    {
+        int err = errno;
+        close(fd);
+        errno = err;
+        return -1;
+    }
+    return fd;
+}
+
+int connect_tcp(const sockaddr_in &addr)
+{
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return -1;
+
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(fd, (const sockaddr *)&addr, sizeof(addr)) < 0 && errno != EINPROGRESS)
+    {
+        int err = errno;
+        close(fd);
+        errno = err;
+        return -1;
+    }
+    return fd;
+}
+
+int connect_result(int fd)
+{
+    int err = 0;
+    socklen_t len = sizeof(err);
+    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0)
+        return errno;
+    return err;
+}
+
+bool read_available(int fd, std::string &buffer, bool &closed)
+{
+    char chunk[16384];
+    closed = false;
+    for (;;)
+    {
+        ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n > 0)
+        {
+            buffer.append(chunk, (size_t)n);
+            continue;
+        }
+        if (n == 0)
+        {
+            closed = true;
+            return false;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return true;
+        if (errno != EINTR)
+            return false;
+    }
+}
+
+bool write_available(int fd, const std::string &data, size_t &offset)
+{
+    while (offset < data.size())
+    {
+        ssize_t n = send(fd, data.data() + offset, data.size() - offset, MSG_NOSIGNAL);
+        if (n > 0)
+        {
+            offset += (size_t)n;
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return true;
+        if (n < 0 && errno == EINTR)
+            continue;
+        return false;
+    }
+    return true;
+}
+
+uint64_t raise_fd_limit()
+{
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) < 0)
+        return 0;
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    getrlimit(RLIMIT_NOFILE, &limit);
+    return limit.rlim_cur;
+}
+
+} // namespace wx
@@ -0,0 +1,40 @@
+#ifndef WX_NET_H
+#define WX_NET_H
+
+#include <netinet/in.h>
+
+#include <cstdint>
+#include <string>
+
+namespace wx
+{
+
+// Converte "host:porta" (ou "host", com a porta padrão) em endereço IPv4. Resolve nomes uma única
+// vez, na configuração; o laço de eventos só trabalha com endereços numéricos.
+bool resolve(const std::string &address, uint16_t default_port, sockaddr_in &out);
+
+std::string to_string(const sockaddr_in &addr);
+
+// Socket em escuta, não bloqueante. Retorna -1 em caso de erro (errno preservado).
+int listen_tcp(const sockaddr_in &addr, int backlog = 1024);
+
+// Inicia uma conexão não bloqueante. Retorna -1 em caso de erro imediato; caso contrário a
+// conclusão é sinalizada por EPOLLOUT e conferida com connect_result.
+int connect_tcp(const sockaddr_in &addr);
+
+// Resultado de uma conexão não bloqueante (0 ou o errno da falha)
+int connect_result(int fd);
+
+// Acumula em buffer o que houver para ler. Retorna false em erro ou fechamento (closed indica o
+// fechamento ordenado pelo outro lado).
+bool read_available(int fd, std::string &buffer, bool &closed);
+
+// Escreve a partir de offset o quanto o socket aceitar. Retorna false em erro.
+bool write_available(int fd, const std::string &data, size_t &offset);
+
+// Eleva o limite de descritores abertos até o máximo permitido e retorna o novo limite
+uint64_t raise_fd_limit();
+
+} // namespace wx
+
+#endif // WX_NET_H
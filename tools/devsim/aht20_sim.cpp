@@ -0,0 +1,123 @@
+#include "aht20_sim.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace wx
+{
+
+namespace
+{
+
+constexpr uint8_t CMD_INIT = 0xBE;
+constexpr uint8_t CMD_TRIGGER = 0xAC;
+constexpr uint8_t CMD_RESET = 0xBA;
+
+constexpr uint8_t STATUS_BUSY = 0x80;
+constexpr uint8_t STATUS_CALIBRATED = 0x08;
+constexpr uint8_t STATUS_BASE = 0x10;
+
+constexpr uint32_t STARTUP_US = 20000;      // Partida após a alimentação e após o reset
+constexpr uint32_t INIT_US = 10000;         // Carga da calibração pelo comando 0xBE
+constexpr uint32_t MEASUREMENT_US = 80000;
+constexpr double FULL_SCALE = 1 << 20;
+
+uint8_t crc8(const uint8_t *data, size_t len)
+{
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < len; i++)
+    {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++)
+            crc = crc & 0x80 ? (uint8_t)(crc << 1 ^ 0x31) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+} // namespace
+
+aht20_sim::aht20_sim(const environment &env, uint64_t seed) : sim_device(seed), env_(env)
+{
+    power_on(0);
+}
+
+void aht20_sim::power_on(uint64_t now_us)
+{
+    ready_us_ = now_us + STARTUP_US;
+    busy_until_us_ = 0;
+    measuring_ = false;
+    calibrated_ = calibrated_at_power_on;
+    std::fill(data_, data_ + 5, 0);
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    output_ = {nan, nan, nan};
+}
+
+void aht20_sim::advance(uint64_t now_us)
+{
+    if (!measuring_ || faults.stuck_busy || now_us < busy_until_us_)
+        return;
+    measuring_ = false;
+    counters.measurements++;
+
+    conditions real = env_.at(busy_until_us_);
+    double humidity = std::clamp(real.humidity_pct + gaussian(humidity_noise_pct), 0.0, 100.0);
+    double temperature = std::clamp(real.temperature_c + gaussian(temperature_noise_c), -50.0, 150.0);
+    uint32_t raw_humidity = std::min((uint32_t)std::lround(humidity / 100 * FULL_SCALE), 0xFFFFFu);
+    uint32_t raw_temperature = std::min((uint32_t)std::lround((temperature + 50) / 200 * FULL_SCALE), 0xFFFFFu);
+
+    data_[0] = (uint8_t)(raw_humidity >> 12);
+    data_[1] = (uint8_t)(raw_humidity >> 4);
+    data_[2] = (uint8_t)((raw_humidity & 0x0F) << 4 | raw_temperature >> 16);
+    data_[3] = (uint8_t)(raw_temperature >> 8);
+    data_[4] = (uint8_t)raw_temperature;
+    output_ = {raw_temperature * 200 / FULL_SCALE - 50, real.pressure_pa, raw_humidity * 100 / FULL_SCALE};
+}
+
+void aht20_sim::write(const uint8_t *data, size_t len, uint64_t now_us)
+{
+    advance(now_us);
+    bool busy = now_us < busy_until_us_ || faults.stuck_busy;
+
+    switch (data[0])
+    {
+    case CMD_INIT:
+        if (len == 3 && data[1] == 0x08 && data[2] == 0x00 && !busy)
+        {
+            calibrated_ = true;
+            busy_until_us_ = now_us + INIT_US;
+        }
+        break;
+    case CMD_TRIGGER:
+        // Disparo durante uma medição é ignorado
+        if (len == 3 && data[1] == 0x33 && data[2] == 0x00 && !busy)
+        {
+            measuring_ = true;
+            busy_until_us_ = now_us + MEASUREMENT_US + faults.slow_us;
+        }
+        break;
+    case CMD_RESET:
+        if (len == 1)
+            power_on(now_us);
+        break;
+    default:
+        break;
+    }
+}
+
+void aht20_sim::read(uint8_t *data, size_t len, uint64_t now_us)
+{
+    advance(now_us);
+    bool busy = now_us < busy_until_us_ || faults.stuck_busy;
+
+    uint8_t frame[7];
+    frame[0] = STATUS_BASE | (calibrated_ ? STATUS_CALIBRATED : 0) | (busy ? STATUS_BUSY : 0);
+    std::copy(data_, data_ + 5, frame + 1);
+    frame[6] = crc8(frame, 6);
+
+    // Além do CRC o sensor devolve 0xFF
+    for (size_t i = 0; i < len; i++)
+        data[i] = i < sizeof(frame) ? frame[i] : 0xFF;
+}
+
+} // namespace wx
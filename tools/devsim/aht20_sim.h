@@ -0,0 +1,48 @@
+#ifndef WX_AHT20_SIM_H
+#define WX_AHT20_SIM_H
+
+#include <cstdint>
+
+#include "environment.h"
+#include "sim_bus.h"
+
+namespace wx
+{
+
+// AHT20 no nível de comandos: inicialização (0xBE), disparo de medição (0xAC 0x33 0x00) e reset
+// (0xBA). Não responde ao endereço durante a partida e o reset; depois da partida o bit de
+// calibração já vem ligado (ou só após 0xBE, com calibrated_at_power_on = false). Um disparo deixa o
+// bit de ocupado ligado por 80 ms; a leitura devolve status, umidade e temperatura de 20 bits da
+// última medição concluída e o CRC-8 (polinômio 0x31), calculado aqui bit a bit.
+class aht20_sim : public sim_device
+{
+public:
+    aht20_sim(const environment &env, uint64_t seed);
+
+    bool acknowledge(uint64_t now_us) override { return now_us >= ready_us_; }
+    void write(const uint8_t *data, size_t len, uint64_t now_us) override;
+    void read(uint8_t *data, size_t len, uint64_t now_us) override;
+    void power_on(uint64_t now_us) override;
+
+    // Condições codificadas na última medição concluída (depois do ruído)
+    const conditions &output() const { return output_; }
+
+    double temperature_noise_c = 0.01;
+    double humidity_noise_pct = 0.024;
+    bool calibrated_at_power_on = true;
+
+private:
+    void advance(uint64_t now_us);
+
+    const environment &env_;
+    uint64_t ready_us_ = 0;        // Fim da partida ou do reset (NAK antes disso)
+    uint64_t busy_until_us_ = 0;
+    bool measuring_ = false;       // Medição disparada ainda não concluída
+    bool calibrated_ = false;
+    uint8_t data_[5] = {};
+    conditions output_{};
+};
+
+} // namespace wx
+
+#endif // WX_AHT20_SIM_H
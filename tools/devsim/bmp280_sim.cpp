@@ -0,0 +1,312 @@
+#include "bmp280_sim.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace wx
+{
+
+namespace
+{
+
+constexpr uint8_t CHIP_ID = 0x58;
+constexpr uint8_t REG_CALIB = 0x88;
+constexpr uint8_t REG_ID = 0xD0;
+constexpr uint8_t REG_RESET = 0xE0;
+constexpr uint8_t REG_STATUS = 0xF3;
+constexpr uint8_t REG_CTRL_MEAS = 0xF4;
+constexpr uint8_t REG_CONFIG = 0xF5;
+constexpr uint8_t REG_DATA = 0xF7;
+
+constexpr uint8_t RESET_WORD = 0xB6;
+constexpr uint8_t STATUS_MEASURING = 0x08;
+constexpr uint8_t STATUS_IM_UPDATE = 0x01;
+constexpr uint8_t MODE_SLEEP = 0x00;
+constexpr uint8_t MODE_NORMAL = 0x03;
+
+constexpr uint32_t NVM_COPY_US = 2000;  // Tempo de partida após alimentação ou reset
+constexpr uint32_t SKIPPED = 0x80000;   // Valor de uma medição desligada (oversampling x0)
+constexpr uint32_t ADC_MAX = 0xFFFFF;
+constexpr uint64_t MAX_BACKLOG = 1024;  // Conversões do modo normal simuladas de uma vez, no máximo
+constexpr double CONVERSION_JITTER_US = 20;
+
+const uint32_t standby_us[8] = {500, 62500, 125000, 250000, 500000, 1000000, 2000000, 4000000};
+
+// Amostras de um código de oversampling (0 = medição desligada; 5 a 7 = x16)
+uint32_t oversampling_count(uint8_t osrs)
+{
+    return osrs == 0 ? 0 : 1u << (osrs > 5 ? 4 : osrs - 1);
+}
+
+// Compensação em ponto flutuante do datasheet (seção 8.1)
+double t_fine_of(const bmp280_trimming &c, double adc_t)
+{
+    double var1 = (adc_t / 16384.0 - c.t1 / 1024.0) * c.t2;
+    double var2 = adc_t / 131072.0 - c.t1 / 8192.0;
+    return var1 + var2 * var2 * c.t3;
+}
+
+double pressure_of(const bmp280_trimming &c, double adc_p, double t_fine)
+{
+    double var1 = t_fine / 2.0 - 64000.0;
+    double var2 = var1 * var1 * c.p6 / 32768.0;
+    var2 = var2 + var1 * c.p5 * 2.0;
+    var2 = var2 / 4.0 + c.p4 * 65536.0;
+    var1 = (c.p3 * var1 * var1 / 524288.0 + c.p2 * var1) / 524288.0;
+    var1 = (1.0 + var1 / 32768.0) * c.p1;
+    if (var1 == 0)
+        return 0;
+    double p = 1048576.0 - adc_p;
+    p = (p - var2 / 4096.0) * 6250.0 / var1;
+    var1 = c.p9 * p * p / 2147483648.0;
+    var2 = p * c.p8 / 32768.0;
+    return p + (var1 + var2 + c.p7) / 16.0;
+}
+
+// Menor valor bruto em [0, ADC_MAX] cuja conversão alcança target (conversão crescente se rising),
+// ou o vizinho anterior se estiver mais perto
+template <typename F> uint32_t invert(F convert, double target, bool rising)
+{
+    auto reached = [&](uint32_t adc) { return rising ? convert(adc) >= target : convert(adc) <= target; };
+    uint32_t lo = 0, hi = ADC_MAX;
+    while (lo < hi)
+    {
+        uint32_t mid = (lo + hi) / 2;
+        if (reached(mid))
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    if (lo > 0 && std::fabs(convert(lo - 1) - target) < std::fabs(convert(lo) - target))
+        lo--;
+    return lo;
+}
+
+} // namespace
+
+bmp280_sim::bmp280_sim(const environment &env, uint64_t seed, const bmp280_trimming &trimming)
+    : sim_device(seed), env_(env), trimming_(trimming)
+{
+    speed_ = uniform();
+    power_on(0);
+}
+
+void bmp280_sim::power_on(uint64_t now_us)
+{
+    pointer_ = 0;
+    ctrl_meas_ = 0;
+    config_ = 0;
+    const uint8_t reset_data[6] = {0x80, 0x00, 0x00, 0x80, 0x00, 0x00};
+    std::copy(reset_data, reset_data + 6, data_);
+    nvm_ready_us_ = now_us + NVM_COPY_US;
+    converting_ = false;
+    filter_primed_ = false;
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    output_ = {nan, nan, nan};
+}
+
+uint32_t bmp280_sim::measurement_us()
+{
+    // t_measure típico e máximo (seção 3.8.1). O oscilador do chip fixa a duração entre os dois
+    // (speed_); cada conversão varia pouco em torno dela, mais o atraso injetado
+    uint32_t t = oversampling_count(ctrl_meas_ >> 5);
+    uint32_t p = oversampling_count((ctrl_meas_ >> 2) & 0x07);
+    uint32_t typ = 1000 + 2000 * t + (p ? 2000 * p + 500 : 0);
+    uint32_t max = 1250 + 2300 * t + (p ? 2300 * p + 575 : 0);
+    double duration = typ + speed_ * (max - typ) + gaussian(CONVERSION_JITTER_US);
+    return (uint32_t)std::max<double>(duration, typ) + faults.slow_us;
+}
+
+void bmp280_sim::start_conversion(uint64_t start_us)
+{
+    converting_ = true;
+    conversion_start_us_ = start_us;
+    conversion_end_us_ = start_us + measurement_us();
+}
+
+void bmp280_sim::advance(uint64_t now_us)
+{
+    while (converting_ && conversion_end_us_ <= now_us)
+    {
+        uint64_t standby = standby_us[config_ >> 5];
+        if ((ctrl_meas_ & 0x03) == MODE_NORMAL)
+        {
+            // Ninguém olhou por muito tempo: pula períodos inteiros em vez de simular cada conversão
+            uint64_t period = conversion_end_us_ - conversion_start_us_ + standby;
+            uint64_t behind = (now_us - conversion_end_us_) / period;
+            if (behind > MAX_BACKLOG)
+            {
+                conversion_start_us_ += (behind - MAX_BACKLOG) * period;
+                conversion_end_us_ += (behind - MAX_BACKLOG) * period;
+            }
+        }
+
+        finish_conversion();
+        if ((ctrl_meas_ & 0x03) == MODE_NORMAL)
+        {
+            start_conversion(conversion_end_us_ + standby);
+        }
+        else
+        {
+            // Modo forçado: volta a sleep depois de uma conversão
+            ctrl_meas_ &= ~0x03;
+            converting_ = false;
+        }
+    }
+}
+
+void bmp280_sim::finish_conversion()
+{
+    counters.measurements++;
+    conditions real = env_.at(conversion_end_us_);
+    uint32_t t_count = oversampling_count(ctrl_meas_ >> 5);
+    uint32_t p_count = oversampling_count((ctrl_meas_ >> 2) & 0x07);
+    uint8_t filter = (config_ >> 2) & 0x07;
+    double coefficient = filter == 0 ? 1 : 1u << (filter > 4 ? 4 : filter);
+
+    // Ruído de cada medição cai com a raiz do número de amostras; o filtro IIR suaviza o resto
+    double temperature = real.temperature_c + (t_count ? gaussian(temperature_noise_c / std::sqrt(t_count)) : 0);
+    double pressure = real.pressure_pa + (p_count ? gaussian(pressure_noise_pa / std::sqrt(p_count)) : 0);
+    if (!filter_primed_ || filter == 0)
+    {
+        filtered_temperature_ = temperature;
+        filtered_pressure_ = pressure;
+        filter_primed_ = true;
+    }
+    else
+    {
+        filtered_temperature_ += (temperature - filtered_temperature_) / coefficient;
+        filtered_pressure_ += (pressure - filtered_pressure_) / coefficient;
+    }
+
+    // Sem filtro a resolução é de 16 bits em x1 até 20 bits em x16; com filtro, sempre 20 bits
+    auto quantize = [filter](uint32_t adc, uint32_t count) {
+        uint32_t drop = filter ? 0 : 4 - __builtin_ctz(count);
+        return adc & ~((1u << drop) - 1);
+    };
+
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    double t_fine = 0;
+    uint32_t adc_t = SKIPPED;
+    output_ = {nan, nan, real.humidity_pct};
+    if (t_count)
+    {
+        adc_t = quantize(encode_temperature(filtered_temperature_), t_count);
+        t_fine = t_fine_of(trimming_, adc_t);
+        output_.temperature_c = t_fine / 5120.0;
+    }
+    uint32_t adc_p = SKIPPED;
+    if (p_count && t_count)
+    {
+        adc_p = quantize(encode_pressure(filtered_pressure_, t_fine), p_count);
+        output_.pressure_pa = pressure_of(trimming_, adc_p, t_fine);
+    }
+    else if (p_count)
+    {
+        adc_p = quantize(encode_pressure(filtered_pressure_, t_fine_of(trimming_, SKIPPED)), p_count);
+    }
+
+    data_[0] = (uint8_t)(adc_p >> 12);
+    data_[1] = (uint8_t)(adc_p >> 4);
+    data_[2] = (uint8_t)(adc_p << 4);
+    data_[3] = (uint8_t)(adc_t >> 12);
+    data_[4] = (uint8_t)(adc_t >> 4);
+    data_[5] = (uint8_t)(adc_t << 4);
+}
+
+uint32_t bmp280_sim::encode_temperature(double temperature_c) const
+{
+    return invert([this](uint32_t adc) { return t_fine_of(trimming_, adc); }, temperature_c * 5120.0, true);
+}
+
+uint32_t bmp280_sim::encode_pressure(double pressure_pa, double t_fine) const
+{
+    return invert([this, t_fine](uint32_t adc) { return pressure_of(trimming_, adc, t_fine); }, pressure_pa, false);
+}
+
+uint8_t bmp280_sim::read_register(uint8_t reg, uint64_t now_us)
+{
+    if (reg >= REG_CALIB && reg < REG_CALIB + 24)
+    {
+        const uint16_t words[12] = {trimming_.t1,           (uint16_t)trimming_.t2, (uint16_t)trimming_.t3,
+                                    trimming_.p1,           (uint16_t)trimming_.p2, (uint16_t)trimming_.p3,
+                                    (uint16_t)trimming_.p4, (uint16_t)trimming_.p5, (uint16_t)trimming_.p6,
+                                    (uint16_t)trimming_.p7, (uint16_t)trimming_.p8, (uint16_t)trimming_.p9};
+        uint16_t word = words[(reg - REG_CALIB) / 2];
+        return (reg - REG_CALIB) % 2 ? (uint8_t)(word >> 8) : (uint8_t)word;
+    }
+    if (reg >= REG_DATA && reg < REG_DATA + 6)
+        return data_[reg - REG_DATA];
+
+    switch (reg)
+    {
+    case REG_ID:
+        return CHIP_ID;
+    case REG_STATUS:
+    {
+        bool measuring = converting_ && now_us >= conversion_start_us_;
+        return (measuring || faults.stuck_busy ? STATUS_MEASURING : 0) | (now_us < nvm_ready_us_ ? STATUS_IM_UPDATE : 0);
+    }
+    case REG_CTRL_MEAS:
+        return ctrl_meas_;
+    case REG_CONFIG:
+        return config_;
+    default:
+        return 0x00;
+    }
+}
+
+void bmp280_sim::write_register(uint8_t reg, uint8_t value, uint64_t now_us)
+{
+    switch (reg)
+    {
+    case REG_RESET:
+        if (value == RESET_WORD)
+            power_on(now_us);
+        break;
+    case REG_CTRL_MEAS:
+    {
+        uint8_t previous = ctrl_meas_ & 0x03;
+        uint8_t mode = value & 0x03;
+        ctrl_meas_ = value;
+        if (mode == MODE_SLEEP)
+            converting_ = false;
+        else if (mode != MODE_NORMAL || previous != MODE_NORMAL)
+            start_conversion(now_us); // Modo forçado, ou a primeira conversão do modo normal
+        break;
+    }
+    case REG_CONFIG:
+        // No modo normal a escrita pode ser ignorada (seção 5.4.6); aqui ela sempre é
+        if ((ctrl_meas_ & 0x03) != MODE_NORMAL)
+        {
+            config_ = value & ~0x02;
+            filter_primed_ = false;
+        }
+        break;
+    default:
+        break; // Registradores só de leitura
+    }
+}
+
+void bmp280_sim::write(const uint8_t *data, size_t len, uint64_t now_us)
+{
+    advance(now_us);
+
+    // Pares registrador/valor; um byte final sozinho só posiciona o ponteiro de leitura
+    size_t i = 0;
+    for (; i + 1 < len; i += 2)
+        write_register(data[i], data[i + 1], now_us);
+    pointer_ = data[i < len ? i : i - 2];
+}
+
+void bmp280_sim::read(uint8_t *data, size_t len, uint64_t now_us)
+{
+    advance(now_us);
+
+    // Leitura em rajada com auto-incremento; os dados vêm de uma única conversão (shadowing)
+    for (size_t i = 0; i < len; i++)
+        data[i] = read_register(pointer_++, now_us);
+}
+
+} // namespace wx
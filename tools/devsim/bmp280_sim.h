@@ -0,0 +1,76 @@
+#ifndef WX_BMP280_SIM_H
+#define WX_BMP280_SIM_H
+
+#include <cstdint>
+
+#include "environment.h"
+#include "sim_bus.h"
+
+namespace wx
+{
+
+// Coeficientes de calibração gravados na NVM (0x88 a 0x9F)
+struct bmp280_trimming
+{
+    uint16_t t1;
+    int16_t t2, t3;
+    uint16_t p1;
+    int16_t p2, p3, p4, p5, p6, p7, p8, p9;
+};
+
+// Exemplo de calibração do datasheet (seção 3.12)
+constexpr bmp280_trimming BMP280_DATASHEET_TRIMMING = {27504, 26435, -1000, 36477, -10685, 3024,
+                                                       2855,  140,   -7,    15500, -14600, 6000};
+
+// BMP280 no nível de registradores: chip ID, reset, calibração, ctrl_meas, config, status e dados.
+// Os modos forçado e normal seguem os tempos do datasheet (t_measure entre o típico e o máximo,
+// conforme o chip, e t_standby no modo normal), com o bit "measuring" durante cada conversão e os dados
+// atualizados no fim dela. As leituras aplicam o oversampling (resolução e ruído) e o filtro IIR, e
+// são codificadas invertendo a compensação em ponto flutuante do datasheet, independente da
+// compensação inteira do driver. Escritas em config no modo normal são ignoradas, como no chip.
+class bmp280_sim : public sim_device
+{
+public:
+    bmp280_sim(const environment &env, uint64_t seed, const bmp280_trimming &trimming = BMP280_DATASHEET_TRIMMING);
+
+    void write(const uint8_t *data, size_t len, uint64_t now_us) override;
+    void read(uint8_t *data, size_t len, uint64_t now_us) override;
+    void power_on(uint64_t now_us) override;
+
+    // Condições codificadas nos registradores de dados (depois do ruído e do filtro)
+    const conditions &output() const { return output_; }
+
+    // Desvio-padrão do ruído de uma medição x1 (escalado pelo multiplicador global de ruído)
+    double temperature_noise_c = 0.005;
+    double pressure_noise_pa = 1.3;
+
+private:
+    void advance(uint64_t now_us);
+    void start_conversion(uint64_t start_us);
+    void finish_conversion();
+    uint8_t read_register(uint8_t reg, uint64_t now_us);
+    void write_register(uint8_t reg, uint8_t value, uint64_t now_us);
+    uint32_t measurement_us();
+    uint32_t encode_temperature(double temperature_c) const;
+    uint32_t encode_pressure(double pressure_pa, double t_fine) const;
+
+    const environment &env_;
+    bmp280_trimming trimming_;
+    double speed_;                  // Posição da duração das conversões entre o típico (0) e o máximo (1)
+    uint8_t pointer_ = 0;
+    uint8_t ctrl_meas_ = 0;
+    uint8_t config_ = 0;
+    uint8_t data_[6] = {};
+    uint64_t nvm_ready_us_ = 0;     // Fim da cópia da NVM após alimentação ou reset
+    bool converting_ = false;
+    uint64_t conversion_start_us_ = 0;
+    uint64_t conversion_end_us_ = 0;
+    bool filter_primed_ = false;
+    double filtered_temperature_ = 0;
+    double filtered_pressure_ = 0;
+    conditions output_{};
+};
+
+} // namespace wx
+
+#endif // WX_BMP280_SIM_H
@@ -0,0 +1,462 @@
+// Roda lib/bmp280 e lib/aht20, sem modificações, contra os sensores emulados, no tempo virtual.
+//
+//   devsim [--duration S] [--interval MS] [--env constant|diurnal|front|extremes] [--noise K]
+//          [--bmp-profile NOME] [--seed N] [--fault DISP:TIPO[=VALOR]]... [--bench N] [--verbose]
+//
+// A aquisição repete a do firmware: o AHT20 é disparado antes do instante da amostra, uma conversão
+// do BMP280 que termina até o instante é esperada com bmp280_wait_conversion e os dois são lidos por
+// transferências assíncronas no instante, com uma nova leitura do AHT20 se vier ocupado ou com CRC
+// inválido. Cada leitura é comparada com o que o emulador codificou nos registradores (erro do
+// driver: arredondamento e compensação inteira) e com o ambiente (erro total: ruído, filtro e
+// atraso). O tempo virtual só avança pelas esperas e transferências, então horas de amostragem
+// rodam em segundos.
+//
+// Falhas (--fault, repetível): DISP é bmp280 ou aht20 e TIPO um de
+//   nak=P          NAK no endereço com probabilidade P por transação
+//   corrupt=P      um bit trocado nos bytes lidos com probabilidade P por transação
+//   stuck-busy     bit de ocupado/"measuring" preso em 1
+//   stretch-us=US  clock stretching em cada transação (acima do prazo do lib/i2c_bus vira timeout)
+//   slow-us=US     tempo somado a cada medição
+//   power-cycle=S  queda de alimentação no instante S (o sensor volta do zero)
+//   uncalibrated   (aht20) calibração só após o comando de inicialização
+//
+// Sai com 1 se um sensor sem falhas injetadas entregar uma leitura aceita pelo driver fora da
+// tolerância; com falhas, as leituras erradas aceitas só são contadas.
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "aht20_sim.h"
+#include "bmp280_sim.h"
+#include "environment.h"
+#include "sim_bus.h"
+
+extern "C" {
+#include "aht20/aht20.h"
+#include "bmp280/bmp280.h"
+}
+
+namespace
+{
+
+constexpr uint32_t BAUDRATE = 400000;
+
+// Diferença máxima entre o driver e o valor codificado: o driver arredonda para centésimos e a
+// compensação inteira de 32 bits do BMP280 se afasta da de ponto flutuante em até ~7 Pa na faixa
+// do sensor (varredura com a calibração de exemplo do datasheet)
+constexpr double TEMPERATURE_TOLERANCE_C = 0.011;
+constexpr double HUMIDITY_TOLERANCE_PCT = 0.011;
+constexpr double PRESSURE_TOLERANCE_PA = 8.0;
+
+struct options
+{
+    double duration_s = 3600;
+    uint32_t interval_ms = 2000;
+    std::string env = "constant";
+    double noise = 1;
+    std::string bmp_profile = "standard";
+    uint64_t seed = 1;
+    uint64_t bench = 0;
+    bool verbose = false;
+};
+
+// Média e máximo de um erro absoluto
+struct error_stats
+{
+    uint64_t count = 0;
+    double sum = 0;
+    double max = 0;
+
+    void add(double error)
+    {
+        error = std::fabs(error);
+        count++;
+        sum += error;
+        if (error > max)
+            max = error;
+    }
+    double mean() const { return count ? sum / count : 0; }
+};
+
+struct sensor_report
+{
+    uint64_t reads = 0;
+    uint64_t accepted = 0;
+    uint64_t rejected = 0;       // Falha de barramento ou resultado descartado pelo driver
+    uint64_t mismatched = 0;     // Aceitas pelo driver, mas diferentes do que o sensor codificou
+    error_stats driver[2];       // Driver contra o valor codificado
+    error_stats total[2];        // Driver contra o ambiente
+};
+
+options opts;
+
+volatile i2c_bus_result_t bmp_transfer_result;
+volatile i2c_bus_result_t aht_transfer_result;
+
+void on_transfer(i2c_bus_result_t result, void *user_data)
+{
+    *(volatile i2c_bus_result_t *)user_data = result;
+}
+
+bool faults_injected(const wx::sim_faults &faults)
+{
+    return faults.nak_rate > 0 || faults.corrupt_rate > 0 || faults.stuck_busy || faults.stretch_us ||
+           faults.slow_us || faults.power_cycle_s >= 0;
+}
+
+// Aplica "DISP:TIPO[=VALOR]"
+bool apply_fault(const std::string &spec, wx::bmp280_sim &bmp, wx::aht20_sim &aht)
+{
+    size_t colon = spec.find(':');
+    if (colon == std::string::npos)
+        return false;
+    std::string device = spec.substr(0, colon);
+    std::string kind = spec.substr(colon + 1);
+    std::string value;
+    size_t equals = kind.find('=');
+    if (equals != std::string::npos)
+    {
+        value = kind.substr(equals + 1);
+        kind = kind.substr(0, equals);
+    }
+
+    wx::sim_device *target = device == "bmp280" ? (wx::sim_device *)&bmp : device == "aht20" ? &aht : nullptr;
+    if (!target)
+        return false;
+    wx::sim_faults &faults = target->faults;
+    double number = strtod(value.c_str(), nullptr);
+
+    if (kind == "nak" && !value.empty())
+        faults.nak_rate = number;
+    else if (kind == "corrupt" && !value.empty())
+        faults.corrupt_rate = number;
+    else if (kind == "stuck-busy" && value.empty())
+        faults.stuck_busy = true;
+    else if (kind == "stretch-us" && !value.empty())
+        faults.stretch_us = (uint32_t)number;
+    else if (kind == "slow-us" && !value.empty())
+        faults.slow_us = (uint32_t)number;
+    else if (kind == "power-cycle" && !value.empty())
+        faults.power_cycle_s = number;
+    else if (kind == "uncalibrated" && value.empty() && target == &aht)
+    {
+        aht.calibrated_at_power_on = false;
+        aht.power_on(0);
+    }
+    else
+        return false;
+    return true;
+}
+
+// Antecedência do início da aquisição, como acquisition_lead_us no firmware
+uint32_t acquisition_lead_us(const bmp280_t *bmp)
+{
+    uint32_t bmp_lead = bmp280_measurement_time_max_us(bmp280_get_profile(bmp));
+    uint32_t aht_lead = AHT20_MEASUREMENT_MS * 1000;
+    return bmp_lead > aht_lead ? bmp_lead : aht_lead;
+}
+
+void print_sensor(const char *name, const sensor_report &report, const char *units[2], const char *labels[2])
+{
+    printf("%s: %llu leituras, %llu aceitas, %llu rejeitadas, %llu aceitas com valor errado\n", name,
+           (unsigned long long)report.reads, (unsigned long long)report.accepted,
+           (unsigned long long)report.rejected, (unsigned long long)report.mismatched);
+    for (int i = 0; i < 2; i++)
+    {
+        printf("  %-12s driver: médio %.4f / máx %.4f %s   ambiente: médio %.4f / máx %.4f %s\n", labels[i],
+               report.driver[i].mean(), report.driver[i].max, units[i], report.total[i].mean(), report.total[i].max,
+               units[i]);
+    }
+}
+
+void print_bus(const char *name, const i2c_bus_t *bus, const wx::sim_device &device)
+{
+    i2c_bus_stats_t stats;
+    i2c_bus_get_stats(bus, &stats);
+    printf("%s: %lu transações, %lu NAKs, %lu timeouts, %lu recuperações, %lu reidentificações, latência máx %lu µs; "
+           "emulador: %llu NAKs, %llu bits trocados, %llu medições\n",
+           name, (unsigned long)stats.transfers, (unsigned long)stats.naks, (unsigned long)stats.timeouts,
+           (unsigned long)stats.recoveries, (unsigned long)stats.reprobes, (unsigned long)stats.max_latency_us,
+           (unsigned long long)device.counters.naks, (unsigned long long)device.counters.corrupted,
+           (unsigned long long)device.counters.measurements);
+}
+
+// Custo no host das conversões dos drivers, em ns por chamada
+void bench(bmp280_t *bmp, aht20_t *aht)
+{
+    volatile int32_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < opts.bench; i++)
+    {
+        int32_t raw_temp, raw_pressure;
+        bmp->raw[5] = (uint8_t)i;
+        bmp280_parse_raw(bmp, &raw_temp, &raw_pressure);
+        sink = bmp280_convert_temp(raw_temp, &bmp->calib) + bmp280_convert_pressure(raw_pressure, raw_temp, &bmp->calib);
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < opts.bench; i++)
+    {
+        AHT20_Data data;
+        aht->buffer[5] = (uint8_t)i;
+        aht->buffer[6] = aht20_crc8(aht->buffer, AHT20_RESULT_SIZE - 1);
+        sink = sink + (aht20_parse(aht, &data) == AHT20_OK ? data.temperature : 0);
+    }
+    auto end = std::chrono::steady_clock::now();
+    (void)sink;
+
+    auto per_call = [](std::chrono::steady_clock::duration elapsed) {
+        return std::chrono::duration<double, std::nano>(elapsed).count() / opts.bench;
+    };
+    printf("bench (%llu chamadas): bmp280 parse+compensação %.1f ns, aht20 CRC+parse %.1f ns\n",
+           (unsigned long long)opts.bench, per_call(middle - start), per_call(end - middle));
+}
+
+void usage()
+{
+    fprintf(stderr, "uso: devsim [--duration S] [--interval MS] [--env constant|diurnal|front|extremes] [--noise K]\n"
+                    "              [--bmp-profile NOME] [--seed N] [--fault DISP:TIPO[=VALOR]]... [--bench N]\n"
+                    "              [--verbose]\n");
+    exit(2);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    wx::environment env;
+    std::string faults[16];
+    int fault_count = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--verbose")
+        {
+            opts.verbose = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+            usage();
+        const char *value = argv[++i];
+        if (arg == "--duration")
+            opts.duration_s = strtod(value, nullptr);
+        else if (arg == "--interval")
+            opts.interval_ms = (uint32_t)strtoul(value, nullptr, 10);
+        else if (arg == "--env")
+            opts.env = value;
+        else if (arg == "--noise")
+            opts.noise = strtod(value, nullptr);
+        else if (arg == "--bmp-profile")
+            opts.bmp_profile = value;
+        else if (arg == "--seed")
+            opts.seed = strtoull(value, nullptr, 10);
+        else if (arg == "--bench")
+            opts.bench = strtoull(value, nullptr, 10);
+        else if (arg == "--fault" && fault_count < 16)
+            faults[fault_count++] = value;
+        else
+            usage();
+    }
+    bmp280_profile_t profile;
+    if (!env.select(opts.env) || !bmp280_profile_from_name(opts.bmp_profile.c_str(), &profile) ||
+        opts.duration_s <= 0 || opts.interval_ms == 0 || opts.noise < 0)
+        usage();
+
+    // Cada gerador com sua semente: mudar um dispositivo não muda o ruído do outro
+    wx::bmp280_sim bmp_sim(env, opts.seed * 4 + 1);
+    wx::aht20_sim aht_sim(env, opts.seed * 4 + 2);
+    bmp_sim.temperature_noise_c *= opts.noise;
+    bmp_sim.pressure_noise_pa *= opts.noise;
+    aht_sim.temperature_noise_c *= opts.noise;
+    aht_sim.humidity_noise_pct *= opts.noise;
+    for (int i = 0; i < fault_count; i++)
+    {
+        if (!apply_fault(faults[i], bmp_sim, aht_sim))
+        {
+            fprintf(stderr, "devsim: falha inválida: %s\n", faults[i].c_str());
+            usage();
+        }
+    }
+
+    wx::sim_bus bus0(opts.seed * 4 + 3);
+    wx::sim_bus bus1(opts.seed * 4 + 4);
+    bus0.attach(BMP280_ADDR_PRIMARY, &bmp_sim);
+    bus1.attach(AHT20_I2C_ADDR, &aht_sim);
+    i2c_bus_t i2c_bus0, i2c_bus1;
+    i2c_bus_init(&i2c_bus0, bus0.inst(), 0, 1, BAUDRATE);
+    i2c_bus_init(&i2c_bus1, bus1.inst(), 2, 3, BAUDRATE);
+
+    static bmp280_t bmp280;
+    static aht20_t aht20;
+    bool bmp_found = bmp280_init(&bmp280, &i2c_bus0, BMP280_ADDR_PRIMARY);
+    bool aht_found = aht20_init(&aht20, &i2c_bus1, AHT20_I2C_ADDR);
+    if (bmp_found)
+        bmp280_set_profile(&bmp280, profile);
+    printf("devsim: ambiente %s, perfil %s, %.0f s a cada %lu ms (virtuais), ruído x%.2f, semente %llu\n",
+           env.name().c_str(), opts.bmp_profile.c_str(), opts.duration_s, (unsigned long)opts.interval_ms, opts.noise,
+           (unsigned long long)opts.seed);
+    printf("init: BMP280 %s, AHT20 %s (em %.1f ms)\n", bmp_found ? "ok" : "falhou", aht_found ? "ok" : "falhou",
+           wx::sim_now_us() / 1000.0);
+
+    sensor_report bmp_report, aht_report;
+    uint64_t aht_results[AHT20_BUS_ERROR + 1] = {};
+    uint64_t aht_retries = 0;
+    uint64_t samples = 0, late_samples = 0;
+    uint64_t max_late_us = 0;
+    error_stats conversion_age_ms;
+    bool bmp_faulty = faults_injected(bmp_sim.faults);
+    bool aht_faulty = faults_injected(aht_sim.faults) || !aht_sim.calibrated_at_power_on;
+
+    uint64_t interval_us = (uint64_t)opts.interval_ms * 1000;
+    uint64_t end_us = (uint64_t)(opts.duration_s * 1e6);
+    uint64_t tick_us = wx::sim_now_us() + acquisition_lead_us(&bmp280);
+    auto host_start = std::chrono::steady_clock::now();
+
+    for (; tick_us < end_us; tick_us += interval_us)
+    {
+        i2c_bus_service(&i2c_bus0);
+        i2c_bus_service(&i2c_bus1);
+
+        uint32_t lead_us = acquisition_lead_us(&bmp280);
+        sleep_until(from_us_since_boot(tick_us > lead_us ? tick_us - lead_us : 0));
+        aht20_trigger_async(&aht20, NULL, NULL);
+
+        absolute_time_t conversion_end = bmp280_wait_conversion(&bmp280, from_us_since_boot(tick_us));
+        sleep_until(from_us_since_boot(tick_us));
+        uint64_t acquired_us = wx::sim_now_us();
+        samples++;
+        if (acquired_us > tick_us)
+        {
+            late_samples++;
+            if (acquired_us - tick_us > max_late_us)
+                max_late_us = acquired_us - tick_us;
+        }
+        conversion_age_ms.add((double)absolute_time_diff_us(conversion_end, from_us_since_boot(acquired_us)) / 1000);
+
+        uint64_t bmp_corrupted = bmp_sim.counters.corrupted;
+        uint64_t aht_corrupted = aht_sim.counters.corrupted;
+        bmp_transfer_result = I2C_BUS_ERR_ABORT;
+        aht_transfer_result = I2C_BUS_ERR_ABORT;
+        bmp280_read_raw_async(&bmp280, on_transfer, (void *)&bmp_transfer_result);
+        aht20_fetch_async(&aht20, on_transfer, (void *)&aht_transfer_result);
+
+        AHT20_Data data = {0, 0};
+        aht20_result_t aht_result = aht_transfer_result == I2C_BUS_OK ? aht20_parse(&aht20, &data) : AHT20_BUS_ERROR;
+        if (aht_result == AHT20_BUSY || aht_result == AHT20_CRC_ERROR)
+        {
+            aht_retries++;
+            if (aht_result == AHT20_BUSY)
+                sleep_ms(AHT20_BUSY_RETRY_MS);
+            aht_result = aht20_fetch(&aht20) ? aht20_parse(&aht20, &data) : AHT20_BUS_ERROR;
+        }
+        aht_results[aht_result]++;
+
+        // BMP280: o sensor não tem verificação de integridade, só o driver decide
+        wx::conditions real = env.at(to_us_since_boot(conversion_end));
+        bmp_report.reads++;
+        int32_t bmp_temp = 0, pressure = 0;
+        if (bmp280.ready && bmp_transfer_result == I2C_BUS_OK && bmp280_check_raw(&bmp280))
+        {
+            int32_t raw_temp, raw_pressure;
+            bmp280_parse_raw(&bmp280, &raw_temp, &raw_pressure);
+            bmp_temp = bmp280_convert_temp(raw_temp, &bmp280.calib);
+            pressure = bmp280_convert_pressure(raw_pressure, raw_temp, &bmp280.calib);
+            bmp_report.accepted++;
+
+            const wx::conditions &encoded = bmp_sim.output();
+            double errors[2] = {bmp_temp / 100.0 - encoded.temperature_c, pressure - encoded.pressure_pa};
+            // Sem conversão nos registradores (sensor reiniciado) também é um valor errado aceito
+            if (std::isnan(errors[0]) || std::isnan(errors[1]) || std::fabs(errors[0]) > TEMPERATURE_TOLERANCE_C ||
+                std::fabs(errors[1]) > PRESSURE_TOLERANCE_PA)
+            {
+                bmp_report.mismatched++;
+                if (opts.verbose)
+                    printf("  BMP280 fora da tolerância em %.3f s: %.2f °C %ld Pa (codificado %.3f °C %.1f Pa)%s\n",
+                           acquired_us / 1e6, bmp_temp / 100.0, (long)pressure, encoded.temperature_c,
+                           encoded.pressure_pa, bmp_sim.counters.corrupted != bmp_corrupted ? ", bit trocado" : "");
+            }
+            else
+            {
+                bmp_report.driver[0].add(errors[0]);
+                bmp_report.driver[1].add(errors[1]);
+                bmp_report.total[0].add(bmp_temp / 100.0 - real.temperature_c);
+                bmp_report.total[1].add(pressure - real.pressure_pa);
+            }
+        }
+        else
+        {
+            bmp_report.rejected++;
+        }
+
+        // AHT20: o CRC deve barrar os bytes corrompidos
+        aht_report.reads++;
+        if (aht_result == AHT20_OK)
+        {
+            aht_report.accepted++;
+            const wx::conditions &encoded = aht_sim.output();
+            real = env.at(acquired_us);
+            double errors[2] = {data.temperature / 100.0 - encoded.temperature_c, data.humidity / 100.0 - encoded.humidity_pct};
+            if (std::isnan(errors[0]) || std::isnan(errors[1]) || std::fabs(errors[0]) > TEMPERATURE_TOLERANCE_C ||
+                std::fabs(errors[1]) > HUMIDITY_TOLERANCE_PCT)
+            {
+                aht_report.mismatched++;
+                if (opts.verbose)
+                    printf("  AHT20 fora da tolerância em %.3f s: %.2f °C %.2f %% (codificado %.3f °C %.3f %%)%s\n",
+                           acquired_us / 1e6, data.temperature / 100.0, data.humidity / 100.0,
+                           encoded.temperature_c, encoded.humidity_pct,
+                           aht_sim.counters.corrupted != aht_corrupted ? ", bit trocado" : "");
+            }
+            else
+            {
+                aht_report.driver[0].add(errors[0]);
+                aht_report.driver[1].add(errors[1]);
+                aht_report.total[0].add(data.temperature / 100.0 - real.temperature_c);
+                aht_report.total[1].add(data.humidity / 100.0 - real.humidity_pct);
+            }
+        }
+        else
+        {
+            aht_report.rejected++;
+        }
+
+        if (opts.verbose)
+        {
+            printf("%10.3f s  BMP280 %s %6.2f °C %7.1f hPa  AHT20 %-9s %6.2f °C %6.2f %%\n", acquired_us / 1e6,
+                   i2c_bus_result_str(bmp_transfer_result), bmp_temp / 100.0, pressure / 100.0,
+                   aht20_result_str(aht_result), data.temperature / 100.0, data.humidity / 100.0);
+        }
+    }
+    double host_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - host_start).count();
+
+    const char *bmp_units[2] = {"°C", "Pa"};
+    const char *bmp_labels[2] = {"temperatura", "pressão"};
+    const char *aht_units[2] = {"°C", "%"};
+    const char *aht_labels[2] = {"temperatura", "umidade"};
+    print_sensor("BMP280", bmp_report, bmp_units, bmp_labels);
+    printf("  conversão: idade no instante média %.2f / máx %.2f ms; %llu de %llu amostras atrasadas (máx %llu µs)\n",
+           conversion_age_ms.mean(), conversion_age_ms.max, (unsigned long long)late_samples,
+           (unsigned long long)samples, (unsigned long long)max_late_us);
+    print_sensor("AHT20", aht_report, aht_units, aht_labels);
+    printf("  resultados: %llu ok, %llu busy, %llu crc-error, %llu bus-error; %llu releituras\n",
+           (unsigned long long)aht_results[AHT20_OK], (unsigned long long)aht_results[AHT20_BUSY],
+           (unsigned long long)aht_results[AHT20_CRC_ERROR], (unsigned long long)aht_results[AHT20_BUS_ERROR],
+           (unsigned long long)aht_retries);
+    print_bus("i2c0 (BMP280)", &i2c_bus0, bmp_sim);
+    print_bus("i2c1 (AHT20)", &i2c_bus1, aht_sim);
+    printf("host: %.3f s para %.0f s virtuais (%.1f µs por amostra)\n", host_s, wx::sim_now_us() / 1e6,
+           samples ? host_s * 1e6 / samples : 0.0);
+
+    if (opts.bench)
+        bench(&bmp280, &aht20);
+
+    bool failed = (!bmp_faulty && (bmp_report.mismatched || !bmp_found)) ||
+                  (!aht_faulty && (aht_report.mismatched || !aht_found));
+    if (failed)
+        printf("FALHA: sensor sem falhas injetadas ausente ou com leitura errada aceita\n");
+    return failed ? 1 : 0;
+}
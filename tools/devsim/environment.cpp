@@ -0,0 +1,61 @@
+#include "environment.h"
+
+#include <cmath>
+
+namespace wx
+{
+
+namespace
+{
+
+constexpr double DAY_S = 86400;
+
+// Onda triangular entre 0 e 1 com o período dado
+double triangle(double t, double period)
+{
+    double phase = std::fmod(t / period, 1.0);
+    return phase < 0.5 ? phase * 2 : 2 - phase * 2;
+}
+
+// Degrau suave de 0 a 1 centrado em center, com a largura dada
+double smooth_step(double t, double center, double width)
+{
+    return 0.5 * (1 + std::tanh((t - center) / width));
+}
+
+} // namespace
+
+bool environment::select(const std::string &name)
+{
+    if (name != "constant" && name != "diurnal" && name != "front" && name != "extremes")
+        return false;
+    name_ = name;
+    return true;
+}
+
+conditions environment::at(uint64_t us) const
+{
+    double t = us / 1e6;
+    if (name_ == "diurnal")
+    {
+        // Temperatura com mínima às 3 h e máxima às 15 h; maré de pressão com máximos às 10 h e às 22 h
+        double day = std::sin(2 * M_PI * (t / DAY_S - 0.375));
+        double tide = std::cos(4 * M_PI * (t / DAY_S - 10.0 / 24));
+        return {22 + 6 * day, 101325 + 80 * tide, 60 - 20 * day};
+    }
+    if (name_ == "front")
+    {
+        double fall = smooth_step(t, 1.5 * 3600, 3600);
+        double passage = smooth_step(t, 3 * 3600, 600);
+        double rise = smooth_step(t, 4.5 * 3600, 1800);
+        return {24 - 6 * passage, 101500 - 600 * fall + 400 * rise, 55 + 35 * passage - 15 * rise};
+    }
+    if (name_ == "extremes")
+    {
+        // Períodos diferentes para cobrir combinações de temperatura e pressão
+        return {-40 + 125 * triangle(t, 3600), 30000 + 80000 * triangle(t, 3000), 100 * triangle(t, 2400)};
+    }
+    return {25, 101325, 50};
+}
+
+} // namespace wx
@@ -0,0 +1,42 @@
+#ifndef WX_ENVIRONMENT_H
+#define WX_ENVIRONMENT_H
+
+#include <cstdint>
+#include <string>
+
+namespace wx
+{
+
+// Condições físicas em torno dos sensores
+struct conditions
+{
+    double temperature_c;
+    double pressure_pa;
+    double humidity_pct;
+};
+
+// Perfil ambiental: as condições em função do tempo virtual. Os sensores emulados amostram o
+// perfil no fim de cada medição e somam o ruído deles.
+//   constant  25 °C, 1013,25 hPa, 50 %
+//   diurnal   ciclo de 24 h: mínima às 3 h, máxima às 15 h, umidade oposta à temperatura e a maré
+//             semidiurna da pressão
+//   front     passagem de uma frente fria: a pressão cai 6 hPa em 3 h, a temperatura cai 6 °C e a
+//             umidade sobe a 90 % na passagem, e a pressão volta a subir
+//   extremes  varredura em rampas das faixas dos sensores (-40 a 85 °C, 300 a 1100 hPa, 0 a 100 %)
+//             de 40 a 60 min, para exercitar a conversão nos extremos
+class environment
+{
+public:
+    // Perfil pelo nome; false se não for reconhecido
+    bool select(const std::string &name);
+    const std::string &name() const { return name_; }
+
+    conditions at(uint64_t us) const;
+
+private:
+    std::string name_ = "constant";
+};
+
+} // namespace wx
+
+#endif // WX_ENVIRONMENT_H
@@ -0,0 +1,8 @@
+#ifndef DEVSIM_HARDWARE_I2C_H
+#define DEVSIM_HARDWARE_I2C_H
+
+// Substituto do hardware/i2c.h: no host, a instância do periférico é o barramento simulado
+// (wx::sim_bus::inst), ao qual os dispositivos emulados estão ligados.
+typedef struct i2c_inst i2c_inst_t;
+
+#endif // DEVSIM_HARDWARE_I2C_H
@@ -0,0 +1,47 @@
+#ifndef DEVSIM_PICO_STDLIB_H
+#define DEVSIM_PICO_STDLIB_H
+
+// Substituto do pico/stdlib.h para compilar os drivers no host: só o que lib/bmp280 e lib/aht20
+// (e o cabeçalho de lib/i2c_bus) usam. O tempo é virtual (sim_bus.cpp): as esperas avançam o
+// relógio na hora, e cada transação I2C o avança pela duração da transferência.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _u
+#define _u(x) x##u
+#endif
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+typedef int32_t alarm_id_t;
+
+// Relógio virtual, em µs desde o "boot" da simulação
+uint64_t devsim_time_us(void);
+void devsim_sleep_until_us(uint64_t us);
+
+static inline uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+static inline absolute_time_t from_us_since_boot(uint64_t us) { return us; }
+static inline uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000); }
+static inline absolute_time_t get_absolute_time(void) { return devsim_time_us(); }
+static inline uint64_t time_us_64(void) { return devsim_time_us(); }
+static inline uint32_t time_us_32(void) { return (uint32_t)devsim_time_us(); }
+static inline absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us) { return t + us; }
+static inline absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms) { return t + (uint64_t)ms * 1000; }
+static inline absolute_time_t make_timeout_time_ms(uint32_t ms) { return devsim_time_us() + (uint64_t)ms * 1000; }
+static inline int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) { return (int64_t)(to - from); }
+static inline bool time_reached(absolute_time_t t) { return devsim_time_us() >= t; }
+static inline void sleep_until(absolute_time_t t) { devsim_sleep_until_us(t); }
+static inline void sleep_us(uint64_t us) { devsim_sleep_until_us(devsim_time_us() + us); }
+static inline void sleep_ms(uint32_t ms) { sleep_us((uint64_t)ms * 1000); }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DEVSIM_PICO_STDLIB_H
@@ -0,0 +1,265 @@
+#include "sim_bus.h"
+
+#include <cstring>
+
+namespace wx
+{
+
+namespace
+{
+
+uint64_t virtual_now_us;
+
+} // namespace
+
+uint64_t sim_now_us()
+{
+    return virtual_now_us;
+}
+
+void sim_sleep_until_us(uint64_t us)
+{
+    if (us > virtual_now_us)
+        virtual_now_us = us;
+}
+
+i2c_bus_result_t sim_bus::execute(uint8_t addr, const uint8_t *write_data, size_t write_len, uint8_t *read_data,
+                                  size_t read_len, uint32_t baudrate)
+{
+    uint64_t start_us = virtual_now_us;
+    auto bytes_us = [baudrate](size_t bytes) { return (uint64_t)bytes * 9 * 1000000 / baudrate; };
+
+    // Endereço, bytes escritos e, se houver leitura, o endereço de novo depois do repeated start
+    uint64_t write_us = bytes_us(1 + write_len);
+    uint64_t duration_us = write_us + (read_len ? bytes_us(1 + read_len) : 0);
+    uint64_t timeout_us = bytes_us((write_len + read_len + 2) * 2) + I2C_BUS_TIMEOUT_MARGIN_US;
+
+    sim_device *device = devices_[addr & 0x7F];
+    if (device)
+    {
+        device->counters.transfers++;
+        if (device->faults.power_cycle_s >= 0 && start_us >= (uint64_t)(device->faults.power_cycle_s * 1e6))
+        {
+            device->power_on((uint64_t)(device->faults.power_cycle_s * 1e6));
+            device->faults.power_cycle_s = -1;
+        }
+        duration_us += device->faults.stretch_us;
+    }
+
+    // Clock stretching além do prazo: o controlador aborta e o escravo não vê o resto
+    if (duration_us > timeout_us)
+    {
+        virtual_now_us = start_us + timeout_us;
+        return I2C_BUS_ERR_TIMEOUT;
+    }
+
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    if (!device || !device->acknowledge(start_us) ||
+        (device->faults.nak_rate > 0 && uniform(rng_) < device->faults.nak_rate))
+    {
+        if (device)
+            device->counters.naks++;
+        virtual_now_us = start_us + bytes_us(1);
+        return I2C_BUS_ERR_NAK;
+    }
+
+    if (write_len)
+        device->write(write_data, write_len, start_us);
+    if (read_len)
+    {
+        device->read(read_data, read_len, start_us + write_us);
+        if (device->faults.corrupt_rate > 0 && uniform(rng_) < device->faults.corrupt_rate)
+        {
+            size_t index = std::uniform_int_distribution<size_t>(0, read_len - 1)(rng_);
+            read_data[index] ^= (uint8_t)(1u << std::uniform_int_distribution<int>(0, 7)(rng_));
+            device->counters.corrupted++;
+        }
+    }
+
+    virtual_now_us = start_us + duration_us;
+    return I2C_BUS_OK;
+}
+
+} // namespace wx
+
+// lib/i2c_bus no host: as transações são executadas na hora pelo sim_bus (o callback é chamado
+// antes de i2c_bus_submit retornar, como uma transferência que termina imediatamente). Contadores,
+// reidentificação após NAKs seguidos e recuperação após prazo expirado seguem o firmware.
+
+extern "C" {
+
+uint64_t devsim_time_us(void)
+{
+    return wx::sim_now_us();
+}
+
+void devsim_sleep_until_us(uint64_t us)
+{
+    wx::sim_sleep_until_us(us);
+}
+
+void i2c_bus_init(i2c_bus_t *bus, i2c_inst_t *i2c, uint sda_pin, uint scl_pin, uint baudrate)
+{
+    memset(bus, 0, sizeof(*bus));
+    bus->i2c = i2c;
+    bus->sda_pin = sda_pin;
+    bus->scl_pin = scl_pin;
+    bus->baudrate = baudrate;
+    bus->tx_dma = -1;
+    bus->rx_dma = -1;
+    bus->result = I2C_BUS_OK;
+}
+
+void i2c_device_init(i2c_device_t *device, i2c_bus_t *bus, uint8_t addr)
+{
+    device->bus = bus;
+    device->addr = addr;
+}
+
+i2c_bus_result_t i2c_bus_submit(const i2c_device_t *device,
+                                const uint8_t *write_data, size_t write_len,
+                                uint8_t *read_data, size_t read_len,
+                                i2c_bus_callback_t callback, void *user_data)
+{
+    i2c_bus_t *bus = device->bus;
+
+    if (write_len + read_len == 0 || write_len + read_len > I2C_BUS_MAX_TRANSFER)
+        return I2C_BUS_ERR_ABORT;
+
+    uint64_t start_us = wx::sim_now_us();
+    i2c_bus_result_t result = wx::sim_bus::from(bus->i2c)->execute(device->addr, write_data, write_len, read_data,
+                                                                  read_len, bus->baudrate);
+
+    uint32_t latency = (uint32_t)(wx::sim_now_us() - start_us);
+    bus->stats.transfers++;
+    bus->stats.last_latency_us = latency;
+    if (latency > bus->stats.max_latency_us)
+        bus->stats.max_latency_us = latency;
+
+    switch (result)
+    {
+    case I2C_BUS_OK:
+        bus->consecutive_naks = 0;
+        break;
+    case I2C_BUS_ERR_NAK:
+        bus->stats.naks++;
+        if (++bus->consecutive_naks >= I2C_BUS_NAK_REPROBE_THRESHOLD)
+        {
+            bus->consecutive_naks = 0;
+            bus->reprobe_pending = true;
+        }
+        break;
+    default:
+        if (result == I2C_BUS_ERR_TIMEOUT)
+            bus->stats.timeouts++;
+        else
+            bus->stats.aborts++;
+        bus->stats.recoveries++;
+        bus->stats.last_recovery_ms = (uint32_t)(wx::sim_now_us() / 1000);
+        bus->reprobe_pending = true;
+        break;
+    }
+
+    if (callback)
+        callback(result, user_data);
+    return I2C_BUS_OK;
+}
+
+static void blocking_callback(i2c_bus_result_t result, void *user_data)
+{
+    *(i2c_bus_result_t *)user_data = result;
+}
+
+i2c_bus_result_t i2c_bus_write_read(const i2c_device_t *device,
+                                    const uint8_t *write_data, size_t write_len,
+                                    uint8_t *read_data, size_t read_len)
+{
+    i2c_bus_result_t done = I2C_BUS_OK;
+    i2c_bus_result_t result = i2c_bus_submit(device, write_data, write_len, read_data, read_len,
+                                             blocking_callback, &done);
+    return result != I2C_BUS_OK ? result : done;
+}
+
+i2c_bus_result_t i2c_bus_write(const i2c_device_t *device, const uint8_t *data, size_t len)
+{
+    return i2c_bus_write_read(device, data, len, NULL, 0);
+}
+
+i2c_bus_result_t i2c_bus_read(const i2c_device_t *device, uint8_t *data, size_t len)
+{
+    return i2c_bus_write_read(device, NULL, 0, data, len);
+}
+
+i2c_bus_result_t i2c_bus_write_reg(const i2c_device_t *device, uint8_t reg, uint8_t value)
+{
+    uint8_t buf[2] = {reg, value};
+    return i2c_bus_write(device, buf, 2);
+}
+
+i2c_bus_result_t i2c_bus_read_regs(const i2c_device_t *device, uint8_t reg, uint8_t *data, size_t len)
+{
+    return i2c_bus_write_read(device, &reg, 1, data, len);
+}
+
+bool i2c_bus_probe(const i2c_device_t *device)
+{
+    uint8_t dummy;
+    return i2c_bus_read(device, &dummy, 1) == I2C_BUS_OK;
+}
+
+bool i2c_bus_idle(const i2c_bus_t *bus)
+{
+    (void)bus;
+    return true;
+}
+
+bool i2c_bus_add_reprobe_hook(i2c_bus_t *bus, i2c_bus_reprobe_t hook, void *context)
+{
+    for (uint8_t i = 0; i < bus->hook_count; i++)
+    {
+        if (bus->hooks[i] == hook && bus->hook_contexts[i] == context)
+            return true;
+    }
+    if (bus->hook_count >= I2C_BUS_MAX_HOOKS)
+        return false;
+    bus->hooks[bus->hook_count] = hook;
+    bus->hook_contexts[bus->hook_count] = context;
+    bus->hook_count++;
+    return true;
+}
+
+void i2c_bus_service(i2c_bus_t *bus)
+{
+    if (!bus->reprobe_pending)
+        return;
+    bus->reprobe_pending = false;
+    bus->stats.reprobes++;
+
+    for (uint8_t i = 0; i < bus->hook_count; i++)
+        bus->hooks[i](bus->hook_contexts[i]);
+}
+
+void i2c_bus_get_stats(const i2c_bus_t *bus, i2c_bus_stats_t *stats)
+{
+    *stats = bus->stats;
+}
+
+const char *i2c_bus_result_str(i2c_bus_result_t result)
+{
+    switch (result)
+    {
+    case I2C_BUS_OK:
+        return "ok";
+    case I2C_BUS_ERR_NAK:
+        return "nak";
+    case I2C_BUS_ERR_ABORT:
+        return "abort";
+    case I2C_BUS_ERR_QUEUE_FULL:
+        return "queue-full";
+    case I2C_BUS_ERR_TIMEOUT:
+        return "timeout";
+    }
+    return "?";
+}
+
+} // extern "C"
@@ -0,0 +1,95 @@
+#ifndef WX_SIM_BUS_H
+#define WX_SIM_BUS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+extern "C" {
+#include "i2c_bus/i2c_bus.h"
+}
+
+namespace wx
+{
+
+// Relógio virtual compartilhado pelos drivers (via pico/stdlib.h) e pelos dispositivos emulados
+uint64_t sim_now_us();
+void sim_sleep_until_us(uint64_t us);
+
+// Falhas injetadas em um dispositivo. As de barramento (NAK, bit trocado, clock stretching) são
+// aplicadas pelo sim_bus; as demais, pelo próprio modelo do dispositivo.
+struct sim_faults
+{
+    double nak_rate = 0;          // Probabilidade de NAK no endereço, por transação
+    double corrupt_rate = 0;      // Probabilidade de um bit trocado nos bytes lidos, por transação
+    bool stuck_busy = false;      // Bit de ocupado (AHT20) ou "measuring" (BMP280) preso em 1
+    uint32_t stretch_us = 0;      // Clock stretching somado a cada transação
+    uint32_t slow_us = 0;         // Tempo somado a cada medição
+    double power_cycle_s = -1;    // Instante de uma queda de alimentação (o dispositivo volta do zero)
+};
+
+// Contadores de um dispositivo emulado
+struct sim_counters
+{
+    uint64_t transfers = 0;
+    uint64_t naks = 0;            // NAKs respondidos (injetados ou do próprio modelo)
+    uint64_t corrupted = 0;       // Transações com um bit trocado
+    uint64_t measurements = 0;    // Medições concluídas
+};
+
+// Dispositivo I2C emulado. Cada transação é uma escrita opcional seguida de uma leitura opcional
+// (repeated start), como no lib/i2c_bus.
+class sim_device
+{
+public:
+    virtual ~sim_device() = default;
+
+    // Reconhece o endereço no instante now_us (false: NAK)
+    virtual bool acknowledge(uint64_t now_us) { (void)now_us; return true; }
+    virtual void write(const uint8_t *data, size_t len, uint64_t now_us) = 0;
+    virtual void read(uint8_t *data, size_t len, uint64_t now_us) = 0;
+
+    // Volta ao estado de logo após ser alimentado, em now_us
+    virtual void power_on(uint64_t now_us) = 0;
+
+    sim_faults faults;
+    sim_counters counters;
+
+protected:
+    explicit sim_device(uint64_t seed) : rng_(seed) {}
+
+    double uniform() { return std::uniform_real_distribution<double>(0.0, 1.0)(rng_); }
+    double gaussian(double sigma) { return sigma > 0 ? std::normal_distribution<double>(0.0, sigma)(rng_) : 0.0; }
+
+    std::mt19937_64 rng_;
+};
+
+// Barramento emulado: encaminha as transações de lib/i2c_bus aos dispositivos pelo endereço e
+// avança o relógio virtual pelo tempo de cada transferência.
+class sim_bus
+{
+public:
+    explicit sim_bus(uint64_t seed = 1) : rng_(seed) {}
+    sim_bus(const sim_bus &) = delete;
+    sim_bus &operator=(const sim_bus &) = delete;
+
+    void attach(uint8_t addr, sim_device *device) { devices_[addr & 0x7F] = device; }
+
+    // Instância a passar para i2c_bus_init
+    i2c_inst_t *inst() { return reinterpret_cast<i2c_inst_t *>(this); }
+    static sim_bus *from(i2c_inst_t *i2c) { return reinterpret_cast<sim_bus *>(i2c); }
+
+    // Executa uma transação a baudrate, com o prazo de lib/i2c_bus (duas vezes o tempo de
+    // transmissão mais I2C_BUS_TIMEOUT_MARGIN_US)
+    i2c_bus_result_t execute(uint8_t addr, const uint8_t *write_data, size_t write_len, uint8_t *read_data,
+                             size_t read_len, uint32_t baudrate);
+
+private:
+    std::array<sim_device *, 128> devices_{};
+    std::mt19937_64 rng_;
+};
+
+} // namespace wx
+
+#endif // WX_SIM_BUS_H
@@ -0,0 +1,488 @@
+// Gerador de carga HTTP para o servidor da estação (placa real ou firmware compilado para o host).
+//
+//   loadgen --target HOST[:PORTA] [--concurrency N] [--duration S] [--requests N] [--warmup S]
+//           [--mode close|keepalive] [--mix index:1,weather:8,limits:1] [--rate R]
+//           [--timeout MS] [--limits-body JSON]
+//
+// Cada conexão simultânea é um "cliente" em laço fechado: envia uma requisição sorteada do mix,
+// espera a resposta e envia a próxima. Com --rate, as requisições seguem uma agenda fixa e a
+// latência é medida a partir do instante agendado (sem omissão coordenada: um servidor lento não
+// reduz a carga medida). Em keepalive, a conexão é reaproveitada enquanto o servidor permitir; o
+// firmware fecha após cada resposta, então uma conexão reaproveitada que falha antes do primeiro
+// byte é refeita uma vez e contada como reconexão, não como erro.
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "event_loop.h"
+#include "http.h"
+#include "net.h"
+
+namespace
+{
+
+enum route_id
+{
+    ROUTE_INDEX,
+    ROUTE_WEATHER,
+    ROUTE_LIMITS,
+    ROUTE_COUNT,
+};
+
+const char *const route_names[ROUTE_COUNT] = {"index", "weather", "limits"};
+
+struct options
+{
+    sockaddr_in target{};
+    std::string host;
+    size_t concurrency = 4;
+    double duration_s = 10;
+    uint64_t max_requests = 0; // Após o aquecimento; 0: limitado só por duration_s
+    double warmup_s = 0;
+    bool keep_alive = false;
+    double rate = 0; // Requisições/s no total; 0: laço fechado
+    uint64_t timeout_ms = 5000;
+    unsigned weights[ROUTE_COUNT] = {1, 8, 0};
+    // Mesmos limites da configuração padrão: a gravação na flash só ocorre se os valores mudarem
+    std::string limits_body = "{\"min\":10,\"max\":35,\"offset\":0.0}";
+};
+
+struct route_stats
+{
+    uint64_t ok = 0;
+    uint64_t bytes = 0;
+    std::vector<uint32_t> latency_us;
+};
+
+struct client
+{
+    int fd = -1;
+    bool connecting = false;
+    bool reused = false;    // A requisição atual segue em uma conexão já usada
+    bool retried = false;   // Já refeita uma vez por fechamento da conexão reaproveitada
+    route_id route = ROUTE_WEATHER;
+    std::string out;
+    size_t written = 0;
+    std::string in;
+    uint64_t start_us = 0;  // Instante agendado (ou de envio, em laço fechado)
+    bool measured = false;  // Iniciada após o aquecimento
+    wx::event_loop::timer_id timeout = 0;
+};
+
+options opts;
+wx::event_loop *loop;
+std::vector<std::unique_ptr<client>> clients;
+std::mt19937 rng(1);
+std::discrete_distribution<int> pick_route;
+std::string requests_text[ROUTE_COUNT];
+
+uint64_t run_start_us, measure_start_us, run_end_us;
+uint64_t next_slot_us;       // Próximo instante da agenda em --rate
+uint64_t issued = 0;         // Requisições medidas iniciadas (para --requests)
+size_t active = 0;           // Clientes com requisição em andamento ou agendada
+volatile sig_atomic_t stopping = 0;
+
+route_stats routes[ROUTE_COUNT];
+std::map<std::string, uint64_t> errors;
+uint64_t connections = 0, reconnects = 0;
+uint64_t period_done = 0, period_errors = 0;
+
+void start_request(client *c);
+
+void close_fd(client *c)
+{
+    if (c->fd >= 0)
+    {
+        loop->remove(c->fd);
+        close(c->fd);
+        c->fd = -1;
+    }
+    c->connecting = false;
+}
+
+std::string errno_name(int err)
+{
+    switch (err)
+    {
+    case ECONNREFUSED:
+        return "ECONNREFUSED";
+    case ECONNRESET:
+        return "ECONNRESET";
+    case EHOSTUNREACH:
+        return "EHOSTUNREACH";
+    case ENETUNREACH:
+        return "ENETUNREACH";
+    case ETIMEDOUT:
+        return "ETIMEDOUT";
+    case EPIPE:
+        return "EPIPE";
+    case EMFILE:
+        return "EMFILE";
+    case EADDRNOTAVAIL:
+        return "EADDRNOTAVAIL";
+    default:
+        return strerror(err);
+    }
+}
+
+// Próxima requisição do cliente, ou encerra se o tempo ou o total acabaram
+void next_request(client *c)
+{
+    uint64_t now = wx::event_loop::now_us();
+    if (stopping || now >= run_end_us || (opts.max_requests && issued >= opts.max_requests))
+    {
+        close_fd(c);
+        if (--active == 0)
+            loop->stop();
+        return;
+    }
+    if (now >= measure_start_us)
+        issued++;
+    c->route = (route_id)pick_route(rng);
+
+    if (opts.rate > 0)
+    {
+        uint64_t slot = next_slot_us;
+        next_slot_us += (uint64_t)(1e6 / opts.rate);
+        c->start_us = slot;
+        if (slot > now + 1000)
+        {
+            loop->add_timer((slot - now) / 1000, [c] { start_request(c); });
+            return;
+        }
+    }
+    else
+    {
+        c->start_us = now;
+    }
+    start_request(c);
+}
+
+void finish(client *c, const std::string &error, size_t bytes)
+{
+    loop->cancel_timer(c->timeout);
+    c->timeout = 0;
+    if (c->measured)
+    {
+        if (error.empty())
+        {
+            route_stats &rs = routes[c->route];
+            rs.ok++;
+            rs.bytes += bytes;
+            rs.latency_us.push_back((uint32_t)std::min<uint64_t>(wx::event_loop::now_us() - c->start_us, UINT32_MAX));
+        }
+        else
+        {
+            errors[error]++;
+            period_errors++;
+        }
+    }
+    period_done++;
+    next_request(c);
+}
+
+void fail(client *c, const std::string &error)
+{
+    // Conexão reaproveitada fechada pelo servidor antes de qualquer byte da resposta: refaz
+    if (c->reused && !c->retried && c->in.empty())
+    {
+        close_fd(c);
+        reconnects++;
+        c->retried = true;
+        start_request(c);
+        return;
+    }
+    close_fd(c);
+    finish(c, error, 0);
+}
+
+void on_event(client *c, uint32_t events)
+{
+    if (c->connecting)
+    {
+        int err = wx::connect_result(c->fd);
+        if (err)
+        {
+            fail(c, "connect: " + errno_name(err));
+            return;
+        }
+        c->connecting = false;
+    }
+
+    if (c->written < c->out.size())
+    {
+        if (!wx::write_available(c->fd, c->out, c->written))
+        {
+            fail(c, "write: " + errno_name(errno));
+            return;
+        }
+        if (c->written < c->out.size())
+        {
+            loop->modify(c->fd, EPOLLOUT);
+            return;
+        }
+        loop->modify(c->fd, EPOLLIN | EPOLLRDHUP);
+        if (!(events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)))
+            return;
+    }
+
+    bool closed;
+    if (!wx::read_available(c->fd, c->in, closed) && !closed)
+    {
+        fail(c, "read: " + errno_name(errno));
+        return;
+    }
+
+    wx::http_response response;
+    size_t consumed;
+    wx::parse_status status = wx::parse_response(c->in, closed, response, consumed);
+    if (status == wx::parse_status::incomplete)
+    {
+        if (closed)
+            fail(c, c->in.empty() ? "closed before response" : "closed mid-response");
+        return;
+    }
+    if (status == wx::parse_status::error)
+    {
+        fail(c, "malformed response");
+        return;
+    }
+
+    bool reusable = opts.keep_alive && response.keep_alive && !closed && consumed == c->in.size();
+    if (!reusable)
+        close_fd(c);
+    c->in.clear();
+    if (response.status < 200 || response.status > 299)
+        finish(c, "http " + std::to_string(response.status), 0);
+    else
+        finish(c, "", consumed);
+}
+
+void start_request(client *c)
+{
+    // O temporizador tem resolução de 1 ms e pode disparar um pouco antes do instante agendado
+    uint64_t now = wx::event_loop::now_us();
+    if (c->start_us > now)
+        c->start_us = now;
+    c->out = requests_text[c->route];
+    c->written = 0;
+    c->in.clear();
+    c->measured = c->start_us >= measure_start_us;
+    if (!c->timeout)
+    {
+        c->retried = false;
+        uint64_t elapsed_ms = (now - c->start_us) / 1000;
+        uint64_t delay = opts.timeout_ms > elapsed_ms ? opts.timeout_ms - elapsed_ms : 0;
+        c->timeout = loop->add_timer(delay, [c] {
+            c->timeout = 0;
+            close_fd(c);
+            finish(c, "timeout", 0);
+        });
+    }
+
+    c->reused = c->fd >= 0;
+    if (!c->reused)
+    {
+        c->fd = wx::connect_tcp(opts.target);
+        if (c->fd < 0)
+        {
+            // Adiado para não encadear recursivamente falhas imediatas
+            std::string error = "connect: " + errno_name(errno);
+            loop->add_timer(1, [c, error] { finish(c, error, 0); });
+            return;
+        }
+        connections++;
+        c->connecting = true;
+        loop->add(c->fd, EPOLLOUT, [c](uint32_t events) { on_event(c, events); });
+        return;
+    }
+    on_event(c, EPOLLOUT);
+}
+
+uint32_t percentile(const std::vector<uint32_t> &sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+    size_t i = (size_t)(p * (double)(sorted.size() - 1) + 0.5);
+    return sorted[std::min(i, sorted.size() - 1)];
+}
+
+void print_row(const char *name, std::vector<uint32_t> &latency, uint64_t ok, uint64_t bytes, double seconds)
+{
+    std::sort(latency.begin(), latency.end());
+    printf("%-8s %9llu %9.1f %10.1f %9.2f %9.2f %9.2f %9.2f\n", name, (unsigned long long)ok, ok / seconds,
+           bytes / seconds / 1024.0, percentile(latency, 0.50) / 1000.0, percentile(latency, 0.99) / 1000.0,
+           percentile(latency, 0.999) / 1000.0, latency.empty() ? 0.0 : latency.back() / 1000.0);
+}
+
+void report()
+{
+    double seconds = (std::min(wx::event_loop::now_us(), run_end_us) - measure_start_us) / 1e6;
+    if (seconds <= 0)
+        seconds = 1e-6;
+
+    printf("\nalvo %s, %zu clientes, %s, ", wx::to_string(opts.target).c_str(), opts.concurrency,
+           opts.keep_alive ? "keep-alive" : "uma conexão por requisição");
+    if (opts.rate > 0)
+        printf("%.1f req/s agendadas", opts.rate);
+    else
+        printf("laço fechado");
+    printf(", %.1f s medidos\n\n", seconds);
+
+    printf("%-8s %9s %9s %10s %9s %9s %9s %9s\n", "rota", "ok", "req/s", "KiB/s", "p50 ms", "p99 ms", "p999 ms",
+           "máx ms");
+    std::vector<uint32_t> all;
+    uint64_t ok = 0, bytes = 0;
+    for (int r = 0; r < ROUTE_COUNT; r++)
+    {
+        if (!opts.weights[r])
+            continue;
+        all.insert(all.end(), routes[r].latency_us.begin(), routes[r].latency_us.end());
+        ok += routes[r].ok;
+        bytes += routes[r].bytes;
+        print_row(route_names[r], routes[r].latency_us, routes[r].ok, routes[r].bytes, seconds);
+    }
+    print_row("total", all, ok, bytes, seconds);
+
+    uint64_t failed = 0;
+    for (const auto &e : errors)
+        failed += e.second;
+    printf("\nconexões abertas %llu, reconexões %llu, erros %llu (%.2f%%)\n", (unsigned long long)connections,
+           (unsigned long long)reconnects, (unsigned long long)failed,
+           ok + failed ? 100.0 * failed / (ok + failed) : 0.0);
+    for (const auto &e : errors)
+        printf("  %-32s %llu\n", e.first.c_str(), (unsigned long long)e.second);
+}
+
+bool parse_mix(const std::string &mix)
+{
+    unsigned weights[ROUTE_COUNT] = {0, 0, 0};
+    size_t pos = 0;
+    while (pos < mix.size())
+    {
+        size_t comma = mix.find(',', pos);
+        std::string item = mix.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+        pos = comma == std::string::npos ? mix.size() : comma + 1;
+
+        size_t colon = item.find(':');
+        std::string name = item.substr(0, colon);
+        unsigned weight = colon == std::string::npos ? 1 : (unsigned)strtoul(item.c_str() + colon + 1, nullptr, 10);
+        int r = 0;
+        while (r < ROUTE_COUNT && name != route_names[r])
+            r++;
+        if (r == ROUTE_COUNT)
+            return false;
+        weights[r] = weight;
+    }
+    if (!weights[ROUTE_INDEX] && !weights[ROUTE_WEATHER] && !weights[ROUTE_LIMITS])
+        return false;
+    std::copy(weights, weights + ROUTE_COUNT, opts.weights);
+    return true;
+}
+
+void usage()
+{
+    fprintf(stderr, "uso: loadgen --target HOST[:PORTA] [--concurrency N] [--duration S] [--requests N]\n"
+                    "               [--warmup S] [--mode close|keepalive] [--mix index:1,weather:8,limits:1]\n"
+                    "               [--rate R] [--timeout MS] [--limits-body JSON]\n");
+    exit(2);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::string target;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+            usage();
+        const char *value = argv[++i];
+        if (arg == "--target")
+            target = value;
+        else if (arg == "--concurrency")
+            opts.concurrency = strtoul(value, nullptr, 10);
+        else if (arg == "--duration")
+            opts.duration_s = strtod(value, nullptr);
+        else if (arg == "--requests")
+            opts.max_requests = strtoull(value, nullptr, 10);
+        else if (arg == "--warmup")
+            opts.warmup_s = strtod(value, nullptr);
+        else if (arg == "--mode" && (!strcmp(value, "close") || !strcmp(value, "keepalive")))
+            opts.keep_alive = !strcmp(value, "keepalive");
+        else if (arg == "--mix")
+        {
+            if (!parse_mix(value))
+                usage();
+        }
+        else if (arg == "--rate")
+            opts.rate = strtod(value, nullptr);
+        else if (arg == "--timeout")
+            opts.timeout_ms = strtoull(value, nullptr, 10);
+        else if (arg == "--limits-body")
+            opts.limits_body = value;
+        else
+            usage();
+    }
+    if (target.empty() || !wx::resolve(target, 80, opts.target) || opts.concurrency == 0 || opts.duration_s <= 0 ||
+        opts.warmup_s < 0 || opts.rate < 0)
+        usage();
+    opts.host = target;
+
+    const char *connection = opts.keep_alive ? "keep-alive" : "close";
+    requests_text[ROUTE_INDEX] = "GET / HTTP/1.1\r\nHost: " + opts.host + "\r\nConnection: " + connection + "\r\n\r\n";
+    requests_text[ROUTE_WEATHER] =
+        "GET /api/weather HTTP/1.1\r\nHost: " + opts.host + "\r\nConnection: " + connection + "\r\n\r\n";
+    requests_text[ROUTE_LIMITS] = "POST /api/limits HTTP/1.1\r\nHost: " + opts.host +
+                                  "\r\nContent-Type: application/json\r\nContent-Length: " +
+                                  std::to_string(opts.limits_body.size()) + "\r\nConnection: " + connection +
+                                  "\r\n\r\n" + opts.limits_body;
+    pick_route = std::discrete_distribution<int>(opts.weights, opts.weights + ROUTE_COUNT);
+
+    signal(SIGPIPE, SIG_IGN);
+    wx::raise_fd_limit();
+    wx::event_loop event_loop;
+    loop = &event_loop;
+
+    run_start_us = wx::event_loop::now_us();
+    measure_start_us = run_start_us + (uint64_t)(opts.warmup_s * 1e6);
+    run_end_us = measure_start_us + (uint64_t)(opts.duration_s * 1e6);
+    next_slot_us = run_start_us;
+
+    std::function<void()> progress = [&] {
+        fprintf(stderr, "%6.1f s: %llu respostas/s, %llu erros\n", (wx::event_loop::now_us() - run_start_us) / 1e6,
+                (unsigned long long)period_done, (unsigned long long)period_errors);
+        period_done = period_errors = 0;
+        event_loop.add_timer(1000, progress);
+    };
+    event_loop.add_timer(1000, progress);
+
+    // Ctrl+C encerra a medição: os clientes terminam a requisição em andamento
+    signal(SIGINT, [](int) { stopping = 1; });
+
+    for (size_t i = 0; i < opts.concurrency; i++)
+    {
+        clients.push_back(std::make_unique<client>());
+        active++;
+    }
+    for (auto &c : clients)
+        next_request(c.get());
+
+    if (active)
+        event_loop.run();
+    report();
+    return 0;
+}
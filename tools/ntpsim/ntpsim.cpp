@@ -0,0 +1,167 @@
+// Servidor SNTP de teste para o relógio de parede da estação (POST /api/time aponta a estação para ele).
+//
+//   ntpsim [--listen ADDR[:PORTA]] [--offset-ms MS] [--drift-ppm PPM] [--delay-ms MS]
+//          [--step-at S --step-ms MS]
+//
+// A hora servida parte do relógio do host e pode ser distorcida para exercitar a disciplina:
+// --offset-ms soma um erro fixo, --drift-ppm faz a hora servida andar mais rápido (ou mais devagar,
+// se negativo), o que a estação vê como erro de frequência do próprio cristal, --delay-ms atrasa a
+// resposta depois de carimbada (caminho assimétrico: a estação erra a metade do atraso) e --step-ms
+// salta a hora depois de --step-at segundos. Cada consulta é registrada com a hora servida.
+// A porta padrão é a 123, a do SNTP do lwIP (exige root ou CAP_NET_BIND_SERVICE).
+
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "event_loop.h"
+#include "net.h"
+
+namespace
+{
+
+constexpr uint64_t NTP_UNIX_OFFSET_S = 2208988800ull; // 1900 a 1970
+constexpr size_t NTP_PACKET_SIZE = 48;
+
+struct options
+{
+    sockaddr_in listen{};
+    double offset_ms = 0;
+    double drift_ppm = 0;
+    double delay_ms = 0;
+    double step_at_s = 0;
+    double step_ms = 0;
+};
+
+options opts;
+int64_t start_unix_us;
+uint64_t start_mono_us;
+
+int64_t real_unix_us()
+{
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Hora servida, em µs Unix
+int64_t served_unix_us()
+{
+    double elapsed = (double)(wx::event_loop::now_us() - start_mono_us);
+    double served = elapsed * (1.0 + opts.drift_ppm * 1e-6) + opts.offset_ms * 1000.0;
+    if (opts.step_ms != 0 && elapsed >= opts.step_at_s * 1e6)
+        served += opts.step_ms * 1000.0;
+    return start_unix_us + (int64_t)served;
+}
+
+void put_u32(uint8_t *out, uint32_t value)
+{
+    out[0] = value >> 24;
+    out[1] = value >> 16;
+    out[2] = value >> 8;
+    out[3] = value;
+}
+
+// Carimbo NTP (segundos desde 1900 e fração de 2^-32 s)
+void put_timestamp(uint8_t *out, int64_t unix_us)
+{
+    uint64_t us = (uint64_t)(unix_us % 1000000);
+    put_u32(out, (uint32_t)(unix_us / 1000000 + NTP_UNIX_OFFSET_S));
+    put_u32(out + 4, (uint32_t)((us << 32) / 1000000));
+}
+
+void usage()
+{
+    fprintf(stderr, "uso: ntpsim [--listen ADDR[:PORTA]] [--offset-ms MS] [--drift-ppm PPM] [--delay-ms MS]\n"
+                    "              [--step-at S --step-ms MS]\n");
+    exit(2);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::string listen = "0.0.0.0";
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+            usage();
+        const char *value = argv[++i];
+        if (arg == "--listen")
+            listen = value;
+        else if (arg == "--offset-ms")
+            opts.offset_ms = strtod(value, nullptr);
+        else if (arg == "--drift-ppm")
+            opts.drift_ppm = strtod(value, nullptr);
+        else if (arg == "--delay-ms")
+            opts.delay_ms = strtod(value, nullptr);
+        else if (arg == "--step-at")
+            opts.step_at_s = strtod(value, nullptr);
+        else if (arg == "--step-ms")
+            opts.step_ms = strtod(value, nullptr);
+        else
+            usage();
+    }
+    if (!wx::resolve(listen, 123, opts.listen) || opts.delay_ms < 0 || opts.step_at_s < 0)
+        usage();
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0 || bind(fd, (const sockaddr *)&opts.listen, sizeof(opts.listen)) < 0)
+    {
+        fprintf(stderr, "ntpsim: %s: %s\n", wx::to_string(opts.listen).c_str(), strerror(errno));
+        return 1;
+    }
+    start_unix_us = real_unix_us();
+    start_mono_us = wx::event_loop::now_us();
+    printf("ntpsim em %s: offset %.1f ms, deriva %.1f ppm, atraso %.1f ms\n", wx::to_string(opts.listen).c_str(),
+           opts.offset_ms, opts.drift_ppm, opts.delay_ms);
+
+    uint8_t packet[NTP_PACKET_SIZE];
+    for (;;)
+    {
+        sockaddr_in peer{};
+        socklen_t peer_len = sizeof(peer);
+        ssize_t len = recvfrom(fd, packet, sizeof(packet), 0, (sockaddr *)&peer, &peer_len);
+        int64_t received_us = served_unix_us();
+        if (len < (ssize_t)NTP_PACKET_SIZE)
+            continue;
+        uint8_t version = (packet[0] >> 3) & 7;
+        if ((packet[0] & 7) != 3) // Só consultas de cliente
+            continue;
+
+        // Resposta: servidor de estrato 1, com o carimbo de envio do cliente como origem
+        uint8_t reply[NTP_PACKET_SIZE] = {};
+        reply[0] = (uint8_t)(version << 3 | 4);
+        reply[1] = 1;
+        reply[2] = packet[2];
+        reply[3] = (uint8_t)-20; // Precisão de ~1 µs
+        memcpy(&reply[12], "SIM", 4);
+        memcpy(&reply[24], &packet[40], 8);
+        put_timestamp(&reply[16], received_us);
+        put_timestamp(&reply[32], received_us);
+        int64_t transmit_us = served_unix_us();
+        int64_t real_us = real_unix_us();
+        put_timestamp(&reply[40], transmit_us);
+
+        // Atraso depois do carimbo: só a volta fica mais lenta
+        if (opts.delay_ms > 0)
+            usleep((useconds_t)(opts.delay_ms * 1000));
+        sendto(fd, reply, sizeof(reply), 0, (const sockaddr *)&peer, peer_len);
+
+        time_t seconds = (time_t)(transmit_us / 1000000);
+        tm utc;
+        gmtime_r(&seconds, &utc);
+        printf("%s: %04d-%02d-%02d %02d:%02d:%02d.%06lld UTC (real %+.3f ms)\n", wx::to_string(peer).c_str(),
+               utc.tm_year + 1900, utc.tm_mon + 1, utc.tm_mday, utc.tm_hour, utc.tm_min, utc.tm_sec,
+               (long long)(transmit_us % 1000000), (transmit_us - real_us) / 1000.0);
+        fflush(stdout);
+    }
+}